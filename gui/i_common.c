@@ -75,6 +75,18 @@ void NextStep()
   else GoToNextStage();
 }
 
+/* Go back to the triangulation before the last step (the updates
+   are recorded, then NextStep() goes forward again through them) */
+
+void PrevStep()
+{
+  if (algo->StepBack())
+  {
+    step_count--;
+    Change();
+  }
+}
+
 void AllSteps()
 {
   while( !algo->NoMoreUpdates() )
@@ -74,6 +74,7 @@ extern void Change(void);
 
 extern int CheckFileExtension(char * name, char * ext);
 extern void NextStep();
+extern void PrevStep();
 extern void AllSteps();
 extern void EndOfProgram(void);
 extern void GoToNextStage(void);
@@ -296,7 +296,7 @@ void LoadScene(char * filename)
        tt = new TRefErrDelaunay( &mtt );
    }
    if (tt == NULL) cout << "Error1 out of memory\n";
-     algo = new StepByStep(tt);
+     algo = new StepByStep(tt, &mtt);
    if (algo == NULL) cout << "Error2 out of memory\n";
 
    algo->ReadData(filename);
@@ -399,6 +399,7 @@ void StageOptionsRUN(int v)
   {
     case 1: /* next step */ NextStep(); break;
     case 2: /* all steps */ AllSteps(); break;
+    case 4: /* previous step */ PrevStep(); break;
     case 3: /* write */
       /* version from command line:
       printf("Name of file to be written:");
@@ -453,6 +454,7 @@ int MakeMenuForStage(int i)
     case STAGE_RUN:
       m = glutCreateMenu(StageOptionsRUN);
       glutAddMenuEntry("next step",1);
+      glutAddMenuEntry("previous step",4);
       glutAddMenuEntry("all steps",2);
       glutAddMenuEntry("write triangulation to file",3);
       glutAddMenuEntry("go to next stage",88);
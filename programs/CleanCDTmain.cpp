@@ -0,0 +1,161 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+/* ------------------------------------------------------------------------ */
+/*        VALIDATION AND REPAIR OF THE CONSTRAINTS OF A .seg / .cdt FILE     */
+/* ------------------------------------------------------------------------ */
+
+// A .seg file (points and segments) is cleaned by SegClean::Clean(),
+// so that its segments can be inserted in a CDT without checking them
+// (see option p of RefCDT): points may be snapped, segments removed and
+// split. In a .cdt file (points, triangles, constraints) the
+// triangulation cannot be changed: only the constraints that are not
+// edges of it, or are degenerate or repeated, are removed.
+
+#include <iostream>
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "defs.h"
+#include "error.h"
+#include "geom.h"
+#include "utils.h"
+#include "ttriang.h"
+#include "segclean.h"
+
+
+// Read n pairs (or triples) of indices.
+static TIndex *ReadIndices( ifstream &inFile, TIndex n, int k )
+{
+   TIndex i, *A = new TIndex[k*n+1];
+   check( (A == NULL), "insufficient memory" );
+   for ( i=0; i<k*n; i++ )
+   {
+      inFile >> A[i];
+      check( (inFile.fail()), "unexpected end of input file" );
+   }
+   return( A );
+}
+
+static void WriteIndices( ofstream &outFile, TIndex *A, TIndex n, int k )
+{
+   TIndex i;
+   int j;
+   outFile << n << endl;
+   for ( i=0; i<n; i++ )
+   {
+      for ( j=0; j<k; j++ ) outFile << ( j ? " " : "" ) << A[k*i+j];
+      outFile << endl;
+   }
+}
+
+int main( int argc, char **argv )
+{
+   TIndex nPts, nTrg = 0, nSeg = 0, i;
+   PTPoint *Points;
+   TIndex *Trg = NULL, *Seg = NULL;
+   double tol = 0.0;
+   boolean cdt;
+   TSegCleanStats St;
+
+   cerr.precision(16);
+   cerr << endl;
+
+   if ( argc < 3 || argc > 4 )
+   {
+      cerr << "usage: " << argv[0] << " infile outfile [snap_tolerance]" << endl;
+      cerr << "       (infile .cdt: constraints are only checked)" << endl;
+      exit(-1);
+   }
+   if ( argc == 4 ) tol = ParsePositiveFloat(argc, argv, 3);
+
+   i = strlen( argv[1] );
+   cdt = ( i >= 4 && strcmp( argv[1] + i - 4, ".cdt" ) == 0 );
+   check( (cdt && tol > 0.0), "snapping not possible on a .cdt file" );
+
+   //
+   // read input
+   //
+
+   ifstream inFile;
+   inFile.open( argv[1] );
+   check( !inFile, "cannot open input file" );
+
+   inFile >> nPts;
+   check( (inFile.fail() || nPts < 1), "input with no points" );
+   Points = new PTPoint[nPts];
+   check( (Points == NULL), "insufficient memory" );
+   for ( i=0; i<nPts; i++ )
+   {
+      Points[i] = new TPoint();
+      check( (Points[i] == NULL), "insufficient memory" );
+      inFile >> (*Points[i]);
+      check( (inFile.fail()), "unexpected end of input file" );
+      Points[i]->PID = i;
+   }
+   if ( cdt )
+   {
+      inFile >> nTrg;
+      Trg = ReadIndices( inFile, nTrg, 3 );
+   }
+   inFile >> nSeg;
+   if ( inFile.fail() ) nSeg = 0;
+   Seg = ReadIndices( inFile, nSeg, 2 );
+   inFile.close();
+
+   cerr << "read " << nPts << " points, ";
+   if ( cdt ) cerr << nTrg << " triangles, ";
+   cerr << nSeg << " constraints" << endl;
+
+   //
+   // clean
+   //
+
+   if ( cdt )
+      nSeg = SegClean::CheckConstraints( nPts, Trg, nTrg, Seg, nSeg, St );
+   else
+      nSeg = SegClean::Clean( Points, nPts, Seg, nSeg, tol, St );
+
+   St.Print( cerr );
+   cerr << "left " << nPts << " points, " << nSeg << " constraints" << endl;
+
+   //
+   // write output, in the same format
+   //
+
+   ofstream outFile;
+   outFile.open( argv[2] );
+   check( !outFile, "cannot open output file" );
+   outFile.precision( 12 );
+
+   outFile << nPts << endl;
+   for ( i=0; i<nPts; i++ )
+      outFile << Points[i]->x << " " << Points[i]->y << " " << Points[i]->z << endl;
+   if ( cdt ) WriteIndices( outFile, Trg, nTrg, 3 );
+   WriteIndices( outFile, Seg, nSeg, 2 );
+   outFile.close();
+
+   cerr << "output written" << endl << endl;
+   return 0;
+}
@@ -0,0 +1,142 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+/* ------------------------------------------------------------------------ */
+/*           EXTRACTION OF MESHES FROM A MULTI-TRIANGULATION                */
+/* ------------------------------------------------------------------------ */
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "defs.h"
+#include "error.h"
+#include "mtquery.h"
+
+using namespace std;
+
+
+//
+// Parse a query from the n strings in arg: one of
+//    u eps                          uniform threshold
+//    r eps epsout x0 y0 x1 y1       region of interest
+//    v eps vx vy vz                 viewpoint
+// Return FALSE if the query is not valid.
+//
+
+static boolean ParseQuery( PTMTQuery Q, int n, char **arg )
+{
+   double v[6];
+   int i, nv;
+
+   if ( n < 2 || strlen( arg[0] ) != 1 ) return( FALSE );
+   switch( arg[0][0] )
+   {
+      case 'u': case 'U': nv = 1; break;
+      case 'r': case 'R': nv = 6; break;
+      case 'v': case 'V': nv = 4; break;
+      default: return( FALSE );
+   }
+   if ( n != nv+1 ) return( FALSE );
+   for( i=0; i<nv; i++ )
+      if ( sscanf( arg[i+1], "%lf", &v[i] ) != 1 ) return( FALSE );
+   if ( v[0] < 0.0 ) return( FALSE );
+
+   switch( arg[0][0] )
+   {
+      case 'u': case 'U': Q->SetUniform( v[0] ); break;
+      case 'r': case 'R': Q->SetROI( v[0], v[1], v[2], v[3], v[4], v[5] ); break;
+      case 'v': case 'V': Q->SetView( v[0], v[1], v[2], v[3] ); break;
+   }
+   return( TRUE );
+}
+
+
+static double Seconds()
+{
+   struct timeval tv;
+   gettimeofday( &tv, NULL );
+   return( tv.tv_sec + 1e-6 * tv.tv_usec );
+}
+
+
+static void Answer( PTMTQuery Q )
+{
+   double t0 = Seconds();
+   Q->Extract();
+   double t1 = Seconds();
+   cerr << "mesh with " << Q->MeshSize() << " triangles extracted in "
+        << 1000.0 * (t1-t0) << " ms" << endl;
+}
+
+
+int main( int argc, char **argv )
+{
+   PTMTQuery Q;
+
+   cerr << endl;
+
+   if ( argc < 3 )
+   {
+      cerr << "usage: " << argv[0] << " mtfile outfile [query]" << endl
+           << "  query: u eps | r eps epsout x0 y0 x1 y1 | v eps vx vy vz" << endl
+           << "  without query, queries are read from standard input, one per line,"
+           << endl << "  and each one is answered starting from the previous mesh" << endl;
+      exit(-1);
+   }
+
+   Q = new TMTQuery( argv[1] );
+   check( (Q == NULL), "INSUFFICIENT MEMORY" );
+   cerr << "MT with " << Q->NumNodes() << " nodes and " << Q->NumTiles()
+        << " tiles loaded" << endl;
+
+   if ( argc > 3 )
+   {
+      check( (!ParseQuery( Q, argc-3, argv+3 )), "invalid query" );
+      Answer( Q );
+   }
+   else
+   {
+      char line[1024];
+      char *arg[8];
+      int n;
+
+      while ( fgets( line, sizeof(line), stdin ) != NULL )
+      {
+         n = 0;
+         for( char *p = strtok( line, " \t\r\n" ); p != NULL && n < 8;
+              p = strtok( NULL, " \t\r\n" ) )
+            arg[n++] = p;
+         if ( n == 0 ) continue;
+         if ( ParseQuery( Q, n, arg ) )
+            Answer( Q );
+         else
+            cerr << "invalid query" << endl;
+      }
+   }
+
+   Q->WriteMesh( argv[2] );
+   delete Q;
+   return 0;
+}
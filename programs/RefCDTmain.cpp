@@ -31,6 +31,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "defs.h"
 #include "error.h"
 #include "geom.h"
+#include "utils.h"
 
 #include "mttracer.h"
 
@@ -38,27 +39,125 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "refdel.h"
 #include "decCDT.h"
 #include "refCDT.h"
+#include "referrCDT.h"
 
 int main( int argc, char **argv )
 {
    PTTriangulation T;
+   PTRefCDT R;  // same object as T
    MTTracer MT;
+   char c;
+   int a = 3; /* current argument scanned on command line */
 
    cerr.precision(16);
    cerr << endl;
 
-   if ( argc != 3 )
+   if ( argc < 3 )
    {
-      cerr << "usage: " << argv[0] << " infile outfile" << endl;
+      cerr << "usage: " << argv[0] << " infile outfile [p tolerance] [reorder]" << endl;
+      cerr << "       " << argv[0]
+           << " infile outfile c termination [budgets] [p tolerance] [reorder]" << endl;
       exit(-1);
    }
  
+   if ( IsLetterArg(argc, argv, a, "cC") )
+   {
+      //
+      // Constraints first, then the other points in order of error,
+      // until the termination condition (as in RefDel)
+      //
+
+      a++;
+      c = ParseLetter(argc, argv, a++, "uUeEaA");
+      cerr << "Termination option = " << c << endl;
+      switch( c )
+      {
+         case 'U': case 'u':
+         {
+            int nupd = ParseIntegerAtLeast(argc, argv, a++, 0);
+            MT.SetTerminateCondition( TERM_NUPD, nupd );
+         }
+         break;
+         case 'E': case 'e':
+         {
+            int norm;
+            double errlev;
+            double pct = 100.0;
+            char c1 = ParseLetter(argc, argv, a++, "xXsSqQpP");
+            cerr << "Norm option = " << c1 << endl;
+            switch(c1)
+            {
+               case 'X': case 'x': norm = NORM_MAX; break;
+               case 'S': case 's': norm = NORM_MED; break;
+               case 'Q': case 'q': norm = NORM_SQM; break;
+               case 'P': case 'p': norm = NORM_PCT; break;
+            }
+            if ( norm == NORM_PCT )
+            {
+               pct = ParsePositiveFloat(argc, argv, a++);
+               check( (pct > 100.0), "percentile larger than 100" );
+               cerr << "Percentile = " << pct << endl;
+            }
+            errlev = ParsePositiveFloat(argc, argv, a++);
+            cerr << "Error threshold = " << errlev << endl;
+            MT.SetTerminateCondition( TERM_ERR, norm, (double)errlev, pct );
+         }
+         break;
+      }  // end switch (c)
+
+      //
+      // Optional budgets on Time, memory Size, triangle Count
+      //
+
+      while ( IsLetterArg(argc, argv, a, "tTsScC") )
+      {
+         int budget;
+
+         c = ParseLetter(argc, argv, a++, "tTsScC");
+         budget = ParseIntegerAtLeast(argc, argv, a++, 1);
+         cerr << "Budget option = " << c << " " << budget << endl;
+         switch( c )
+         {
+            case 'T': case 't': MT.SetTerminateCondition( TERM_TIME, budget ); break;
+            case 'S': case 's': MT.SetTerminateCondition( TERM_MEM, budget ); break;
+            case 'C': case 'c': MT.SetTerminateCondition( TERM_NTRG, budget ); break;
+         }
+      }
+
+      R = new TRefErrCDT( &MT );
+   }
+   else
+   {
+      //
+      // All points, then all constraints
+      //
+
+      R = new TRefCDT( &MT );
+   }
+   check( (R == NULL), "INSUFFICIENT MEMORY" );
+   T = R;
+
    //
-   // Create triangulation
+   // Optional cleaning of the input (Preprocessing), with a snapping
+   // tolerance: constraints are then inserted without checks
    //
-       
-   T = new TRefCDT( &MT );
-   check( (T == NULL), "INSUFFICIENT MEMORY" );
+
+   if ( IsLetterArg(argc, argv, a, "pP") )
+   {
+      double tol;
+
+      a++;
+      tol = ParsePositiveFloat(argc, argv, a++);
+      cerr << "Clean input, snapping tolerance = " << tol << endl;
+      R->SetCleanInput( tol );
+   }
+   check( (argc > a+1), "too many arguments" );
+
+   //
+   // Optional renumbering of input and output along a space-filling curve
+   //
+
+   T->SetReorderMode( ParseReorder(argc, argv, a) );
    cerr << endl;
 
    //
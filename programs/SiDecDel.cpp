@@ -140,27 +140,70 @@ int main( int argc, char **argv )
       {
          int norm;
          double errlev;
+         double pct = 100.0;
          char c1;
          if (interactive_mode)
-            c1 = AskLetter("MaX, mean of Sums, mean of sQuares", "xXsSqQ");
+            c1 = AskLetter("MaX, mean of Sums, mean of sQuares, Percentile", "xXsSqQpP");
          else
-            c1 = ParseLetter(argc, argv, a++, "xXsSqQ");
+            c1 = ParseLetter(argc, argv, a++, "xXsSqQpP");
          cerr << "Norm option = " << c1 << endl;
          switch(c1)
          {
             case 'X': case 'x': norm = NORM_MAX; break;
             case 'S': case 's': norm = NORM_MED; break;
             case 'Q': case 'q': norm = NORM_SQM; break;
+            case 'P': case 'p': norm = NORM_PCT; break;
+         }
+         if ( norm == NORM_PCT )
+         {
+            if (interactive_mode)
+               pct = AskPositiveFloat("Percentile (at most 100)");
+            else
+               pct = ParsePositiveFloat(argc, argv, a++);
+            check( (pct > 100.0), "percentile larger than 100" );
+            cerr << "Percentile = " << pct << endl;
          }
          if (interactive_mode)
             errlev = AskPositiveFloat("Maximum error level");
          else
             errlev = ParsePositiveFloat(argc, argv, a++);
          cerr << "Error threshold = " << errlev << endl;
-         MT.SetTerminateCondition( TERM_ERR, norm, (double)errlev );
+         MT.SetTerminateCondition( TERM_ERR, norm, (double)errlev, pct );
       }
       break;
    }  // end switch (c)
+
+   //
+   // Optional budgets, combined with the termination condition: the
+   // updates also stop after some wall-clock Time (seconds), above some
+   // memory Size (megabytes) or at some triangle Count
+   //
+
+   for (;;)
+   {
+      int budget;
+
+      if (interactive_mode)
+         c = AskLetter("Budget on Time, memory Size, triangle Count, None",
+                       "tTsScCnN");
+      else if ( IsLetterArg(argc, argv, a, "tTsScC") )
+         c = ParseLetter(argc, argv, a++, "tTsScC");
+      else
+         c = 'n';
+      if ( c=='n' || c=='N' ) break;
+
+      if (interactive_mode)
+         budget = AskIntegerAtLeast("Budget (seconds, megabytes, triangles)", 1);
+      else
+         budget = ParseIntegerAtLeast(argc, argv, a++, 1);
+      cerr << "Budget option = " << c << " " << budget << endl;
+      switch( c )
+      {
+         case 'T': case 't': MT.SetTerminateCondition( TERM_TIME, budget ); break;
+         case 'S': case 's': MT.SetTerminateCondition( TERM_MEM, budget ); break;
+         case 'C': case 'c': MT.SetTerminateCondition( TERM_NTRG, budget ); break;
+      }
+   }
    
    //
    // Create triangulation based on the parameters
@@ -174,13 +217,34 @@ int main( int argc, char **argv )
           T = new TDecErrDeBerg( kdegree, &MT, errrecalc );
          //  T = new TDecErrDelaunay( kdegree, &MT, errrecalc );
    check( (T == NULL), "INSUFFICIENT MEMORY" );
+
+   //
+   // Optional renumbering of input and output along a space-filling
+   // curve, followed by the optional levels of detail: error levels
+   // (or numbers of updates, if termination is not based on error)
+   // at which the triangulation is also written on outfile.lod<i>
+   // (last arguments, command line mode only). In command line mode,
+   // the run is also checkpointed, and resumed if interrupted, if
+   // CHECKPOINT is defined in defs.h.
+   //
+
+   if (!interactive_mode)
+   {
+      double lods[MT_MAXLODS];
+      int nlods;
+
+      T->SetReorderMode( ParseReorder(argc, argv, a) );
+      nlods = ParseLevels(argc, argv, a+1, lods, MT_MAXLODS);
+      MT.SetLodLevels( nlods, lods );
+      T->SetCheckpoint( argc, argv );
+   }
    cerr << endl;
 
    //
    // Execute triangulation
    //
 
-#ifdef MT_TRACER
+#if defined(MT_TRACER) || defined(MT_NATIVE)
        {
          static char first_line[] = "Multi-Tesselation build by calling:\n";
          char * cmd_line; /* commad line */
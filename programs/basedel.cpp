@@ -43,7 +43,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //  Constructor of TDelaunayBase.
 //
 
-TDelaunayBase::TDelaunayBase() : TTriangulation(), InflRegnBorder() 
+TDelaunayBase::TDelaunayBase() : TTriangulation(), InflRegnBorder(), OldTrgs(), NewTrgs() 
 {
    #ifdef DEBUG
       DEBUG << "TDelaunayBase Constructor" << endl;
@@ -52,6 +52,97 @@ TDelaunayBase::TDelaunayBase() : TTriangulation(), InflRegnBorder()
    FirstTrgToDel = NULL; 
 }
        
+// --------------------------------------------------------------------------------
+//  
+//  void TDelaunayBase::CollectInfluenceRegion()
+//
+//  Put into OldTrgs the triangles of the influence region, i.e., the
+//  triangles marked as TO_DELETE which are reachable from FirstTrgToDel
+//  through edges marked as TO_DELETE. Mark TO_DELETE is removed from
+//  the collected triangles.
+//  If OldTrgs is not empty, the region of the current update step has
+//  already been collected, and nothing is done.
+//
+
+void TDelaunayBase::CollectInfluenceRegion()
+{
+     TIndex i;
+     PTTriangle CurrTrg, NextTrg;
+     PTEdge NextEdg;
+
+     // ...if there are no triangles to be deleted, or they are already
+     // collected
+     if ( FirstTrgToDel == NULL || ! OldTrgs.IsEmpty() ) return;
+
+     FirstTrgToDel->UnMark( TO_DELETE );
+     OldTrgs.Add( FirstTrgToDel );
+
+     //
+     // OldTrgs is visited while it grows, so that triangles are collected
+     // in breadth-first order
+     //
+
+     for( i=0; i<OldTrgs.Count(); i++ )
+     {
+         CurrTrg = OldTrgs[i];
+
+	 #ifdef ROBUST
+  	    check( (CurrTrg == NULL), "TDelaunayBase::CollectInfluenceRegion(), this should not happen");
+	 #endif
+
+	 for( int e=0; e<3; e++ )
+	 {
+	     NextEdg = CurrTrg->TE[e];
+
+	     if ( NextEdg != NULL && NextEdg->Marked(TO_DELETE) )
+	     {
+                 NextTrg = ( NextEdg->ET[0] != CurrTrg ? NextEdg->ET[0] : NextEdg->ET[1] );
+
+	         if ( NextTrg != NULL && NextTrg->Marked( TO_DELETE ) )
+		 {
+		     NextTrg->UnMark( TO_DELETE );
+		     OldTrgs.Add( NextTrg );
+		 }
+	     }
+	 }
+     }
+}
+
+
+// --------------------------------------------------------------------------------
+//  
+//  void TDelaunayBase::CollectNewTriangles()
+//
+//  Put into NewTrgs the triangles marked as NEW_TRIANGLE which can be
+//  reached from FirstTriangle by adjacency navigation. The mark is
+//  removed from the collected triangles.
+//
+
+void TDelaunayBase::CollectNewTriangles()
+{
+     TIndex i;
+     PTTriangle TT[3];
+
+     if ( FirstTriangle == NULL || ! FirstTriangle->Marked( NEW_TRIANGLE ) )
+        return;
+
+     FirstTriangle->UnMark( NEW_TRIANGLE );
+     NewTrgs.Add( FirstTriangle );
+
+     for( i=0; i<NewTrgs.Count(); i++ )
+     {
+         NewTrgs[i]->GetTT( TT[0], TT[1], TT[2] );
+
+         for( int t=0; t<3; t++ )
+            if ( TT[t] != NULL && TT[t]->Marked( NEW_TRIANGLE ) )
+            {
+               TT[t]->UnMark( NEW_TRIANGLE );
+               NewTrgs.Add( TT[t] );
+            }
+     }
+}
+
+
 // --------------------------------------------------------------------------------
 //  
 //  void TDelaunayBase::DeleteInfluenceRegion()
@@ -70,23 +161,16 @@ void TDelaunayBase::DeleteInfluenceRegion()
       DEBUG << " )" << endl;
      #endif // DEBUG
 
-     // ...if there are no triangles to be deleted
-     if ( FirstTrgToDel == NULL ) return; 
-     
-     TDoubleList<PTTriangle> TrgToDel;
-     PTTriangle CurrTrg, NextTrg;
+     TIndex i;
+     PTTriangle CurrTrg;
      PTEdge NextEdg;
-          
-     TrgToDel.AddHead( FirstTrgToDel );
-     
-     while ( ! TrgToDel.IsEmpty() )
+
+     CollectInfluenceRegion();
+
+     for( i=0; i<OldTrgs.Count(); i++ )
      {
  	    
-         CurrTrg = TrgToDel.RemoveHead();
-	 
-	 #ifdef ROBUST
-  	    check( (CurrTrg == NULL), "TDelaunayBase::DeleteInfluenceRegion(), <1> this should not happen");
-	 #endif
+         CurrTrg = OldTrgs[i];
 	 	  
 	 for( int e=0; e<3; e++ )
 	 {	    
@@ -94,41 +178,19 @@ void TDelaunayBase::DeleteInfluenceRegion()
 	     
 	     //
 	     // edge may have been deleted in previous iterations of the
-	     // while loop, must check
+	     // loop, must check
 	     //
 	     
-	     if ( NextEdg != NULL ) 
-	     {	     
-	     
-		if ( NextEdg->Marked(TO_DELETE) )
-		{
-                    NextTrg = ( NextEdg->ET[0] != CurrTrg ? NextEdg->ET[0] : NextEdg->ET[1] ); 
-		    
-                    DetachEdge( NextEdg );
+	     if ( NextEdg != NULL && NextEdg->Marked(TO_DELETE) )
+	     {
+                 DetachEdge( NextEdg );
 	            
-		    #ifdef _GC_ON
-		       GC::DeleteEdge( NextEdg );
-		    #else
-   		       delete( NextEdg );
-		    #endif // _GC_ON
-		    
-		    NextEdg = NULL;
-		}
-		else
-		    NextTrg = NULL;
-		
-		
-	        if ( NextTrg != NULL )
-		{
-		   if ( NextTrg->Marked( TO_DELETE ) )
-		   {
-		       NextTrg->UnMark( TO_DELETE );
-		       TrgToDel.AddTail( NextTrg );
-		   }
-		}
-						     
-	     } // end ...if( NextEdg != NULL )...
-	     
+		 #ifdef _GC_ON
+		    GC::DeleteEdge( NextEdg );
+		 #else
+   		    delete( NextEdg );
+		 #endif // _GC_ON
+	     }
 	     
 	 } // end...for
 	 
@@ -144,11 +206,10 @@ void TDelaunayBase::DeleteInfluenceRegion()
 	 #else
    	    delete( CurrTrg );
 	 #endif // _GC_ON
-	 
-	 CurrTrg = NULL;
-
 	    
-     } // end ...while( !TrgToDel.IsEmpty() )
+     } // end ...for( i<OldTrgs.Count() )
+
+     OldTrgs.Clear();
      
       #ifdef DEBUG
          DEBUG << "Exit DeleteInfluenceRegion" << endl;
@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "defs.h"
 #include "ttriang.h"
 #include "tdoublelist.h"
+#include "tbuffer.h"
 #include "ttriangulation.h"
 
 
@@ -71,6 +72,26 @@ class TDelaunayBase : public TTriangulation
       // Used as an entry point for such triangle set, in order to
       // visit the set.
       PTTriangle FirstTrgToDel;
+
+      // Triangles of the influence region of the current update step,
+      // filled by CollectInfluenceRegion() and emptied when they are
+      // deleted.
+      TBuffer<PTTriangle> OldTrgs;
+
+      // Triangles created by the current update step, in order of
+      // creation. Filled by the classes that record the updates in an
+      // MT, and emptied when the update is passed to the MT tracer.
+      TBuffer<PTTriangle> NewTrgs;
+
+      // Collect the triangles of the influence region into OldTrgs,
+      // unless they have already been collected for the current update.
+      void CollectInfluenceRegion();
+
+      // Put into NewTrgs the triangles marked as NEW_TRIANGLE which are
+      // reachable from FirstTriangle; used to record the initial
+      // triangulation, whose triangles are not recorded as they are
+      // created.
+      void CollectNewTriangles();
  
       // virtual void DeleteInfluenceRegion();
       // this function has been temporarily made public in order
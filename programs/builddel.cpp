@@ -41,6 +41,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "basedel.h"
 #include "builddel.h"
+#include "ptreader.h"
 
 
 
@@ -55,6 +56,8 @@ TBuildDelaunay::TBuildDelaunay() : TDelaunayBase()
     #ifdef DEBUG
      DEBUG << "TBuildDelaunay Constructor" << endl;
     #endif // DEBUG 
+
+    HullCand = NULL;
 }
 
 
@@ -72,12 +75,65 @@ TBuildDelaunay::TBuildDelaunay() : TDelaunayBase()
 
 void TBuildDelaunay::ReadData( const char *infname )
 {
-   register int i;
+   register TIndex i;
 
    #ifdef DEBUG
     DEBUG << "\nTBuildDelaunay::ReadData()" << endl;
    #endif // DEBUG
     
+#ifdef PIPELINED_INPUT
+
+   //
+   // The points are parsed by the reader thread, while here we create
+   // them and update the candidates for the convex hull, so that
+   // TRefineDelaunay::CalcConvexHull() has only few points to sort.
+   //
+
+   TPointReader Reader( infname );
+
+   nPts = Reader.NumPoints();
+
+   check( (nPts < 3), "input with less than 3 points" );
+
+   Points = new PTPoint[nPts];
+   HullCand = new char[nPts];
+   check( (Points == NULL || HullCand == NULL), "TBuildDelaunay::ReadData(), insufficient memory for Points");
+
+   TIndex ip = 0;
+   int n, k;
+   double *xyz;
+   PTPoint p = NULL;
+
+   cerr << endl;
+
+   while ( (n = Reader.NextChunk( xyz )) > 0 )
+   {
+       for( k=0; k<n; k++, xyz+=3 )
+       {
+          #ifdef COMPACT_COORDS
+           TQuantFrame::Fix( xyz[0], xyz[1], xyz[2] );
+          #endif
+          p = new TPoint( xyz[0], xyz[1], xyz[2] );
+          check( (p == NULL), "TBuildDelaunay::ReadData(), insufficient memory for TPoint");
+          p->PID = ip;
+
+          #ifdef DEBUG
+           DEBUG << "read point: " << (*p) << endl;
+          #endif // DEBUG
+
+          HullCand[ip] = UpdateHullCandidates( p );
+          Points[ip++] = p;
+       }
+       Reader.ReleaseChunk();
+       cerr << "\rread " << ip << " points" << flush;
+   }
+
+   check( (ip < nPts), "TBuildDelaunay::ReadData(), unexpected End Of File");
+
+   cerr << "\rread " << ip << " points" << endl;
+
+#else
+
    ifstream inFile;
    
    inFile.open( infname );
@@ -99,7 +155,7 @@ void TBuildDelaunay::ReadData( const char *infname )
    Points = new PTPoint[nPts];
    check( (Points == NULL), "TBuildDelaunay::ReadData(), insufficient memory for Points");
 
-   int ip = 0;
+   TIndex ip = 0;
    PTPoint p = NULL;
    
    cerr << endl;
@@ -116,6 +172,7 @@ void TBuildDelaunay::ReadData( const char *infname )
        //
      
        inFile >> (*p); 
+       p->PID = i;
        
        #ifdef DEBUG
         DEBUG << "read point: " << (*p) << endl;
@@ -132,10 +189,146 @@ void TBuildDelaunay::ReadData( const char *infname )
    cerr << "\rread " << ip << " points" << endl;
 
    inFile.close();
+
+#endif // PIPELINED_INPUT
+
+   //
+   // If a reordering is required, sort the points along the curve and
+   // re-allocate them in such order, so that points close in space are
+   // also close in memory.
+   //
+
+   if ( ReorderMode != REORDER_NONE )
+   {
+      PTPoint *Aux = new PTPoint[nPts];
+      check( (Aux == NULL), "TBuildDelaunay::ReadData(), insufficient memory for Points");
+
+      ReorderInput();
+
+      for( i=0; i<nPts; i++ )
+      {
+         Aux[i] = new TPoint( *Points[i] );
+         check( (Aux[i] == NULL), "TBuildDelaunay::ReadData(), insufficient memory for TPoint");
+
+         #ifdef PIPELINED_INPUT
+          for( int k=0; k<8; k++ )
+             if ( ExtPts[k] == Points[i] ) ExtPts[k] = Aux[i];
+         #endif // PIPELINED_INPUT
+      }
+      for( i=0; i<nPts; i++ )
+      {
+         delete Points[i];
+         Points[i] = Aux[i];
+      }
+      delete[] Aux;
+   }
    
 }
 
 
+//
+// Projection of p on the i-th of the directions x, x+y, y, y-x, -x,
+// -x-y, -y, x-y.
+//
+
+static double ExtremeKey( PTPoint p, int i )
+{
+   switch ( i )
+   {
+      case 0: return(  p->x );
+      case 1: return(  p->x + p->y );
+      case 2: return(  p->y );
+      case 3: return(  p->y - p->x );
+      case 4: return( -p->x );
+      case 5: return( -p->x - p->y );
+      case 6: return( -p->y );
+   }
+   return( p->x - p->y );
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//   boolean TBuildDelaunay::UpdateExtremes( PTPoint p )
+//
+//   Replace with p the extreme points that p exceeds. ExtPts must have
+//   been initialized (e.g., all to the first point).
+//
+
+boolean TBuildDelaunay::UpdateExtremes( PTPoint p )
+{
+   int i;
+   boolean changed = FALSE;
+
+   for ( i=0; i<8; i++ )
+   {
+      if ( ExtremeKey( p, i ) > ExtremeKey( ExtPts[i], i ) )
+      {
+         ExtPts[i] = p;
+         changed = TRUE;
+      }
+   }
+   return( changed );
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//   boolean TBuildDelaunay::UpdateHullCandidates( PTPoint p )
+//
+//   Update the extreme points with p. Return TRUE if p may be on the
+//   convex hull, i.e., if it is a new extreme point or it is not
+//   strictly inside the polygon of the current extreme points. Since
+//   such polygon can only grow, a point rejected here cannot be on the
+//   convex hull of the whole set.
+//
+
+boolean TBuildDelaunay::UpdateHullCandidates( PTPoint p )
+{
+   int i;
+
+   if ( p->PID == 0 )
+   {
+      for ( i=0; i<8; i++ ) ExtPts[i] = p;
+      return( TRUE );
+   }
+
+   if ( UpdateExtremes( p ) ) return( TRUE );
+
+   return( !InsideExtremes( p ) );
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//   boolean TBuildDelaunay::InsideExtremes( PTPoint p )
+//
+//   The extreme points are in counterclockwise order, p is strictly
+//   inside their polygon iff it is on the left of all its (non
+//   degenerate) edges. If there are less than three distinct extreme
+//   points no point can be on the left of all edges.
+//
+
+boolean TBuildDelaunay::InsideExtremes( PTPoint p )
+{
+   int i;
+   PTPoint a, b;
+
+   if ( p->x <= ExtPts[4]->x || p->x >= ExtPts[0]->x ||
+        p->y <= ExtPts[6]->y || p->y >= ExtPts[2]->y )
+      return( FALSE );
+
+   for ( i=0; i<8; i++ )
+   {
+      a = ExtPts[i];
+      b = ExtPts[(i+1)%8];
+      if ( a != b && Geom::Turnxy( a, b, p ) != TURN_LEFT )
+         return( FALSE );
+   }
+   return( TRUE );
+}
+
+
 // ---------------------------------------------------------------------------------
 //
 //   void TBuildDelaunay::InitialTriangulation()
@@ -162,7 +355,7 @@ void TBuildDelaunay::InitialTriangulation()
    // counterclockwise order
    //
 
-   int pid = 2;
+   TIndex pid = 2;
 
    while( Geom::Alignedxy( Points[0], Points[1], Points[pid] ) )
    {
@@ -813,7 +1006,14 @@ void TBuildDelaunay::CalcInflRegnMain()
       else
            NextTrg = CurrEdg->ET[0]; // next triangle on the left of CurrEdg      
             
-      if ( (NextTrg != NULL) && ( NextTrg->InCircle( VertexToIns ) ) )
+      //
+      // The region of influence never crosses a constraint edge (only
+      // present in a constrained Delaunay triangulation, see TRefErrCDT):
+      // the triangles beyond it are not visible from VertexToIns.
+      //
+
+      if ( (NextTrg != NULL) && ! CurrEdg->Marked( CONSTRAINED ) &&
+           ( NextTrg->InCircle( VertexToIns ) ) )
       {
       
         int e;
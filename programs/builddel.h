@@ -70,7 +70,30 @@ class TBuildDelaunay : virtual public TDelaunayBase
 {
 
    protected:
- 
+
+      //
+      // Candidates for the convex hull (Akl-Toussaint heuristic)
+      //
+
+      // Extreme points in the directions x, x+y, y, y-x, -x, -x-y, -y,
+      // x-y, i.e., in counterclockwise order along the convex hull.
+      PTPoint ExtPts[8];
+
+      // If not NULL, HullCand[PID] is FALSE if the point fell strictly
+      // inside the polygon of the extreme points known when it was read
+      // (filled while reading when PIPELINED_INPUT is defined).
+      char *HullCand;
+
+      // Update the extreme points with p, return TRUE if some of them
+      // has been replaced by p.
+      boolean UpdateExtremes( PTPoint p );
+
+      // Update the extreme points with p, return TRUE if p may be
+      // on the convex hull.
+      boolean UpdateHullCandidates( PTPoint p );
+
+      // TRUE if p is strictly inside the polygon of the extreme points.
+      boolean InsideExtremes( PTPoint p );
       
       //
       // Methods
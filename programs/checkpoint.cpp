@@ -0,0 +1,262 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : checkpoint.cpp
+//
+//   Implementation of class TCheckpoint (see checkpoint.h).
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "defs.h"
+
+#ifdef CHECKPOINT
+#include <unistd.h>
+#include <dirent.h>
+#endif
+
+#include "error.h"
+#include "checkpoint.h"
+
+
+TCheckpoint::TCheckpoint()
+{
+   fd = NULL;
+   FileName = TmpName = NULL;
+   Failed = FALSE;
+}
+
+
+TCheckpoint::~TCheckpoint()
+{
+   Close();
+}
+
+
+// -----------------------------------------------------------------
+//
+//  Writing.
+//
+
+boolean TCheckpoint::OpenWrite( const char *iFileName )
+{
+   Close();
+
+   // ...the writer of a run that has been killed may still be going on:
+   // each process writes its own temporary file
+   FileName = new char[ strlen(iFileName) + 1 ];
+#ifdef CHECKPOINT
+   TmpName = TmpFileName( iFileName, (long)getpid() );
+#else
+   TmpName = TmpFileName( iFileName, -1 );
+#endif
+   if ( FileName == NULL || TmpName == NULL ) return( FALSE );
+   strcpy( FileName, iFileName );
+
+   fd = fopen( TmpName, "wb" );
+   Failed = ( fd == NULL );
+   return( !Failed );
+}
+
+
+char *TCheckpoint::TmpFileName( const char *iFileName, long pid )
+{
+   char *Name = new char[ strlen(iFileName) + 32 ];
+
+   if ( Name == NULL ) return( NULL );
+   if ( pid >= 0 ) sprintf( Name, "%s.tmp%ld", iFileName, pid );
+   else            sprintf( Name, "%s.tmp", iFileName );
+   return( Name );
+}
+
+
+void TCheckpoint::Discard( const char *iFileName, long pid )
+{
+   char *Name = TmpFileName( iFileName, pid );
+
+   if ( Name == NULL ) return;
+   remove( Name );
+   delete[] Name;
+}
+
+
+void TCheckpoint::DiscardAll( const char *iFileName )
+{
+#ifdef CHECKPOINT
+   // ...split iFileName in directory and base name: the temporary
+   // files are the entries of the directory that start with
+   // "<base name>.tmp"
+   const char *Base = strrchr( iFileName, '/' );
+   char *Dir = new char[ strlen(iFileName) + 2 ];
+   char *Name = new char[ strlen(iFileName) + 300 ];
+
+   if ( Dir == NULL || Name == NULL ) { delete[] Dir; delete[] Name; return; }
+
+   if ( Base == NULL )
+   {
+      strcpy( Dir, "./" );
+      Base = iFileName;
+   }
+   else
+   {
+      strncpy( Dir, iFileName, Base - iFileName + 1 );
+      Dir[ Base - iFileName + 1 ] = '\0';
+      Base++;
+   }
+
+   size_t n = strlen( Base );
+   DIR *d = opendir( Dir );
+   struct dirent *e;
+
+   while ( d != NULL && ( e = readdir( d ) ) != NULL )
+   {
+      if ( strncmp( e->d_name, Base, n ) != 0 || strncmp( e->d_name + n, ".tmp", 4 ) != 0 )
+         continue;
+      if ( strlen( e->d_name ) > 255 ) continue;
+      sprintf( Name, "%s%s", Dir, e->d_name );
+      remove( Name );
+   }
+   if ( d != NULL ) closedir( d );
+
+   delete[] Dir;
+   delete[] Name;
+#else
+   // ...without checkpoints no temporary file is written
+   (void)iFileName;
+#endif
+}
+
+
+void TCheckpoint::Put( const void *p, size_t n )
+{
+   if ( !Failed && n > 0 && fwrite( p, 1, n, fd ) != n ) Failed = TRUE;
+}
+
+
+void TCheckpoint::PutString( const char *s )
+{
+   TIndex n = strlen( s );
+
+   PutIndex( n );
+   Put( s, n );
+}
+
+
+boolean TCheckpoint::Commit()
+{
+   if ( fd == NULL ) return( FALSE );
+
+   if ( !Sync( fd ) ) Failed = TRUE;
+   if ( fclose( fd ) != 0 ) Failed = TRUE;
+   fd = NULL;
+
+   if ( !Failed && rename( TmpName, FileName ) != 0 ) Failed = TRUE;
+   if ( Failed ) remove( TmpName );
+   return( !Failed );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  Reading.
+//
+
+boolean TCheckpoint::OpenRead( const char *iFileName )
+{
+   Close();
+
+   fd = fopen( iFileName, "rb" );
+   return( fd != NULL );
+}
+
+
+void TCheckpoint::Get( void *p, size_t n )
+{
+   check( (n > 0 && fread( p, 1, n, fd ) != n),
+          "TCheckpoint::Get(), checkpoint file truncated" );
+}
+
+
+boolean TCheckpoint::MatchString( const char *s )
+{
+   TIndex n = GetIndex();
+   boolean Match;
+
+   // ...do not read a string of a different length, it may be garbage
+   if ( n != (TIndex)strlen( s ) ) return( FALSE );
+
+   char *t = new char[ n + 1 ];
+   check( (t == NULL), "TCheckpoint::MatchString(), insufficient memory" );
+   Get( t, n );
+   t[n] = '\0';
+   Match = ( strcmp( s, t ) == 0 );
+   delete[] t;
+   return( Match );
+}
+
+
+void TCheckpoint::Close()
+{
+   if ( fd != NULL )
+   {
+      // a file still open for writing has not been committed
+      fclose( fd );
+      if ( TmpName != NULL ) remove( TmpName );
+      fd = NULL;
+   }
+   if ( FileName != NULL ) delete[] FileName;
+   if ( TmpName != NULL ) delete[] TmpName;
+   FileName = TmpName = NULL;
+}
+
+
+// -----------------------------------------------------------------
+//
+//  Other files.
+//
+
+boolean TCheckpoint::Sync( FILE *f )
+{
+   if ( fflush( f ) != 0 ) return( FALSE );
+#ifdef CHECKPOINT
+   if ( fsync( fileno( f ) ) != 0 ) return( FALSE );
+#endif
+   return( TRUE );
+}
+
+
+boolean TCheckpoint::Truncate( FILE *f, long Offset )
+{
+#ifdef CHECKPOINT
+   if ( fflush( f ) != 0 || fseek( f, 0L, SEEK_END ) != 0 || ftell( f ) < Offset )
+      return( FALSE );
+   return( ftruncate( fileno( f ), Offset ) == 0 && fseek( f, Offset, SEEK_SET ) == 0 );
+#else
+   (void)f; (void)Offset;
+   return( FALSE );
+#endif
+}
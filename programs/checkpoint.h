@@ -0,0 +1,128 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : checkpoint.h
+//
+//   Definition of class TCheckpoint, a binary file holding the state
+//   of a triangulation during the updates, so that an interrupted run
+//   can be resumed from it (see TTriangulation::SaveState and
+//   TTriangulation::LoadState).
+//
+//   The file is written under a temporary name and renamed when it is
+//   complete, so that a crash while writing leaves the previous
+//   checkpoint in place. Values are written in the binary format of
+//   the machine: a checkpoint is only read back by the same program.
+//   Write errors are recorded and reported by Commit(), since the
+//   writer may be a child process that must not exit through error();
+//   read errors are fatal.
+//
+
+
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+#include <stdio.h>
+#include "defs.h"
+
+// Strings at the beginning and at the end of a checkpoint file.
+#define CHECKPOINT_MAGIC "Delaunay checkpoint 1"
+#define CHECKPOINT_END   "end of checkpoint"
+
+
+class TCheckpoint;
+
+typedef class TCheckpoint *PTCheckpoint;
+typedef class TCheckpoint &RTCheckpoint;
+
+
+class TCheckpoint
+{
+   private:
+
+      FILE *fd;
+      char *FileName;        // final name of the file
+      char *TmpName;         // name while writing, NULL when reading
+      boolean Failed;        // TRUE after a write error
+
+      // Temporary name of file FileName written by process pid.
+      static char *TmpFileName( const char *iFileName, long pid );
+
+   public:
+
+      TCheckpoint();
+      ~TCheckpoint();
+
+      // Start writing file FileName, under a temporary name.
+      boolean OpenWrite( const char *iFileName );
+
+      // Remove the temporary file left by process pid if it has not
+      // completed file FileName (e.g., because it has been killed).
+      static void Discard( const char *iFileName, long pid );
+
+      // Remove the temporary files of FileName left by any process,
+      // e.g. by writers killed together with the whole run.
+      static void DiscardAll( const char *iFileName );
+
+      // Flush the file to disk and give it its final name. Return FALSE
+      // if some write has failed (the previous file is then kept).
+      boolean Commit();
+
+      // Open file FileName for reading; return FALSE if it does not exist.
+      boolean OpenRead( const char *iFileName );
+
+      void Close();
+
+      // Record that the checkpoint is not valid, e.g. because a file
+      // it refers to could not be flushed; Commit() will fail.
+      void Fail() { Failed = TRUE; };
+
+      void Put( const void *p, size_t n );
+      void Get( void *p, size_t n );
+
+      void PutIndex( TIndex i ) { Put( &i, sizeof(i) ); };
+      TIndex GetIndex() { TIndex i; Get( &i, sizeof(i) ); return( i ); };
+
+      void PutInt( int i ) { Put( &i, sizeof(i) ); };
+      int GetInt() { int i; Get( &i, sizeof(i) ); return( i ); };
+
+      void PutDouble( double d ) { Put( &d, sizeof(d) ); };
+      double GetDouble() { double d; Get( &d, sizeof(d) ); return( d ); };
+
+      // Strings are written with their length.
+      void PutString( const char *s );
+
+      // Read a string and return TRUE if it is equal to s.
+      boolean MatchString( const char *s );
+
+      // Flush file f to disk, and cut it at length Offset, if it is not
+      // shorter (used for the MT file that TMTBuilder writes while the
+      // updates go on).
+      static boolean Sync( FILE *f );
+      static boolean Truncate( FILE *f, long Offset );
+};
+
+
+#endif // _CHECKPOINT_H
@@ -0,0 +1,119 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : constrset.cpp
+//
+//   Implementation of class TConstraintSet (see constrset.h).
+//
+
+#include "defs.h"
+#include "error.h"
+#include "constrset.h"
+
+
+TConstraintSet::TConstraintSet()
+{
+   List = NULL;
+   n = MaxN = 0;
+   Pos = NULL;
+   MaxEID = 0;
+}
+
+
+TConstraintSet::~TConstraintSet()
+{
+   if ( List != NULL ) delete[] List;
+   if ( Pos != NULL ) delete[] Pos;
+}
+
+
+void TConstraintSet::Grow( TIndex EID )
+{
+   TIndex i, m;
+
+   if ( n == MaxN )
+   {
+      PTEdge *OldList = List;
+
+      MaxN = ( MaxN == 0 ? 256 : 2*MaxN );
+      List = new PTEdge[ MaxN ];
+      check( (List == NULL), "TConstraintSet::Grow(), insufficient memory" );
+      for( i=0; i<n; i++ ) List[i] = OldList[i];
+      if ( OldList != NULL ) delete[] OldList;
+   }
+
+   if ( EID >= MaxEID )
+   {
+      TIndex *OldPos = Pos;
+
+      m = ( MaxEID == 0 ? 1024 : 2*MaxEID );
+      while ( m <= EID ) m *= 2;
+      Pos = new TIndex[ m ];
+      check( (Pos == NULL), "TConstraintSet::Grow(), insufficient memory" );
+      for( i=0; i<MaxEID; i++ ) Pos[i] = OldPos[i];
+      for( ; i<m; i++ ) Pos[i] = -1;
+      if ( OldPos != NULL ) delete[] OldPos;
+      MaxEID = m;
+   }
+}
+
+
+void TConstraintSet::Add( PTEdge E )
+{
+   if ( Contains( E ) ) return;
+
+   Grow( E->EID );
+
+   // an EID is reused only after its edge has been deleted, and a
+   // deleted edge is no longer a constraint
+   #ifdef ROBUST
+      check( (Pos[E->EID] >= 0), "TConstraintSet::Add(), EID already in use" );
+   #endif
+
+   Pos[E->EID] = n;
+   List[n++] = E;
+}
+
+
+void TConstraintSet::Remove( PTEdge E )
+{
+   TIndex i;
+
+   if ( ! Contains( E ) ) return;
+
+   // move the last constraint in the position of E
+   i = Pos[E->EID];
+   List[i] = List[--n];
+   Pos[List[i]->EID] = i;
+   Pos[E->EID] = -1;
+}
+
+
+void TConstraintSet::Clear()
+{
+   TIndex i;
+
+   for( i=0; i<n; i++ ) Pos[List[i]->EID] = -1;
+   n = 0;
+}
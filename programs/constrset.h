@@ -0,0 +1,92 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : constrset.h
+//
+//   Definition of class TConstraintSet, the set of the constraint edges
+//   of a CDT. It keeps the constraints in a compact array, in order of
+//   insertion (up to removals, which move the last one in the hole),
+//   and a dense table on EIDs with the position of each of them in the
+//   array. Insertion, removal and membership cost O(1), and the
+//   constraints can be listed without visiting the triangulation.
+//
+//   TDecCDT keeps such a set only if asked (see SetConstraintStorage),
+//   in addition to the CONSTRAINED marks of the edges.
+//
+
+
+#ifndef _CONSTRSET_H
+#define _CONSTRSET_H
+
+#include "defs.h"
+#include "ttriang.h"
+
+
+class TConstraintSet;
+
+typedef TConstraintSet *PTConstraintSet;
+
+
+class TConstraintSet
+{
+   private:
+
+      PTEdge *List;     // the constraints, in positions [0...n-1]
+      TIndex n, MaxN;
+
+      TIndex *Pos;      // position in List of the edge of each EID, -1 if none
+      TIndex MaxEID;
+
+      // Not copyable.
+      TConstraintSet( const TConstraintSet & );
+      void operator=( const TConstraintSet & );
+
+      // Make room for n+1 constraints and for EID.
+      void Grow( TIndex EID );
+
+   public:
+
+      TConstraintSet();
+      ~TConstraintSet();
+
+      TIndex Count() { return( n ); };
+
+      // The i-th constraint, for 0 <= i < Count().
+      PTEdge Get( TIndex i ) { return( List[i] ); };
+
+      // Temporary copies of an edge share its EID: only the edge
+      // itself is in the set.
+      boolean Contains( PTEdge E )
+         { return( E->EID < MaxEID && Pos[E->EID] >= 0 && List[Pos[E->EID]] == E ); };
+
+      // Add E (nothing if already present) / remove E (nothing if
+      // not present).
+      void Add( PTEdge E );
+      void Remove( PTEdge E );
+
+      // Empty the set, keeping its memory.
+      void Clear();
+};
+
+#endif // _CONSTRSET_H
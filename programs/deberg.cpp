@@ -33,6 +33,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //  rispettivamente, da TDecRndDelaunay e TDecErrDelaunay.
 //  The solution of a static class avoids using multiple inheritance
 //  with all problems connected to virtual base classes etc...
+//  Function SelectVerticesCDT is a variant for the decimation of a CDT
+//  (used by TDecRndDeBergCDT), where the removal of a vertex may change
+//  the triangulation beyond the star of the vertex.
 //
 
 #include "defs.h"
@@ -67,7 +70,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 void DeBerg::SelectVertices( TBTree<PTVertex>& ElimVtxTree, TDoubleList<PTVertex>& DeBergVertices )
 {
    
-    int vid;
+    TIndex vid;
 
     #ifdef DEBUG
        DEBUG << "DeBerg::SelectVertices()" << endl;
@@ -82,7 +85,7 @@ void DeBerg::SelectVertices( TBTree<PTVertex>& ElimVtxTree, TDoubleList<PTVertex
     
     TList<PTVertex> ElimVtxList;
     
-    int MaxVID = 0;
+    TIndex MaxVID = 0;
     
     while ( !ElimVtxTree.IsEmpty() )
     {
@@ -138,20 +141,19 @@ void DeBerg::SelectVertices( TBTree<PTVertex>& ElimVtxTree, TDoubleList<PTVertex
 
 // ----------------------------------------------------------------------------------------
 //
-//  static void DeBerg::MarkAllNeighbours( PTVertex V, boolean *Marked )
+//  static void DeBerg::GetNeighbours( PTVertex V, TDoubleList<PTVertex> &N )
 //
-//  Given vertex V, mark (by setting a TRUE value in the corresponging
-//  positions of array Marked[] passed as a parameter) all vertices
-//  adjacent to V (i.e., endpoints of the same edge).
+//  Append to N all vertices adjacent to V (i.e., endpoints of the same
+//  edge), in counterclockwise order.
 //
 
-void DeBerg::MarkAllNeighbours( PTVertex V, boolean *Marked, int MaxVID )
+void DeBerg::GetNeighbours( PTVertex V, TDoubleList<PTVertex> &N )
 {
 
    int i, j;
 
    #ifdef DEBUG
-     DEBUG << "DeBerg::MarkAllNeighbours( V" << V->VID << " )" << endl;
+     DEBUG << "DeBerg::GetNeighbours( V" << V->VID << " )" << endl;
    #endif
 
    //
@@ -205,13 +207,8 @@ void DeBerg::MarkAllNeighbours( PTVertex V, boolean *Marked, int MaxVID )
       // the endpoint of ENext different from V belongs to the boundary
       // of the influence region of V
       
-      PTVertex VNext = ( ENext->EV[0] != V ? ENext->EV[0] : ENext->EV[1] );
+      N.AddTail( ENext->EV[0] != V ? ENext->EV[0] : ENext->EV[1] );
 
-      // mark the vertex
-            
-      if (VNext->VID <= MaxVID)
-		Marked[ VNext->VID ] = TRUE;
-      
       // go to the next one
       
       TNext = ( ENext->EV[0] == V ? ENext->ET[0] : ENext->ET[1] );
@@ -237,3 +234,170 @@ void DeBerg::MarkAllNeighbours( PTVertex V, boolean *Marked, int MaxVID )
    // end of traversal
      
 }
+
+
+// ----------------------------------------------------------------------------------------
+//
+//  static void DeBerg::MarkAllNeighbours( PTVertex V, boolean *Marked )
+//
+//  Given vertex V, mark (by setting a TRUE value in the corresponging
+//  positions of array Marked[] passed as a parameter) all vertices
+//  adjacent to V (i.e., endpoints of the same edge).
+//
+
+void DeBerg::MarkAllNeighbours( PTVertex V, boolean *Marked, TIndex MaxVID )
+{
+   TDoubleList<PTVertex> N;
+
+   #ifdef DEBUG
+     DEBUG << "DeBerg::MarkAllNeighbours( V" << V->VID << " )" << endl;
+   #endif
+
+   GetNeighbours( V, N );
+   while( !N.IsEmpty() )
+   {
+      PTVertex VNext = N.RemoveHead();
+
+      if (VNext->VID <= MaxVID)
+		Marked[ VNext->VID ] = TRUE;
+   }
+}
+
+
+// ----------------------------------------------------------------------------------------
+//
+//  static void DeBerg::GetConflictZone( PTVertex V, boolean Extended,
+//                                       TDoubleList<PTVertex> &Z )
+//
+//  Put in Z the vertices whose star may change when V is removed from a
+//  CDT (possibly with repetitions). Besides the neighbours of V:
+//   - if V has two incident constraints, the removal inserts a new
+//     constraint between its chain neighbours V1 and V2, whose region of
+//     influence may go beyond the star of V: the neighbours of V1 and V2
+//     are added;
+//   - if Extended (extension of the optimization beyond the region of
+//     influence, see TDecCDT::ExtActive), the neighbours of all the
+//     neighbours of V are added.
+//
+
+void DeBerg::GetConflictZone( PTVertex V, boolean Extended, TDoubleList<PTVertex> &Z )
+{
+   TDoubleList<PTVertex> N;
+   PTVertex Chain[2] = { NULL, NULL };
+   int i;
+
+   if ( V->nIncConstr == 2 )
+      for( i=0; i<2; i++ )
+      {
+         PTEdge C = V->GetConstr( i );
+         Chain[i] = ( C->EV[0] != V ? C->EV[0] : C->EV[1] );
+      }
+
+   GetNeighbours( V, N );
+   while( !N.IsEmpty() )
+   {
+      PTVertex U = N.RemoveHead();
+
+      Z.AddTail( U );
+      if ( Extended || U == Chain[0] || U == Chain[1] )
+         GetNeighbours( U, Z );
+   }
+}
+
+
+// ----------------------------------------------------------------------------------------
+//
+//  static void DeBerg::SelectVerticesCDT( TBTree<PTVertex>& ElimVtxTree,
+//                                         TDoubleList<PTVertex>& DeBergVertices,
+//                                         boolean Extended, boolean Disjoint )
+//
+//  As SelectVertices, but two vertices V, W are independent only if
+//  neither of them is in the conflict zone of the other one (see
+//  GetConflictZone). Two vertices on the same chain of constraints, or
+//  whose regions of extended optimization may overlap, are then not
+//  removed in the same round.
+//  If Disjoint, the conflict zones are the extended ones, plus the
+//  vertex itself, and those of the selected vertices must not share any
+//  vertex: the stars of the selected vertices, and the triangles around
+//  them, are disjoint, and the vertices without incident constraints
+//  may be removed at the same time by different threads (see
+//  TDecRndDeBergCDT::SetThreads).
+//
+
+void DeBerg::SelectVerticesCDT( TBTree<PTVertex>& ElimVtxTree, TDoubleList<PTVertex>& DeBergVertices,
+                                boolean Extended, boolean Disjoint )
+{
+    TIndex vid;
+
+    #ifdef DEBUG
+       DEBUG << "DeBerg::SelectVerticesCDT()" << endl;
+    #endif
+
+    TList<PTVertex> ElimVtxList;
+    
+    TIndex MaxVID = 0;
+    
+    while ( !ElimVtxTree.IsEmpty() )
+    {
+       PTVertex NextV = ElimVtxTree.RemoveMax();
+       if ( NextV->VID > MaxVID ) MaxVID = NextV->VID;
+       ElimVtxList.AddHead( NextV );
+    }
+
+    // ...the conflict zones of the vertices are all marked
+    if ( Disjoint ) MaxVID = TVertex::NextVID - 1;
+       
+    //
+    // Marked[vid] is TRUE if vid is in the conflict zone of some vertex
+    // of DeBergVertices, Selected[vid] if vid is in DeBergVertices.
+    //   
+        
+    boolean *Marked = new boolean[MaxVID+1];
+    boolean *Selected = new boolean[MaxVID+1];
+    
+    check( (Marked==NULL || Selected==NULL), "DeBerg::SelectVerticesCDT(), insufficient memory");
+    
+    for( vid=0; vid<=MaxVID; vid++ )
+       Marked[vid] = Selected[vid] = FALSE;
+
+    TDoubleList<PTVertex> Z;
+    
+    while( !ElimVtxList.IsEmpty() )
+    {
+       PTVertex NextV = ElimVtxList.RemoveHead();
+       boolean Free = !Marked[ NextV->VID ];
+
+       if ( Free )
+       {
+          GetConflictZone( NextV, Extended || Disjoint, Z );
+          if ( Disjoint ) Z.AddTail( NextV );
+
+          TDoubleListIterator<PTVertex> I( &Z );
+          while( Free && !I.EndOfList() )
+          {
+             vid = I.Current()->object->VID;
+             if ( vid <= MaxVID && ( Disjoint ? Marked[vid] : Selected[vid] ) ) Free = FALSE;
+             I.GoNext();
+          }
+       }
+
+       if ( !Free )
+       {
+          ElimVtxTree.Insert( NextV );
+       }
+       else
+       {
+          while( !Z.IsEmpty() )
+          {
+             vid = Z.RemoveHead()->VID;
+             if ( vid <= MaxVID ) Marked[vid] = TRUE;
+          }
+          Selected[ NextV->VID ] = TRUE;
+          DeBergVertices.AddTail( NextV );
+       }
+       Z.ClearList();
+    }
+
+    delete[] Marked;
+    delete[] Selected;
+}
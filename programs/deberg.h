@@ -33,6 +33,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //  rispettivamente, da TDecRndDelaunay e TDecErrDelaunay.
 //  The solution of a static class avoids using multiple inheritance
 //  with all problems connected to virtual base classes etc...
+//  Function SelectVerticesCDT is a variant for the decimation of a CDT
+//  (used by TDecRndDeBergCDT), where the removal of a vertex may change
+//  the triangulation beyond the star of the vertex.
 //
 
 
@@ -50,9 +53,16 @@ class DeBerg
    
    public:
     
-      static void MarkAllNeighbours( PTVertex, boolean *, int );
+      static void GetNeighbours( PTVertex, TDoubleList<PTVertex> & );
+      static void MarkAllNeighbours( PTVertex, boolean *, TIndex );
       static void SelectVertices( TBTree<PTVertex>&, TDoubleList<PTVertex> & );
 
+      // Vertices whose star may change when V is removed from a CDT
+      // (see SelectVerticesCDT).
+      static void GetConflictZone( PTVertex V, boolean Extended, TDoubleList<PTVertex> & );
+      static void SelectVerticesCDT( TBTree<PTVertex>&, TDoubleList<PTVertex> &, boolean Extended,
+                                     boolean Disjoint = FALSE );
+
 };
 
 #endif // _DEBERG_H
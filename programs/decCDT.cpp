@@ -64,9 +64,10 @@ TDecCDT::TDecCDT( int iK, PMTTracer iMT )
    ExtActive = TRUE;
    AllowFeaturesDel = FALSE;
    AllowChainBrk    = FALSE;
+   ChainTol         = -1.0;
 
    nRemovedVertex = 0;
-	Constraints = NULL;
+   ConstrSet = NULL;
 	nConstrInFile = 0;
    nConstrInTRI = 0;
    ReadingConstr = FALSE;
@@ -88,9 +89,10 @@ TDecCDT::TDecCDT( int iK, PMTTracer iMT, boolean EXTActive, boolean ALLOWFeature
    ExtActive = EXTActive;
    AllowFeaturesDel = ALLOWFeaturesDel;
    AllowChainBrk    = ALLOWChainBrk;
+   ChainTol         = -1.0;
 
    nRemovedVertex = 0;
-	Constraints = NULL;
+   ConstrSet = NULL;
 	nConstrInFile = 0;
    nConstrInTRI = 0;
    ReadingConstr = FALSE;
@@ -123,18 +125,18 @@ boolean TDecCDT::IsNewConstrOK( PTVertex V ){
       DEBUG3 << "\nTDecCDT::IsNewConstrOK( " << *V << " )\n";
    #endif 
 
-   // find constraints incident in V
+   // constraints incident in V
 
-   TDoubleList<PTEdge> IncConstr;
-
-   int numIncConstr = FindConstraintsInVE( V, IncConstr );
+   int numIncConstr = V->nIncConstr;
 	if( numIncConstr < 2 )
 	{  cerr << "BUG: TDecCDT::IsNewConstrOK( V ), " << *V << " has less than 2 incident edges Marked( CONSTRAINED )\n"; exit( -1); }
 	if( numIncConstr > 2 )
 	{  cerr << "BUG: TDecCDT::IsNewConstrOK( V ), " << *V << " has more than 2 incident edges Marked( CONSTRAINED )\n"; exit( -1); }
 
-	PTEdge newConstr = new TEdge( Other_v_in_e( IncConstr.GetHead(), V ),
-	                              Other_v_in_e( IncConstr.GetLast(), V )   );
+	// probe for the new constraint, only used for the geometric tests
+	TSegment NewConstr( Other_v_in_e( V->GetConstr( 0 ), V ),
+	                    Other_v_in_e( V->GetConstr( 1 ), V )   );
+	PTSegment newConstr = &NewConstr;
 
    #ifdef CHIAMATE_DI_PROVA
       TDoubleList<PTEdge> Right_Border, Left_Border;
@@ -257,11 +259,13 @@ boolean TDecCDT::IsNewConstrOK( PTVertex V ){
    {
       // search among edges of currTrg for the edge 
       // properly intersecting newConstr
+      int res[3];
+      Tra_intersect( newConstr, currTrg, res );
       for( int i = 0; i < 3; i++ )
       {
          if( currTrg->TE[i] != intersectingEdg )
          {
-            if( (intersection = Tra_intersect( newConstr , currTrg->TE[i] )) )
+            if( (intersection = res[i]) )
             {
                if( intersection == PROPER_INTER  &&  ! currTrg->TE[i]->Marked( CONSTRAINED ) )
                {
@@ -355,14 +359,16 @@ void TDecCDT::CalcEdgeWideInflRegn( PTEdge E,  TDoubleList<PTTriangle> &Internal
    // current triangle and triangle opposite to the given edge of currTrg
 
    int i;
+   int res[3];  // intersection of E with the edges of currTrg
 
    while( ! InternalTrgs.IsEmpty() )
    {
       currTrg = InternalTrgs.RemoveHead();
+      Tra_intersect( E, currTrg, res );
 
       for( i = 0 ; i < 3; i++ )  // scan edges of currTrg
       {
-         if( ! Tra_intersect( E, currTrg->TE[i] ) )
+         if( ! res[i] )
          {
             currTrg->TE[i]->Mark( INFL_BORDER );
             if( Geom::Turnxy( E->EV[0], E->EV[1], currTrg->TE[i]->EV[0] ) == TURN_RIGHT )
@@ -560,7 +566,7 @@ int TDecCDT::InitCalcEdgeWideInflRegn( PTEdge E, TDoubleList<PTTriangle> &Intern
 }
 
 //
-//  Return values: see #define's at the beginning of decCDT.h
+//  Return values: see #define's in segint.h
 //  
 
 int TDecCDT::Tra_intersect( PTEdge e1, PTEdge e2 )
@@ -569,80 +575,35 @@ int TDecCDT::Tra_intersect( PTEdge e1, PTEdge e2 )
           "TDecCDT::intersect, called on NULL edge" );
    check( e1->EV[0] == e1->EV[1] || e2->EV[0] == e2->EV[1], "TDecCDT::intersect, called on degenerate edge" );
 
-  // i due edge sono coincidenti ( hanno entrambi i vertici in comune )
-   if (( e1->EV[0] == e2->EV[0] &&  e1->EV[1] == e2->EV[1] ) ||
-       ( e1->EV[0] == e2->EV[1] &&  e1->EV[1] == e2->EV[0] )  )
-         return UPON_AND_2CV;
-          
-  // if we arrive here, then e1 and e2  are NOT the same
-
-  int turn_e1_first_e2  = Geom::Turnxy( e1->EV[0], e1->EV[1], e2->EV[0] );
-  // turn from e1 to first vertex of e2
-  int turn_e1_second_e2 = Geom::Turnxy( e1->EV[0], e1->EV[1], e2->EV[1] );
-  // turn from e1 to second vertex of e2
-  int turn_e2_first_e1  = Geom::Turnxy( e2->EV[0], e2->EV[1], e1->EV[0] );
-  // turn from e2 to first vertex of e1
-  int turn_e2_second_e1 = Geom::Turnxy( e2->EV[0], e2->EV[1], e1->EV[1] );
-  // turn from e2 to second vertex of e1
-
-  // e1 and e2 are collinear (but they may not intersect)
-  if( turn_e1_first_e2 == turn_e1_second_e2  &&  turn_e1_first_e2 == ALIGNED  &&
-      turn_e2_first_e1 == turn_e2_second_e1  &&  turn_e2_first_e1 == ALIGNED )
-      // if all == ALIGNED
-  {
-   //   check( turn_e1_first_e2 != ALIGNED, "TDecCDT::Tra_intersect, BUG: logical error" );
-      
-      // the four vertices are aligned but they may not intersect
-      //  
-      if( e1->EV[0]->x == e1->EV[1]->x )
-      // aligned along y axis, use y coordinate to compare them
-      {
-         double max_y_e1 = MAX( e1->EV[0]->y , e1->EV[1]->y );
-         double min_y_e1 = MIN( e1->EV[0]->y , e1->EV[1]->y );
-         double max_y_e2 = MAX( e2->EV[0]->y , e2->EV[1]->y );
-         double min_y_e2 = MIN( e2->EV[0]->y , e2->EV[1]->y );
-
-         if( max_y_e1 < min_y_e2 )  return NO_INTER;
-         if( max_y_e1 == min_y_e2 || max_y_e2 == min_y_e1 )  return ONLY_1CV;
-         if( min_y_e1 == min_y_e2 || max_y_e1 == max_y_e2 )  return UPON_AND_1CV;
-         return  UPON_NO_CV;
-      }
-      else // NOT aligned along y axis, use x coordinate to compare them
-      {
-         double max_x_e1 = MAX( e1->EV[0]->x , e1->EV[1]->x );
-         double min_x_e1 = MIN( e1->EV[0]->x , e1->EV[1]->x );
-         double max_x_e2 = MAX( e2->EV[0]->x , e2->EV[1]->x );
-         double min_x_e2 = MIN( e2->EV[0]->x , e2->EV[1]->x );
-
-         if( max_x_e1 < min_x_e2 )  return NO_INTER;
-         if( max_x_e1 == min_x_e2 || max_x_e2 == min_x_e1 )  return ONLY_1CV;
-         if( min_x_e1 == min_x_e2 || max_x_e1 == max_x_e2 )  return UPON_AND_1CV;
-         return  UPON_NO_CV;
-      }
+   return( SegInt::Classify( e1, e2 ) );
+}
+
 
-  }
-
-  //
-  // e1 and e2 are NOT collinear
-  // 
-
-  //  e1 and e2 have only one common vertex (and are not collinear)
-   if( (e1->EV[0] == e2->EV[0]) ||   (e1->EV[1] == e2->EV[1]) ||
-       (e1->EV[0] == e2->EV[1]) ||   (e1->EV[1] == e2->EV[0])    )  return ONLY_1CV;
-
-  // vertex of one edge is inside the other edge
-  // 
-  if( ( turn_e1_first_e2  == ALIGNED  || turn_e1_second_e2 == ALIGNED ) && turn_e2_first_e1  != turn_e2_second_e1 )
-     return NOT_PROPER;
-  if( ( turn_e2_first_e1  == ALIGNED  || turn_e2_second_e1 == ALIGNED ) && turn_e1_first_e2  != turn_e1_second_e2 )
-     return NOT_PROPER;
-
-  // now either intersection is proper (interior of e1 intersects 
-  // interior of e2), or there is no intersection
-  if( turn_e1_first_e2  != turn_e1_second_e2 && turn_e2_first_e1  != turn_e2_second_e1 )
-     return PROPER_INTER;
-  else
-     return NO_INTER;
+int TDecCDT::Tra_intersect( PTSegment s1, PTEdge e2 )
+{
+   check( s1 == NULL || e2 == NULL || s1->EV[0] == NULL || s1->EV[1] == NULL ||
+          ! Is_EV_Defined( e2 ), "TDecCDT::intersect, called on NULL edge" );
+   check( s1->EV[0] == s1->EV[1] || e2->EV[0] == e2->EV[1], "TDecCDT::intersect, called on degenerate edge" );
+
+   return( SegInt::Classify( s1, e2 ) );
+}
+
+
+int TDecCDT::Tra_intersect( PTEdge E, PTTriangle T, int *Res )
+{
+   check( E == NULL || ! Is_EV_Defined( E ) || E->EV[0] == E->EV[1],
+          "TDecCDT::intersect, called on NULL or degenerate edge" );
+
+   return( SegInt::Classify( E, T->TE, 3, Res ) );
+}
+
+
+int TDecCDT::Tra_intersect( PTSegment S, PTTriangle T, int *Res )
+{
+   check( S == NULL || S->EV[0] == NULL || S->EV[1] == NULL || S->EV[0] == S->EV[1],
+          "TDecCDT::intersect, called on NULL or degenerate edge" );
+
+   return( SegInt::Classify( S, T->TE, 3, Res ) );
 }
 
 // Used inside function Tra_intersect
@@ -689,19 +650,13 @@ void TDecCDT::DetachEdge( PTEdge E )
    
    if( E->Marked( CONSTRAINED ) )
    {
+      MT->KillConstraint( E );
       nConstrInTRI--;
       check(nConstrInTRI < 0, "TDecCDT::DetachEdge < nConstrInTRI < 0 >");
       for (int v=0; v<2; v++ )
-      {
-         E->EV[v]->nIncConstr--;
-         check(E->EV[v]->nIncConstr < 0, "TDecCDT::DetachEdge < nIncConstr < 0 >");
-      }
+         E->EV[v]->RemoveConstr( E );
 		E->UnMark(CONSTRAINED);  // added again
-		#ifdef array_Constraints
-		   for( int c = 0; c < nConstrInFile; c++ )
-		   	if( Constraints[c] == E )
-		   	   { Constraints[c] = NULL; break; }
-		#endif
+      if ( ConstrSet ) ConstrSet->Remove( E );
    }
    TDecimDelaunay::DetachEdge(E);
 }
@@ -731,28 +686,25 @@ void TDecCDT::RemoveVertex()
       PTEdge OldConstr1 = NULL,  // incident constraints in VertexToRemove
              OldConstr2 = NULL;
 
-      TDoubleList<PTEdge> IncConstrL;
-      // list of constraint edges incident in VertexToRemove
-
       if( nIncConstr == 2 ) 
       // first add new constraint, then re-triangulate region of influence
       // of VertexToRemove.
       {
          PTVertex NewConstrVtx[2];      // vertices of new constraint
-         FindConstraintsInVE( VertexToRemove, IncConstrL );
-
-		   #ifdef ROBUST
-			   check( IncConstrL.Lenght() != 2, "TDecCDT::RemoveVertex(), <a> " );
-		   #endif
+         PTEdge NewConstr;
+         double Dev = ChainDeviation( VertexToRemove );
 
-         OldConstr1 = IncConstrL.RemoveHead();
-         OldConstr2 = IncConstrL.RemoveLast();
+         OldConstr1 = VertexToRemove->GetConstr( 0 );
+         OldConstr2 = VertexToRemove->GetConstr( 1 );
 
          NewConstrVtx[0] = Other_v_in_e( OldConstr1, VertexToRemove );
          NewConstrVtx[1] = Other_v_in_e( OldConstr2, VertexToRemove );
          // Add_Constraint( NewConstrVtx[0], NewConstrVtx[1] );
          // Tra_Add_Constraint( NewConstrVtx[0], NewConstrVtx[1] );
-         TTra_Add_Constraint( NewConstrVtx[0], NewConstrVtx[1] );
+         NewConstr = TTra_Add_Constraint( NewConstrVtx[0], NewConstrVtx[1] );
+
+         // the new constraint replaces also the chain of the old ones
+         if ( Dev > NewConstr->Error ) NewConstr->Error = Dev;
       }
       // TDecimDelaunay::RemoveVertex(); 
       // by now call original version that does not extend optimization
@@ -766,23 +718,15 @@ void TDecCDT::RemoveVertex()
       else
       {
          if( nIncConstr == 1 )
-         {
-            FindConstraintsInVE( VertexToRemove, IncConstrL );
-
-		      #ifdef ROBUST
-			      check( IncConstrL.Lenght() != 1, "TDecCDT::RemoveVertex(), <b> " );
-		      #endif
-
-            OldConstr1 = IncConstrL.RemoveHead();
-         }
+            OldConstr1 = VertexToRemove->GetConstr( 0 );
 
          // Version with extension of optimization beyond the region
          // of influence of VertexToRemove
          //
          boolean closed = CalcInfluenceRegion();
-         ExtRIRIPrepare( SwapEdgeQueue, OldConstr1, OldConstr2, closed, OrigEdgList );
+         ExtRIRIPrepare( SwapEdgeQueue, OldConstr1, OldConstr2, closed, OrigET );
          ExtRIRInitialTrg( InflRegnBorder, SwapEdgeQueue );
-         ExtRIRDelOptTrg( SwapEdgeQueue, OrigEdgList );
+         ExtRIRDelOptTrg( SwapEdgeQueue, OrigET );
          ExtDeleteInfluenceRegion ( InflRegnBorder );
       }
    }
@@ -793,13 +737,93 @@ void TDecCDT::RemoveVertex()
 }
 
 
+//
+// Save / load the state of the decimation on a checkpoint. The input
+// file, and so nConstrInFile, is read again before resuming. ConstrSet,
+// if present, is rebuilt from the constraints of the vertices.
+//
+
+void TDecCDT::SaveState( RTCheckpoint C )
+{
+   TDecimDelaunay::SaveState( C );
+
+   C.PutIndex( nRemovedVertex );
+   C.PutIndex( nConstrInTRI );
+
+   C.PutIndex( RemovedVertexIndex.Lenght() );
+   TDoubleListIterator<TIndex> I( &RemovedVertexIndex );
+   while( !I.EndOfList() )
+   {
+      C.PutIndex( I.Current()->object );
+      I.GoNext();
+   }
+}
+
+
+void TDecCDT::LoadState( RTCheckpoint C )
+{
+   TIndex i, n;
+
+   TDecimDelaunay::LoadState( C );
+
+   nRemovedVertex = C.GetIndex();
+   nConstrInTRI = C.GetIndex();
+
+   RemovedVertexIndex.ClearList();
+   n = C.GetIndex();
+   for( i=0; i<n; i++ )
+      RemovedVertexIndex.AddTail( C.GetIndex() );
+
+   if ( ConstrSet )
+   {
+      // ...each constraint once, from its first vertex
+      ConstrSet->Clear();
+      for( i=0; i<nPts; i++ )
+      {
+         PTVertex V = (PTVertex)(Points[i]);
+
+         if ( V->VE[0] == NULL ) continue;
+         for( int k=0; k<V->nIncConstr; k++ )
+            if ( V->GetConstr( k )->EV[0] == V )
+               ConstrSet->Add( V->GetConstr( k ) );
+      }
+      check( ConstrSet->Count() != nConstrInTRI,
+             "TDecCDT::LoadState(), constraints inconsistency detected" );
+   }
+}
+
+
+//
+// Select how constraints are stored: CONSTR_MARKS (only CONSTRAINED
+// marks on edges) or CONSTR_SET (also a TConstraintSet). It must be
+// called before the triangulation is built.
+//
+
+void TDecCDT::SetConstraintStorage( int mode )
+{
+   switch( mode )
+   {
+      case CONSTR_MARKS:
+         if ( ConstrSet ) delete ConstrSet;
+         ConstrSet = NULL;
+         break;
+      case CONSTR_SET:
+         if ( ConstrSet == NULL ) ConstrSet = new TConstraintSet();
+         check( (ConstrSet == NULL), "TDecCDT::SetConstraintStorage(), insufficient memory" );
+         break;
+      default:
+         error( "TDecCDT::SetConstraintStorage(), unknown storage mode" );
+   }
+}
+
+
 
 
 //
 // Re-implemented to read the constraints.
 //
 // Call ReadConstraints that marks CONSTRAINED the constraint edges 
-// and fills array Constraints with pointers to them.
+// and adds them to ConstrSet, if present.
 
 void TDecCDT::ReadData( const char *infname )
 {
@@ -821,27 +845,29 @@ void TDecCDT::ReadData( const char *infname )
 	ReadConstraints( inFile );
 
 	inFile.close();
+
+   ReorderInput();
 }
 
 //
 // Read constraints from inout file.
 //
-// For each constraint:
+// All the constraints are read first, and their endpoints are checked
+// in bulk before the triangulation is touched. Then, for each constraint:
 //   - mark it as CONSTRAINED
 //   - increment by one variable nIncConstr of the two endpoint vertices
 //     of the constraint
+//   - add it to ConstrSet, if constraints are stored in a set
 // Accept also files with degenerate constraints (with two equal endpoints)
 // or constraints that do not correspond to any edge of the input
 // triangulation.
-// If macro array_Constraints is defined, then allocate and fills array
-// Constraints with pointers to the constraint edges.
 //
 
 void TDecCDT::ReadConstraints( ifstream & inFile ) {
 
    ReadingConstr = TRUE;
 	
-	int i;
+	TIndex i;
 
    #ifdef DEBUG3
        DEBUG3 << "\nTDecCDT::ReadConstraints()" << endl;
@@ -857,72 +883,63 @@ void TDecCDT::ReadConstraints( ifstream & inFile ) {
 
    check( (nConstrInFile < 0), "input with less than 0 constraints" );
 
-   #ifdef array_Constraints   
-      Constraints = new PTEdge[nConstrInFile];
-   
-      check( (Constraints == NULL), "TDecCDT::ReadConstraints(), insufficient memory" );
-   #endif
-   
    //
-   // read constraints, and put pointers to them in array Constraints
+   // read all constraints (indices of their two vertices), and check
+   // that their endpoints exist
    //
 
-   PTEdge TmpE = new TEdge( NULL, NULL );  // current constraint
+   TIndex *vidx = new TIndex[ 2*nConstrInFile + 1 ];
 
-   check( ( TmpE == NULL), "TDecCDT::ReadConstraints(), insufficient memory" );
+   check( (vidx == NULL), "TDecCDT::ReadConstraints(), insufficient memory" );
 
-   PTEdge matchingE;  // pointer to corresponding edge 
+   for( i=0; i<nConstrInFile; i++ )
+   {
+      check( (inFile.eof()), "TDecCDT::ReadConstraints(), unexpected End Of File");
+      inFile >> vidx[2*i] >> vidx[2*i+1];
+   }
+   check( (!inFile), "TDecCDT::ReadConstraints(), bad constraint in input file" );
+
+   for( i=0; i<2*nConstrInFile; i++ )
+      check( (vidx[i] < 0 || vidx[i] >= nPts),
+             "TDecCDT::ReadConstraints(), constraint endpoint out of range" );
 
-   int vidx[2]; // indices (VID) of vertices of this constraint
+   if ( ConstrSet ) ConstrSet->Clear();
+
+   //
+   // match constraints with edges of the triangulation
+   //
+
+   PTEdge matchingE;  // pointer to corresponding edge 
 
    nConstrInTRI = nConstrInFile;
 
-   int nNotExistingConstr = 0;  
+   TIndex nNotExistingConstr = 0;  
    // number of input  constraints that do not correspond to
    // any edge of the triangulation
 
-   int nDuplicatedConstr = 0;   // number of duplicated constraints
-   int nDegenerateConstr = 0;   // number of degenerate constraints
+   TIndex nDuplicatedConstr = 0;   // number of duplicated constraints
+   TIndex nDegenerateConstr = 0;   // number of degenerate constraints
 
    for( i=0; i<nConstrInFile; i++ )
    {
-      
-      check( (inFile.eof()), "TDecCDT::ReadConstraints(), unexpected End Of File");
-  
-      //
-      // read edge (indices of its two vertices)
-      //
-       
-      inFile >> vidx[0] >> vidx[1];
-
       // the two vertices may teh the same (degenerate constraint)
 
-      if( vidx[0] == vidx[1] )
+      if( vidx[2*i] == vidx[2*i+1] )
       {
          nConstrInTRI--;
          check(nConstrInTRI < 0, "TDecCDT::FindConstraintInVE: nConstrInTRI < 0  while reading input file!?!?!");
          nDegenerateConstr++;
 
-         #ifdef array_Constraints
-            Constraints[i] = NULL;
-         #endif
-
          if ( nDegenerateConstr < 7 )
             cerr << "\nWARNING: constraint C" << i << "( "
-                 << vidx[0] << ", " << vidx[1] << " ) is degenerate\n";
+                 << vidx[2*i] << ", " << vidx[2*i+1] << " ) is degenerate\n";
          else if ( nDegenerateConstr == 7 )
             cerr << "\nWARNING: other degenerate constraints read\n";
          continue;
       }
 
-		TmpE->EV[0] = (PTVertex) (Points[vidx[0]]);
-      TmpE->EV[1] = (PTVertex) (Points[vidx[1]]);
-
-      matchingE = FindConstraintInVE( (PTVertex) (Points[vidx[0]]) , TmpE );
-
-      #ifdef array_Constraints
-         Constraints[i] = matchingE;
-      #endif
+      matchingE = FindConstraintInVE( (PTVertex) (Points[vidx[2*i]]),
+                                      (PTVertex) (Points[vidx[2*i+1]]) );
 
       if( matchingE == NULL )
       {
@@ -932,13 +949,10 @@ void TDecCDT::ReadConstraints( ifstream & inFile ) {
       }
       else
 	   {
-         if( matchingE->Marked( CONSTRAINED ) )
+         if( ConstrSet ? ConstrSet->Contains( matchingE ) : matchingE->Marked( CONSTRAINED ) )
          {  
             nDuplicatedConstr++;
             nConstrInTRI--;
-            #ifdef array_Constraints
-               Constraints[i] = NULL;
-            #endif
             check(nConstrInTRI < 0, "TDecCDT::FindConstraintInVE: nConstrInTRI < 0  while reading input file!?!?!");
          }
          else
@@ -946,19 +960,21 @@ void TDecCDT::ReadConstraints( ifstream & inFile ) {
    	    matchingE->Mark( CONSTRAINED );
             // increment number of constraint incident in the two endpoints
             // of the constraint
-            matchingE->EV[0]->nIncConstr++;  
-	    matchingE->EV[1]->nIncConstr++;  
+            matchingE->EV[0]->AddConstr( matchingE );
+	    matchingE->EV[1]->AddConstr( matchingE );
+            if ( ConstrSet ) ConstrSet->Add( matchingE );
          }
-     	}    
-		 
 
-       #ifdef DEBUG4
-        DEBUG4 << "TDecCDT::ReadConstraints: read constraint " << *Constraints[i] << endl;
-       #endif
+         #ifdef DEBUG4
+          DEBUG4 << "TDecCDT::ReadConstraints: read constraint " << *matchingE << endl;
+         #endif
+     	}    
               
        if ( i % 1000 == 0 ) cerr << "\rread " << i << " constraints" << flush;
        
    }
+
+   delete[] vidx;
    
     cerr << "\rread " << nConstrInFile << " constraints:\n      " <<
             nNotExistingConstr << " do not match with any edge\n      " <<
@@ -1094,17 +1110,33 @@ int TDecCDT::FindEdgesInVE( PTVertex V, PTEdge filter, TDoubleList<PTEdge> & fil
 
 int TDecCDT::FindEdgesInVE( PTVertex V, PTEdge filter, TDoubleList<PTEdge> & filtered) {
 
+   PTEdge Match;
 
-   #ifdef DEBUG3
-     DEBUG3 << "\nTDecCDT::FindEdgesInVE( " << *V << " , " << *filter << " )\n";
-   #endif
-   
 	#ifdef ROBUST
 		check( ! filtered.IsEmpty() , "TDecCDT::FindEdgesInVE, called on non empty list!" );
 	#endif
 
+   return MatchEdgesInVE( V, filter, &filtered, Match );
+}
+
+
+//
+// Walk around V and count the edges that match with filter; put them in
+// list filtered, if not NULL, and the last one in Match.
+//
+
+int TDecCDT::MatchEdgesInVE( PTVertex V, PTEdge filter, TDoubleList<PTEdge> *filtered,
+                             PTEdge & Match ) {
+
+
+   #ifdef DEBUG3
+     DEBUG3 << "\nTDecCDT::FindEdgesInVE( " << *V << " , " << *filter << " )\n";
+   #endif
+
    int i, j, nMatches = 0;
 
+   Match = NULL;
+
    PTTriangle TFirst;
    
    PTEdge   EFirst = V->VE[0];
@@ -1167,7 +1199,8 @@ int TDecCDT::FindEdgesInVE( PTVertex V, PTEdge filter, TDoubleList<PTEdge> & fil
       if( ENext->Match( filter ) )
       // matching found among the edges incident in V
       {
-	 filtered.AddTail( ENext );
+	 if ( filtered != NULL ) filtered->AddTail( ENext );
+         Match = ENext;
          nMatches++;
       }
       
@@ -1192,18 +1225,15 @@ int TDecCDT::FindEdgesInVE( PTVertex V, PTEdge filter, TDoubleList<PTEdge> & fil
            
    } while ( TNext != NULL && ENext != EFirst );
 
-   #ifdef ROBUST
-      check( nMatches != filtered.Lenght(), "TDecCDT::FindConstraintInVE(), BUG nella funzione");
-   #endif
-
    return nMatches;
 }
 
 
 
 //
-// Search among the edges incident in V the ones that are constraints,
-// return in IncConstr a list of such edges and return their number.
+// Return in IncConstr a list of the constraints incident in V, and
+// their number. They are kept in V (see TVertex::AddConstr), so that
+// no search is needed.
 //
 
 int TDecCDT::FindConstraintsInVE( PTVertex V, TDoubleList<PTEdge> & IncConstr) {
@@ -1216,80 +1246,77 @@ int TDecCDT::FindConstraintsInVE( PTVertex V, TDoubleList<PTEdge> & IncConstr) {
 		check( ! IncConstr.IsEmpty() , "TDecCDT::FindConstraintsInVE, <a> inconsistency detected!" );
 	#endif
 
-   PTEdge matchConstr = new TEdge();
-   matchConstr->Mark( CONSTRAINED );
-   return FindEdgesInVE( V, matchConstr, IncConstr);
-   // return FindEdgesInVE( V, matchConstr, IncConstr, EqualsMarkConstrained);
+   for( int i=0; i<V->nIncConstr; i++ )
+      IncConstr.AddTail( V->GetConstr( i ) );
+   return V->nIncConstr;
+}
+
+//
+// Walk around V and return the edge of endpoints V and W, NULL if
+// there is none.
+//
+
+PTEdge TDecCDT::EdgeInVE( PTVertex V, PTVertex W )
+{
+   PTEdge EFirst = FirstEdgeInVE( V );
+   PTEdge E = EFirst;
+
+   do
+   {
+      if( Other_v_in_e( E, V ) == W ) return E;
+      E = Next_CCW_e_of_e_by_v( E, V );
+   } while ( E != NULL && E != EFirst );
+
+   return NULL;
 }
 
+
 //
-// Search among the edges incident in V one edge formed by the same
-// vertices as Edge2find; if found, return a pointer to such edge,
+// Search among the edges incident in V the edge of endpoints V and W;
+// if found, mark it as CONSTRAINED and return a pointer to it,
 // otherwise return NULL.
 //
 
-PTEdge TDecCDT::FindEdgeInVE( PTVertex V, PTEdge Edge2find ) {
+PTEdge TDecCDT::FindEdgeInVE( PTVertex V, PTVertex W ) {
 
    #ifdef DEBUG3
-     DEBUG3 << "\nTDecCDT::FindEdgeInVE( V" << V->VID << ", " << *Edge2find << " )" << endl;
+     DEBUG3 << "\nTDecCDT::FindEdgeInVE( V" << V->VID << ", V" << W->VID << " )" << endl;
    #endif
 
-   TDoubleList<PTEdge> MatchList;
-   int nMatches = FindEdgesInVE( V, Edge2find, MatchList );
-//   int nMatches = FindEdgesInVE( V, Edge2find, MatchList, EqualsEV );
-   if( nMatches > 1 )
-      error("TDecCDT::FindEdgeInVE, inconsistency: more than one matching edge!\n");
-   
-   if( nMatches == 1 )
-   {
-      PTEdge MatchingEdge = MatchList.GetHead();
-      MatchingEdge->Mark( CONSTRAINED );
-      return MatchingEdge;
-   }
+   PTEdge MatchingEdge = EdgeInVE( V, W );
 
-   if( nMatches == 0 )
-      return NULL;
-   else
-      error("TDecCDT::FindConstraintInVE, BUG: error in function\n");
-      
-   return NULL; // must return something
+   if( MatchingEdge != NULL )
+      MatchingEdge->Mark( CONSTRAINED );
+   return MatchingEdge;
 }
 
 
 //
-// Search among the edges incident in V one edge formed by the same
-// vertices as constr; if found, return a pointer to such edge,
-// otherwise return NULL.
+// Search among the edges incident in V the edge of endpoints V and W;
+// if found, return a pointer to such edge, otherwise return NULL.
 // Similar to TDecErrDelaunay::RecalVertexErrorApprox()
 //
 
-PTEdge TDecCDT::FindConstraintInVE( PTVertex V, PTEdge constr )
+PTEdge TDecCDT::FindConstraintInVE( PTVertex V, PTVertex W )
 {
 
    #ifdef DEBUG3
-     DEBUG3 << "\nTDecCDT::FindConstraintInVE( V" << V->VID << ", " << *constr << " )" << endl;
+     DEBUG3 << "\nTDecCDT::FindConstraintInVE( V" << V->VID << ", V" << W->VID << " )" << endl;
    #endif
 
-   TDoubleList<PTEdge> MatchList;
-   int nMatches = FindEdgesInVE( V, constr, MatchList );
-//   int nMatches = FindEdgesInVE( V, constr, MatchList, EqualsEV );
-   if( nMatches > 1 )
-      error("TDecCDT::FindConstraintInVE, inconsistency: more than one matching edge!\n");
-   
-   if( nMatches == 1 )
-   {
-      PTEdge MatchingEdge = MatchList.GetHead();
+   PTEdge MatchingEdge = EdgeInVE( V, W );
+
+   if( MatchingEdge != NULL )
       return MatchingEdge;
-   }
 
    // if we arrive here then we have not found "constr" among the edges
    // incident in V, thus such constraint is not present in the
    // triangulation
-   if( nMatches == 0  && ReadingConstr )
+   if( ReadingConstr )
    {
       if ( (nConstrInFile - nConstrInTRI) < 7 )
-         cerr << "\nWARNING: constraint " << constr->EV[0]->VID << " "
-              << constr->EV[1]->VID << " does not match with any edge\n";
+         cerr << "\nWARNING: constraint " << V->VID << " "
+              << W->VID << " does not match with any edge\n";
       else if ( (nConstrInFile - nConstrInTRI) == 7 )
          cerr << "\nWARNING: other constraints do not match with any edge\n";
       return NULL;
@@ -1307,55 +1334,81 @@ boolean TDecCDT::EqualsEV( PTEdge e1, PTEdge e2 ) {
 		       ( e1->EV[0] == e2->EV[1] && e1->EV[1] == e2->EV[0] )     );
 }
 
+boolean TDecCDT::EqualsEV( PTSegment S, PTEdge e ) {
+	return (  ( S->EV[0] == e->EV[0] && S->EV[1] == e->EV[1] ) || 
+		       ( S->EV[0] == e->EV[1] && S->EV[1] == e->EV[0] )     );
+}
+
 
 // --------------------------------------------------------------------------------
-//  
-//  void TDecCDT::WriteConstraints( const char * )
 //
-//  Save to file the constraint edges of the final CDT.
-//  
-//  Called by TDecCDT::WriteData1 and, unlike TDecCDT::WriteData2,
-//  it uses array Constraints.
+//  TIndex TDecCDT::ListConstraints( PTEdge * )
+//
+//  Put in array E the constraints of ConstrSet, without visiting the
+//  triangulation, and return their number. Since the order of the set
+//  depends on the history of the updates, they are sorted on the VIDs
+//  of their endpoints (the lower one first): VIDs must be final, i.e.,
+//  renumbered and reordered for output.
 //
 
-#include <stdio.h>
-#include <stdlib.h>  // for perror
-#include <string.h>  // fpr strerror
-#ifdef CC_GCC
-   #include <errno.h>
-#endif
+// Lexicographic order on the lower and the higher VID of two constraints.
+static int cmp_constr( const void *p, const void *q )
+{
+  PTEdge a = *(PTEdge *) p;
+  PTEdge b = *(PTEdge *) q;
+  TIndex min_a, min_b, max_a, max_b;
+  if ( a->EV[0]->VID < a->EV[1]->VID ) { min_a = a->EV[0]->VID; max_a = a->EV[1]->VID; }
+  else { min_a = a->EV[1]->VID; max_a = a->EV[0]->VID; }
+  if ( b->EV[0]->VID < b->EV[1]->VID ) { min_b = b->EV[0]->VID; max_b = b->EV[1]->VID; }
+  else { min_b = b->EV[1]->VID; max_b = b->EV[0]->VID; }
+  if ( min_a > min_b ) return 1;
+  if ( min_a < min_b ) return -1;
+  if ( max_a > max_b ) return 1;
+  if ( max_a < max_b ) return -1;
+  return 0;
+}
 
-void TDecCDT::WriteConstraints( const char *outfname  ) 
+TIndex TDecCDT::ListConstraints( PTEdge *E )
 {
+   TIndex ie, n = ConstrSet->Count();
 
-	#define ios_base ios  // for compatibility VC5, GCC (non standard C++)
+   check( n > nConstrInTRI, "TDecCDT::ListConstraints(), inconsistency detected" );
 
-	#ifdef DEBUG3 
-		DEBUG3 << "\nTDecCDT::WriteConstraints(" << outfname << ")\n";
-	#endif
+   for( ie=0; ie<n; ie++ ) E[ie] = ConstrSet->Get( ie );
+   qsort( E, n, sizeof(PTEdge), cmp_constr );
+   return( n );
+}
 
-	ofstream outFile( outfname, ios_base::app );
 
-	if( ! outFile )
-	{
-		fprintf( stderr, "TDecCDT::WriteConstraints(), <0> cannot open output file %s\n", outfname );
-//		fprintf( stderr, "strerror says open failed: %s\n", strerror( errno ) );
-	}
-	check( !outFile, "" );
+// --------------------------------------------------------------------------------
+//  
+//  void TDecCDT::WriteConstraints( ofstream &, PTEdge * )
+//
+//  Save to outFile the constraint edges of the final CDT, i.e., the ones
+//  in array E: filled by the visit of WriteData and marked VISITED, or
+//  listed from ConstrSet by ListConstraints if constraints are stored
+//  in a set.
+//
 
-	outFile << nConstrInTRI << endl;;
+void TDecCDT::WriteConstraints( ofstream &outFile, PTEdge *E ) 
+{
+   TIndex ie;
+   PTEdge CE;
 
-	int e;
-	for( e = 0; e < nConstrInFile; e++ ) {
-		if(Constraints[e] != NULL)
-		  outFile << Constraints[e]->EV[0]->VID << '\t' << Constraints[e]->EV[1]->VID << endl;
+   outFile << nConstrInTRI << endl;
 
-		if( e % 1000 == 0) cerr << "output " << e << " constraints\r";
-	}
+   for( ie=0; ie<nConstrInTRI; ie++ )
+   {
+      CE = E[ie];
+      CE->UnMark( VISITED ); // smarchiamo i lati
 
-    cerr << "output " << nConstrInTRI << " constraints of " << nConstrInFile << "\n";
+      outFile << CE->EV[0]->VID << '\t' << CE->EV[1]->VID << endl;
+       
+      if ( ie % 1000 == 0 ) cerr << "output " << ie << " constraints\r";
+   }
 
-};
+   cerr << "output " << nConstrInTRI << " constraints of " << nConstrInFile << "\n";
+}
 
 
 
@@ -1366,15 +1419,15 @@ void TDecCDT::WriteConstraints( const char *outfname  )
 //  Similar to TDecimDelaunay::WriteData but use array Points and manage
 //  constraints. Save final CDT to file, including constraint edges.
 //  
-//  Version of TDecCDT::WriteData that does NOT use array Constraints but
-//  uses CONSTRAINED marks on edges of the triangulation.
+//  If constraints are not stored in a set, they are collected by the
+//  visit from the CONSTRAINED marks on edges of the triangulation;
+//  otherwise they are listed from the set, in the order of
+//  ListConstraints.
 //
 
-#ifndef array_Constraints
-
 void TDecCDT::WriteData( const char *outfname )
 {
-    int iv, it, ie, i;
+    TIndex iv, it, ie, i;
 
      #ifdef DEBUG
       DEBUG << "\nTTriangulation::WriteData(" << outfname << ")" << endl;
@@ -1385,7 +1438,7 @@ void TDecCDT::WriteData( const char *outfname )
     //
     
     // PAOLA: number of really existing vertices
-    int nVrt = 0;
+    TIndex nVrt = 0;
 
     PTVertex *VtxArray;   
     PTTriangle *TrgArray;
@@ -1455,7 +1508,8 @@ cerr << "TDecCDT::WriteData: nPts=" << nPts <<
        int i;
        for( i=0; i<3; i++ )
        {
-          if( ! CurTrg->TE[i]->Marked( VISITED ) && CurTrg->TE[i]->Marked( CONSTRAINED )) // ogni edge e' comune a due triangoli quindi
+          if( ConstrSet == NULL &&
+              ! CurTrg->TE[i]->Marked( VISITED ) && CurTrg->TE[i]->Marked( CONSTRAINED )) // ogni edge e' comune a due triangoli quindi
           { // it may have been already visited
             #ifdef ROBUST
                check( ie >= nConstrInTRI, "TDecCDT::WriteData2(), constraints inconsistency detected" );
@@ -1494,6 +1548,7 @@ cerr << "TDecCDT::WriteData: nPts=" << nPts <<
        } // end ...for(i=0..2)
             
     } // end ...while( !Triangles.IsEmpty() )
+
      
 cerr << "True " << it << " triangles" << endl;
 cerr << "True " << iv << " vertices" << endl;
@@ -1510,7 +1565,7 @@ cerr << "True " << ie << " constraints" << endl;
     // The number of non-NULL vertices must be equal to iv.
     // 
     nVrt = iv;
-    {  int new_vid = 0;
+    {  TIndex new_vid = 0;
        for ( iv=0; iv<nPts; iv++ )
        {
          if (VtxArray[iv]) VtxArray[iv]->VID = new_vid++;
@@ -1519,6 +1574,10 @@ cerr << "True " << ie << " constraints" << endl;
               "TTriangulation::WriteData(), error in vertex number");
     }
 
+    ReorderOutput( VtxArray, nVrt, TrgArray, nTrg );
+
+    if ( ConstrSet ) ie = ListConstraints( EdgArray );
+
     // PAOLA: now we can simply print the non-NULL vertices.
     // Renumbering of VIDs guarantees that, when we print triangles,
     // vertex indices (which are VIDs) refer existing vertices.
@@ -1566,27 +1625,13 @@ cerr << "True " << ie << " constraints" << endl;
     //
     check( ie != nConstrInTRI, "TDecCDT::WiteData2(), <3> inconsistency detected");
 
-    outFile << nConstrInTRI << endl;
-
-    for( ie=0; ie<nConstrInTRI; ie++ )
-    {
-       int vIndx[2];
-
-       vIndx[0] = EdgArray[ie]->EV[0]->VID;
-       vIndx[1] = EdgArray[ie]->EV[1]->VID;
-
-       outFile << vIndx[0] << '\t' << vIndx[1] << endl;
-       
-       if ( ie % 1000 == 0 ) cerr << "output " << ie << " triangles\r";
-       EdgArray[ie]->UnMark( VISITED ); // smarchiamo i lati
-    }
-    
-    cerr << "output " << nConstrInTRI << " constraints of " << nConstrInFile << "\n";       
+    WriteConstraints( outFile, EdgArray );
     
     outFile.close();
+
+    WritePermutation( outfname, VtxArray, nVrt );
     
 }
-#endif
 
 
 //
@@ -1606,16 +1651,6 @@ void TDecCDT::Tra_Add_Constraint( PTVertex v0, PTVertex v1 )
       DEBUG8 << "TDecCDT::Tra_Add_Constraint( V" << v0->VID << " , V" << v1->VID << " )\n";
    #endif 
 
-   // new constraint to be inserted
-   #ifdef _GC_ON
-	  PTEdge newConstr = GC::NewEdge( v0, v1 );
-	#else
-	  PTEdge newConstr = new TEdge( v0, v1 );
-	#endif // _GC_ON
-
-	check( (newConstr == NULL ),"TDecCDT::Tra_Add_Constraint , insufficient memory" );
-
-
    TDoubleList<PTEdge> Right_Border, Left_Border; 
    // right and left border w.r.t. the edge directed from v0 to v1
 
@@ -1625,21 +1660,17 @@ void TDecCDT::Tra_Add_Constraint( PTVertex v0, PTVertex v1 )
    // (function CalcEdgInflRegn marks it when it finds it)
    //
 
-   PTEdge origEdg;
+   PTEdge newConstr;  // new constraint, or the edge already existing
 
-   boolean constructed_borders = CalcEdgInflRegn( newConstr, Right_Border, Left_Border, origEdg );
+   boolean constructed_borders = CalcEdgInflRegn( v0, v1, Right_Border, Left_Border, newConstr );
 
    if( ! constructed_borders )
    {
       newConstr->Mark(CONSTRAINED);
-      v0->nIncConstr++;
-      v1->nIncConstr++;
+      v0->AddConstr( newConstr );
+      v1->AddConstr( newConstr );
       nConstrInTRI++;
-      #ifdef array_Constraints
-         for( int c = 0; c < nConstrInFile; c++ )
-		      if( Constraints[c] == NULL )
-	         { Constraints[c] = newConstr; break; }
-		#endif
+      if ( ConstrSet ) ConstrSet->Add( newConstr );
 		
       return;
    }
@@ -1667,21 +1698,15 @@ void TDecCDT::Tra_Add_Constraint( PTVertex v0, PTVertex v1 )
    // RetriangulateInfluenceRegion( TRUE, Left_Border );
 
    newConstr->Mark(CONSTRAINED);
-	v0->nIncConstr++;
-   v1->nIncConstr++;
+	v0->AddConstr( newConstr );
+   v1->AddConstr( newConstr );
    nConstrInTRI++;  
-   #ifdef array_Constraints
-		for( int c = 0; c < nConstrInFile; c++ )
-		   if( Constraints[c] == NULL )
-		      { Constraints[c] = newConstr; break; }
-	#endif
+   if ( ConstrSet ) ConstrSet->Add( newConstr );
 
    #ifdef ROBUST
-		PTEdge ConstrEdge = new TEdge( v0, v1 );
-                // do not use new_e because maybe already deleted
-      
-      PTEdge tmpE1 = FindEdgeInVE( v0, ConstrEdge );  // crash if not found
-      PTEdge tmpE2 = FindEdgeInVE( v1, ConstrEdge );  // crash if not found
+      // do not use newConstr because maybe already deleted
+      PTEdge tmpE1 = FindEdgeInVE( v0, v1 );  // crash if not found
+      PTEdge tmpE2 = FindEdgeInVE( v1, v0 );  // crash if not found
       check( tmpE1 != tmpE2, "TDecCDT::Tra_Add_Constraint(), <tmpE1 != tmpE2>");
       check( ! tmpE1->Marked( CONSTRAINED ), "TDecCDT::Tra_Add_Constraint(), <! tmpE1->Marked( CONSTRAINED )>");
       TDoubleList<PTEdge> ConstrList;
@@ -1695,15 +1720,19 @@ void TDecCDT::Tra_Add_Constraint( PTVertex v0, PTVertex v1 )
 
 // -----------------------------------------------------------------------------
 //  
-//   int TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleLisr<PTEdge> Right_Border,
-//                                                   TDoubleLisr<PTEdge> Left_Border )
+//   int TDecCDT::CalcEdgInflRegn( PTVertex v0, PTVertex v1,
+//                                 TDoubleLisr<PTEdge> Right_Border,
+//                                 TDoubleLisr<PTEdge> Left_Border, PTEdge &Edg )
 //
-//   Compute region of influence of new constraint to be inserted into the
-//   current triangulation, i.e., the lists of boundary edges of the two
-//   regions to the right and to the left of newConstr. Such lists will
-//   contain the edges in counterclockwise order.
+//   Compute region of influence of new constraint newConstr of endpoints
+//   v0 and v1 to be inserted into the current triangulation, i.e., the
+//   lists of boundary edges of the two regions to the right and to the
+//   left of newConstr. Such lists will contain the edges in
+//   counterclockwise order.
+//   The search for an existing edge is done with a TSegment probe: the
+//   new edge is created only once it is known not to exist.
 //
-//   INPUT: newConstr
+//   INPUT: v0, v1
 //
 //   OUTPUT: fill the doubly linked lists Right_Border and Left_Border:
 //   such lists contain the right region and the left region of newConstr
@@ -1715,20 +1744,25 @@ void TDecCDT::Tra_Add_Constraint( PTVertex v0, PTVertex v1 )
 //
 //   RETURN VALUE:
 //         FALSE  if edge already exists (and is not marked as CONSTRAINED
-//           - to be further investigated).
+//           - to be further investigated); Edg is set to such edge.
 //           In this case the two border lists are not considered because
 //           it is sufficient to mark the edge as CONSTRAINED.
 //           It includes the case in which newConstr is on the convex hull
 //           of the triangulation.
 //         TRUE   if edge newConstr is internal and the two border lists  
-//         are filled correctly.
+//         are filled correctly; Edg is set to newConstr, created here
+//         (not yet marked as CONSTRAINED).
 //
 
-boolean TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_Border,
-                                  TDoubleList<PTEdge> &Left_Border, PTEdge & origEdg   )
+boolean TDecCDT::CalcEdgInflRegn( PTVertex v0, PTVertex v1, TDoubleList<PTEdge> &Right_Border,
+                                  TDoubleList<PTEdge> &Left_Border, PTEdge & Edg   )
 {
+   // probe for newConstr, used until it is known whether the edge exists
+   TSegment Probe( v0, v1 );
+   PTSegment newSeg = &Probe;
+
    #ifdef DEBUG7
-      DEBUG7 << "\n\nTDecCDT::CalcEdgInflRegn( " << *newConstr << " )\n";
+      DEBUG7 << "\n\nTDecCDT::CalcEdgInflRegn( " << *newSeg << " )\n";
    #endif 
 
    #ifdef ROBUST
@@ -1740,9 +1774,6 @@ boolean TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_B
    // result of intersection of newConstr with the edges of examined
    // triangles
 
-   PTVertex v0 = newConstr->EV[0],  // vertices of new constraint 
-            v1 = newConstr->EV[1];
-
    //
    //  examine v0
    //
@@ -1765,7 +1796,7 @@ boolean TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_B
    {
       oppositeEdg = Opposite_e_of_t_by_v( currTrg, v0 );
 
-      intersection = Tra_intersect( newConstr, oppositeEdg );
+      intersection = Tra_intersect( newSeg, oppositeEdg );
 
       if( intersection == PROPER_INTER )
       {
@@ -1793,18 +1824,18 @@ boolean TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_B
          PTEdge nextEdg = Next_CCW_e_of_t_by_e( currTrg, oppositeEdg ),
                 prevEdg = Prev_CCW_e_of_t_by_e( currTrg, oppositeEdg );
 
-         // set origEdg to point to the edge of the current triangulation
+         // set Edg to point to the edge of the current triangulation
          // which is the same as newConstr, and return FALSE
-         if( EqualsEV( newConstr, nextEdg ) ) // currTrg is not firstTrg
-            origEdg = nextEdg;
+         if( EqualsEV( newSeg, nextEdg ) ) // currTrg is not firstTrg
+            Edg = nextEdg;
          else                            // currTrg is firstTrg
          {
-            origEdg = prevEdg;
+            Edg = prevEdg;
             #ifdef ROBUST
-               if( ! EqualsEV( newConstr, prevEdg ) )
+               if( ! EqualsEV( newSeg, prevEdg ) )
                {
-                  cerr << "TDecCDT::CalcEdgInflRegn( " << *newConstr << ", ... ) : the new edge "
-                       << *newConstr << "\nintersects edge " << *oppositeEdg << " in only 1 common vertex;\nbut neither "
+                  cerr << "TDecCDT::CalcEdgInflRegn( " << *newSeg << ", ... ) : the new edge "
+                       << *newSeg << "\nintersects edge " << *oppositeEdg << " in only 1 common vertex;\nbut neither "
                        << *nextEdg << " nor " << *prevEdg << " matches  the new edge\n";
                   Pause("");
                }
@@ -1827,7 +1858,7 @@ boolean TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_B
    {
       oppositeEdg = Opposite_e_of_t_by_v( currTrg, v1 );
 
-      intersection = Tra_intersect( newConstr, oppositeEdg );
+      intersection = Tra_intersect( newSeg, oppositeEdg );
 
       if( intersection == PROPER_INTER )
       {
@@ -1872,6 +1903,18 @@ boolean TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_B
    // this guarantees that the resulting lists are sorted counterclockwise.
    //
 
+   // the edge does not exist: create newConstr
+
+   #ifdef _GC_ON
+	  PTEdge newConstr = GC::NewEdge( v0, v1 );
+	#else
+	  PTEdge newConstr = new TEdge( v0, v1 );
+	#endif // _GC_ON
+
+	check( (newConstr == NULL ),"TDecCDT::CalcEdgInflRegn , insufficient memory" );
+
+   Edg = newConstr;
+
       // Examine triangles adj_v0_Trg and adj_v1_Trg:
       // init lists Right_Border and Left_Border with newConstr and
       // with boundary edges incident in adj_v0_Trg and adj_v1_Trg.
@@ -1918,8 +1961,12 @@ boolean TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_B
    int intersectingEdg_pos, nextintersectingEdg_pos, notintersectingEdg_pos;  
 
  
+   int res[3];  // intersection of newConstr with the edges of currTrg
+
    while( currTrg != adj_v1_Trg )
    {
+      Tra_intersect( newSeg, currTrg, res );
+
       // search among the edges of currTrg the positions of the three edges
       //  - intersectingEdg  (certainly internal, it must be marked TO_DELETE),
       //  - the other edge, different from intersectingEdg, properly
@@ -1936,7 +1983,7 @@ boolean TDecCDT::CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_B
          // currTrg->TE[i] is the other edge of currTrg, different from
          // intersectingEdg, that intersects newConstr, and thus it must 
          // not be inserted in one of the two lists
-         else if( (intersection = Tra_intersect( newConstr , currTrg->TE[i])) )
+         else if( (intersection = res[i]) )
          {
             nextintersectingEdg_pos = i;
 
@@ -2051,10 +2098,10 @@ boolean TDecCDT::OkConstrDegree( PTVertex V )
    #endif 
 
    #ifdef ROBUST
-      TDoubleList<PTEdge> IncConstr;
-      check( V->nIncConstr != FindConstraintsInVE( V, IncConstr ) ,
-             "TDecCDT::OkConstrDegree(V) : inconsistency: value V->nIncConstr does not match the CDT" );
-      check( V->nIncConstr < 0 , "TDecCDT::OkConstrDegree(V) : constrDegree(V) < 0" );
+      for( int i=0; i<V->nIncConstr; i++ )
+         check( ! V->GetConstr( i )->Marked( CONSTRAINED ) ||
+                ( V->GetConstr( i )->EV[0] != V && V->GetConstr( i )->EV[1] != V ),
+                "TDecCDT::OkConstrDegree(V) : inconsistency: incident constraints of V do not match the CDT" );
    #endif
 
 //   if( TDecimDelaunay::InitialPhase )  // in initial phase RemoveVertex is never called
@@ -2065,8 +2112,11 @@ boolean TDecCDT::OkConstrDegree( PTVertex V )
    else
       if( V->nIncConstr == 2 )
       {
-         PTVertex V1 = Other_v_in_e( IncConstr.GetHead(), V );
-         PTVertex V2 = Other_v_in_e( IncConstr.GetLast(), V );
+         if( ChainTol >= 0.0 && ChainDeviation( V ) > ChainTol )
+            return FALSE;
+
+         PTVertex V1 = Other_v_in_e( V->GetConstr( 0 ), V );
+         PTVertex V2 = Other_v_in_e( V->GetConstr( 1 ), V );
          int isadmissible = IsEdgeAdmissible( V1, V2 );
 
          if(  ( AllowChainBrk == TRUE  &&  isadmissible >= EXIST_CONSTRAINED ) ||
@@ -2078,6 +2128,32 @@ boolean TDecCDT::OkConstrDegree( PTVertex V )
 }
 
 
+// -----------------------------------------------------------------------------
+//  
+//   double TDecCDT::ChainDeviation( PTVertex V )
+//
+//   Upper bound on the (xy) Hausdorff distance between the constraint
+//   V1-V2 which replaces the two constraints V1-V, V-V2 incident in V
+//   when V is removed, and the part of the original chain it replaces:
+//   each point within distance d of V1-V (or V-V2) is within distance
+//   d + dist(V, V1-V2) of V1-V2. It only needs the bounds stored in the
+//   Error field of the two constraints, and not the original chain.
+//
+
+double TDecCDT::ChainDeviation( PTVertex V )
+{
+   #ifdef ROBUST
+      check( V->nIncConstr != 2, "TDecCDT::ChainDeviation(), vertex not inside a chain" );
+   #endif
+
+   PTEdge C1 = V->GetConstr( 0 );
+   PTEdge C2 = V->GetConstr( 1 );
+   double Dev = ( C1->Error > C2->Error ? C1->Error : C2->Error );
+
+   return( Dev + Geom::SegmentDistancexy( V, Other_v_in_e( C1, V ), Other_v_in_e( C2, V ) ) );
+}
+
+
 // -----------------------------------------------------------------------------
 //  
 //   boolean TDecCDT::ReCheckVertex( PTVertex V )
@@ -2099,7 +2175,10 @@ int TDecCDT::IsEdgeAdmissible( PTVertex v0, PTVertex v1 )
       DEBUG11 << "\n\nTDecCDT::IsEdgeAdmissible( " << *v0 << ", " << *v1 <<  " )\n";
    #endif
 
-	PTEdge newE = new TEdge( v0, v1 );
+   // probe edge, only used for the geometric tests (it is not
+   // inserted in the triangulation)
+   TSegment Probe( v0, v1 );
+   PTSegment newE = &Probe;
 
    
    int intersection;
@@ -2322,22 +2401,48 @@ void TDecCDT::UpdateStep()
 }
 
 
+//
+// Record in the MT tracer the constraints of the initial triangulation,
+// read from the input file, before calling MT_Initial(). Only the log
+// of the updates needs them (see MTTracer::SetUpdateLog).
+//
+void TDecCDT::MT_InitialConstraints()
+{
+   PTEdge E;
+
+   if ( ! MT->LogsUpdates() ) return;
+
+   if ( ConstrSet )
+   {
+      for( TIndex i=0; i<ConstrSet->Count(); i++ )
+         MT->MakeConstraint( ConstrSet->Get( i ) );
+      return;
+   }
+
+   for( TIndex v=0; v<nPts; v++ )
+   {
+      PTVertex V = (PTVertex)(Points[v]);
+
+      if ( V->VE[0] == NULL || V->nIncConstr == 0 ) continue;
+      V->GetVE();
+      while ( ! V->EdgeList.IsEmpty() )
+      {
+         E = V->EdgeList.RemoveHead();
+         // ...each constraint once, from its first vertex
+         if ( E->Marked( CONSTRAINED ) && E->EV[0] == V ) MT->MakeConstraint( E );
+      }
+   }
+}
+
 
 void TDecCDT::Edge2Constraint( PTEdge E )
 {
    nConstrInTRI++;
-   E->EV[0]->nIncConstr++;
-   E->EV[1]->nIncConstr++;
+   E->EV[0]->AddConstr( E );
+   E->EV[1]->AddConstr( E );
    E->Mark(CONSTRAINED);
-
-   #ifdef array_Constraints
-      for( int c = 0; c < nConstrInFile; c++ )
-         if( Constraints[c] == NULL )
-         {
-            Constraints[c] = E;
-            break;
-         }
-   #endif
+   MT->MakeConstraint( E );
+   if ( ConstrSet ) ConstrSet->Add( E );
 }
 
 void TDecCDT::AdjustBordersVertices_VE( TDoubleList<PTEdge> Border )
@@ -2362,8 +2467,14 @@ void TDecCDT::AdjustBordersVertices_VE( TDoubleList<PTEdge> Border )
       ECurr = IRegnIter.Current()->object;
       
       // VCurr is the common vertex of EPrev and ECurr, i.e., the
-      // second vertex of EPrev in CCW order w.r.t. VertexToRemove
+      // second vertex of EPrev in CCW order w.r.t. VertexToRemove.
+      // An edge dangling into the region is walked on both sides: where
+      // EPrev == ECurr, VCurr is its tip, i.e., the vertex of EPrev
+      // other than the previous VCurr
       
+      if ( EPrev == ECurr && VCurr != NULL )
+        VCurr = Other_v_in_e( EPrev, VCurr );
+      else
       if ( EPrev->EV[0] == ECurr->EV[0] || EPrev->EV[0] == ECurr->EV[1] )
         VCurr = EPrev->EV[0];
       else
@@ -2464,6 +2575,33 @@ void TDecCDT::Delete_Constr_InfluenceRegion( PTEdge newConstr )
    
    TDestroyDelaunay::DeleteInfluenceRegion();
 
+   //
+   // The tip of an edge dangling into the region has been left with both
+   // VE relations on that edge (see AdjustBordersVertices_VE): point one
+   // of them to another edge of the new triangles
+   //
+
+   TDoubleListIterator<PTEdge> BorderIter( &InflRegnBorder );
+   BorderIter.Restart();
+   while ( ! BorderIter.EndOfList() )
+   {
+      PTEdge E = BorderIter.Current()->object;
+
+      for( int v=0; v<2; v++ )
+      {
+         PTVertex V = E->EV[v];
+
+         if ( V->VE[0] == V->VE[1] && E->ET[0] != NULL )
+            for( int e=0; e<3; e++ )
+            {
+               PTEdge F = E->ET[0]->TE[e];
+               if ( F != E && ( F->EV[0] == V || F->EV[1] == V ) )
+               {  V->VE[1] = F;  break;  }
+            }
+      }
+      BorderIter.GoNext();
+   }
+
 
    // 
    // TDestroyDelaunay::DeleteInfluenceRegion() scans the list
@@ -2525,30 +2663,23 @@ void TDecCDT::Delete_Constr_InfluenceRegion( PTEdge newConstr )
 }
 
 
-void TDecCDT::TTra_Add_Constraint( PTVertex v0, PTVertex v1 )
+PTEdge TDecCDT::TTra_Add_Constraint( PTVertex v0, PTVertex v1 )
 {
    #ifdef DEBUG13
       cerr << "TDecCDT::TTra_Add_Constraint( V" << v0->VID << " , V" << v1->VID << " )\n";
       cerr << "Now constr num = " << nConstrInTRI << endl;
    #endif 
 
-   // new constraint to be inserted
-   #ifdef _GC_ON
-	  PTEdge newConstr = GC::NewEdge( v0, v1 );
-	#else
-	  PTEdge newConstr = new TEdge( v0, v1 );
-	#endif // _GC_ON
-
-	check( (newConstr == NULL ),"TDecCDT::TTra_Add_Constraint , insufficient memory" );
+   // new constraint to be inserted: CalcEdgInflRegn creates it only if
+   // the edge is not already present, otherwise it returns the existing
+   // edge
+   PTEdge newConstr;
 
-
-   PTEdge origEdg;
-
-   if( ! CalcEdgInflRegn( newConstr, Right_Border, Left_Border, origEdg ) )
+   if( ! CalcEdgInflRegn( v0, v1, Right_Border, Left_Border, newConstr ) )
    {  
-      delete newConstr;  
-      if( ! origEdg->Marked( CONSTRAINED ) )
-         Edge2Constraint( origEdg );
+      if( ! newConstr->Marked( CONSTRAINED ) )
+         Edge2Constraint( newConstr );
+      return( newConstr );
    }
    else
    {
@@ -2559,6 +2690,7 @@ void TDecCDT::TTra_Add_Constraint( PTVertex v0, PTVertex v1 )
       RIRInitialTrg( Left_Border, SwapEdgeQueue );
       RIRDelOptTrg();
       Delete_Constr_InfluenceRegion( newConstr );
+      return( newConstr );
    }
 }
 
@@ -2566,18 +2698,11 @@ void TDecCDT::TTra_Add_Constraint( PTVertex v0, PTVertex v1 )
 void TDecCDT::Constraint2Edge( PTEdge E )
 {
    nConstrInTRI--;
-   E->EV[0]->nIncConstr--;
-   E->EV[1]->nIncConstr--;
+   E->EV[0]->RemoveConstr( E );
+   E->EV[1]->RemoveConstr( E );
    E->UnMark(CONSTRAINED);
-
-   #ifdef array_Constraints
-      for( int c = 0; c < nConstrInFile; c++ )
-         if( Constraints[c] == E )
-         {
-            Constraints[c] = NULL;
-            break;
-         }
-   #endif
+   MT->KillConstraint( E );
+   if ( ConstrSet ) ConstrSet->Remove( E );
 }
 
 
@@ -2587,8 +2712,7 @@ void TDecCDT::Constraint2Edge( PTEdge E )
 // which do not belong to the convex hull, belong to InflRegnBorder 
 // and are incident in c.
 //
-void TDecCDT::ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge c,
-                             TDoubleList<TEdge> &OrigEdgList)
+void TDecCDT::ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge c)
 {
    PTEdge e;
    for( int i = 0; i <= 1; i++ )
@@ -2600,7 +2724,6 @@ void TDecCDT::ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge c,
          {
             SwapEdgeQueue.AddHead(e);
             e->Mark(SWAP_EDGE_QUEUE);
-//          OrigEdgList.AddHead(*e);
          }
       }
    }
@@ -2615,7 +2738,7 @@ void TDecCDT::ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge c,
 // 
 // Convert c1 and c2 to normal edges.
 //
-// Put into OrigEdgList a copy of the edges present in InflRegnBorder
+// Save in OrigET the ET relations of the edges present in InflRegnBorder
 // and mark them as COPIED.
 //
 // In case the boundary InflRegnBorder of the influence region is not
@@ -2631,28 +2754,28 @@ void TDecCDT::ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge c,
 // boundary.
 //
 void TDecCDT::ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge c1, PTEdge c2,
-                             boolean & closed, TDoubleList<TEdge> &OrigEdgList)
+                             boolean & closed, TEdgeETMap &OrigET)
 {
    if( c1 != NULL )
    {
-       ExtRIRIPrepare (SwapEdgeQueue, c1, OrigEdgList);
+       ExtRIRIPrepare (SwapEdgeQueue, c1);
        Constraint2Edge(c1);
    }
    if( c2 != NULL )
    {
-       ExtRIRIPrepare (SwapEdgeQueue, c2, OrigEdgList);
+       ExtRIRIPrepare (SwapEdgeQueue, c2);
        Constraint2Edge(c2);
    }
 
-   // Put a copy of the edges of InflRegnBorder in OrigEdgList, and mark
-   // them as COPIED.
+   // Save the ET relations of the edges of InflRegnBorder in OrigET,
+   // and mark them as COPIED.
    // Do not worry about parameter "closed": an edge of the convex hull
    // is never considered for the swap during the optimization.
    TDoubleListIterator<PTEdge> InflRegnIter( &InflRegnBorder );
    InflRegnIter.Restart();
    while ( ! InflRegnIter.EndOfList() )
    {
-       OrigEdgList.AddHead( *(InflRegnIter.Current()->object) );
+       OrigET.Save( InflRegnIter.Current()->object );
        InflRegnIter.Current()->object->Mark(COPIED);
        InflRegnIter.GoNext();
    }
@@ -3132,7 +3255,7 @@ void TDecCDT::ExtRIRInitialTrg( TDoubleList<PTEdge> & InflRegnBorder,
 //    endpoints may point to E; thus we set such pointer to one edge
 //    of the quadrilateral.
 //
-PTEdge TDecCDT::ExtSwapEdge( PTEdge &E, TDoubleList<TEdge> &OrigEdgList )
+PTEdge TDecCDT::ExtSwapEdge( PTEdge &E, TEdgeETMap &OrigET )
 {
 
     #ifdef DEBUG
@@ -3285,9 +3408,8 @@ if (CheckIsolatedPoint(E->EV[1]))
    else   // E is an original edge
    {
       E->Mark( TO_DELETE );
-      ReconstructET( E, OrigEdgList );
-      // restore original E->ET relation and remove from OrigEdgList
-      // the copy of E
+      ReconstructET( E, OrigET );
+      // restore original E->ET relation and remove E from OrigET
       E->UnMark( COPIED );
    }
     
@@ -3341,7 +3463,7 @@ if (CheckIsolatedPoint(E->EV[1]))
 //      provided that they are not constraints and the are not on the 
 //      convex hull
 //
-void TDecCDT::ExtRIRDelOptTrg( TDoubleList<PTEdge> & SwapEdgeQueue,TDoubleList<TEdge> &OrigEdgList )
+void TDecCDT::ExtRIRDelOptTrg( TDoubleList<PTEdge> & SwapEdgeQueue,TEdgeETMap &OrigET )
 {
    int e;
    // PTEdge pe;
@@ -3359,10 +3481,10 @@ void TDecCDT::ExtRIRDelOptTrg( TDoubleList<PTEdge> & SwapEdgeQueue,TDoubleList<T
    
       if ( EdgeToSwap( ECurr ) )
       {
-         // copy in OrigEdgList the boundary edges of the quadrilateral
+         // save in OrigET the boundary edges of the quadrilateral
          // formed by the two triangles adjacent to ECurr that will be put
          // in SwapEdgeQueue after the diagonal swap and that are original
-         // and not yet present in OrigEdgList (marked as COPIED)
+         // and not yet present in OrigET (marked as COPIED)
           
          GetQuadBorder( ECurr, E[0], E[1], E[2], E[3] );
        
@@ -3371,15 +3493,14 @@ void TDecCDT::ExtRIRDelOptTrg( TDoubleList<PTEdge> & SwapEdgeQueue,TDoubleList<T
             if (    !E[e]->Marked( SWAP_EDGE_QUEUE ) && !E[e]->Marked( CONSTRAINED ) && !E[e]->OnConvexHull()
                  && !E[e]->Marked(NEW_EDGE) && !E[e]->Marked(COPIED) )
             {
-               // pe = new TEdge(*E[e]);
-               OrigEdgList.AddHead( *E[e] );
+               OrigET.Save( E[e] );
                E[e]->Mark(COPIED);
             }
          }
 
          // swap edge
        
-         NewEdge = ExtSwapEdge( ECurr, OrigEdgList );
+         NewEdge = ExtSwapEdge( ECurr, OrigET );
        
          // enqueue the boundary edges of the quadrilateral formed
          // by the two triangles adjacent to NewEdge
@@ -3398,27 +3519,24 @@ void TDecCDT::ExtRIRDelOptTrg( TDoubleList<PTEdge> & SwapEdgeQueue,TDoubleList<T
       } // end ...if( EdgeToSwap )
    } // end ...while( !SwapEdgeQueue.IsEmpty() )
 
-   // End of optimization. Empty list OrigEdgList that contains a copy
-   // of the original edges considered but not swapped.
+   // End of optimization. Empty table OrigET that contains the ET
+   // relations of the original edges considered but not swapped.
    // ATTENTION: the COPIED mark must be removed from such edges.
    //            This is done by function ExtDelBaseDelInflRegn called by
    //            ExtDeleteInfluenceRegion instead of
    //            TDelaunayBase::DeleteInfluenceRegion() .
    //
    #ifdef ROBUST
-      TDoubleListIterator<TEdge> OrigEdgIter( &OrigEdgList );
-      OrigEdgIter.Restart();
+      TIndex i;
       PTEdge edg;
-      while ( ! OrigEdgIter.EndOfList() )
+      for( i=0; i<OrigET.Slots(); i++ )
       {
-         edg = &( OrigEdgIter.Current()->object );
-         if( edg->Marked( TO_DELETE ) || edg->Marked( NEW_EDGE ) )
-            Pause("BUG: list OrigEdgList contains a non-original edge or an adge not marked as TO_DELETE");
-
-         OrigEdgIter.GoNext();
+         edg = OrigET.EdgeAt( i );
+         if( edg != NULL && ( edg->Marked( TO_DELETE ) || edg->Marked( NEW_EDGE ) ) )
+            Pause("BUG: OrigET contains a non-original edge or an edge marked as TO_DELETE");
       }
    #endif
-   OrigEdgList.ClearList();
+   OrigET.Clear();
 }
 
 
@@ -3451,6 +3569,12 @@ void TDecCDT::ExtDeleteInfluenceRegion( TDoubleList<PTEdge> & InflRegnBorder )
    //
    RecheckOptimizedRegion();
 
+   // delete INFL_BORDER mark from edges in InflRegnBorder and free 
+   // list InflRegnBorder: the optimization may have swapped some of
+   // them, and they are deleted below
+   //
+   Del_InflRegnBorder( InflRegnBorder );
+
    // Traverse triangles marked as TO_DELETE through adjacency navigation
    // starting from FirstTrgToDel.
    // Remove mark TO_DELETE from triangles and mark edges as COPIED.
@@ -3461,6 +3585,23 @@ void TDecCDT::ExtDeleteInfluenceRegion( TDoubleList<PTEdge> & InflRegnBorder )
    //  TDelaunayBase::DeleteInfluenceRegion();
    ExtDelBaseDelInflRegn();
 
+   // DetachEdge has set to NULL the VE relations pointing to the deleted
+   // edges of InflRegnBorder: make them point to new edges
+   //
+   for( TIndex i=0; i<NewTrgs.Count(); i++ )
+      for( int e=0; e<3; e++ )
+      {
+         PTEdge E = NewTrgs[i]->TE[e];
+
+         for( int v=0; v<2; v++ )
+         {
+            PTVertex V = E->EV[v];
+
+            if ( V->VE[0] == NULL && V->VE[1] != E ) V->VE[0] = E;
+            else if ( V->VE[1] == NULL && V->VE[0] != E ) V->VE[1] = E;
+         }
+      }
+
    //
    // Reposition points "Detached" from deleted triangles into new
    // triangles, in such a way that we can compute errors correctly
@@ -3484,80 +3625,53 @@ void TDecCDT::ExtDeleteInfluenceRegion( TDoubleList<PTEdge> & InflRegnBorder )
    //   
    if ( ! InitialPhase ) ExtMT_AddComponent();
 
-   // delete INFL_BORDER mark from edges in InflRegnBorder and free 
-   // list InflRegnBorder
-   //
-   Del_InflRegnBorder( InflRegnBorder );
-
 }
 
 
 void TDecCDT::RecheckOptimizedRegion()
 {
 
+   TIndex j;
+
    #ifdef DEBUG
      DEBUG << endl << "MT: delete V" << VertexToRemove->VID 
           << ": " << VertexToRemove->x << ", " << VertexToRemove->y 
           << " => ERR : " << VertexToRemove->Error << endl;
    #endif
 
+   //
+   // the triangles of the region are those collected (usually already
+   // by MT_KillInterference) into OldTrgs
+   //
 
-   if ( FirstTrgToDel != NULL )
-   {
-   
-      #ifdef ROBUST
-         check( (! FirstTrgToDel->Marked( TO_DELETE ) ),
-            "TDecCDT::RecheckOptimizedRegion(), inconsistency detected" );
-      #endif
+   CollectInfluenceRegion();
 
-      TDoubleList<PTTriangle> Triangles;
+   for( j=0; j<OldTrgs.Count(); j++ )
+   {
+      PTVertex TV[3];
       
-      FirstTrgToDel->Mark( RECHECKED );
-      Triangles.AddHead( FirstTrgToDel );
+      OldTrgs[j]->GetTV( TV[0], TV[1], TV[2] );
       
-      while( !Triangles.IsEmpty() )
+      //
+      // operations needed for the extension of optimization
+      //
+      int i;
+      for( i = 0; i <= 2; i++ )
       {
-          PTTriangle T = Triangles.RemoveHead();
-          PTTriangle TT[3];
-          PTVertex TV[3];
-      
-          // cannot remove mark TO_DELETE, it is needed for
-          // TBuildDelaunay::DeleteInfluenceRegion()
-      
-          T->GetTT( TT[0], TT[1], TT[2] );
-          T->GetTV( TV[0], TV[1], TV[2] );
-      
-          //
-          // operations needed for the extension of optimization
-          //
-          int i;
-          for( i = 0; i <= 2; i++ )
-          {
-             if( ! TV[i]->Marked( RECHECKED ) )
-             {
-                if( ElimVtxTree.IsIn( TV[i] ) )
-                   ElimVtxTree.Remove( TV[i] );
-
-                if( ReCheckVertex( TV[i] ) )
-                   ElimVtxTree.Insert( TV[i] );
-
-                TV[i]->Mark( RECHECKED );
-             }
+         if( ! TV[i]->Marked( RECHECKED ) )
+         {
+            if( ElimVtxTree.IsIn( TV[i] ) )
+               ElimVtxTree.Remove( TV[i] );
 
-          }
+            if( ReCheckVertex( TV[i] ) )
+               ElimVtxTree.Insert( TV[i] );
+
+            TV[i]->Mark( RECHECKED );
+         }
 
-          // enqueue triangles adjacent to T and not yet visited
-          //
-          for( int t=0; t<3; t++ )
-             if ( TT[t] != NULL && TT[t]->Marked( TO_DELETE ) 
-                  && ! TT[t]->Marked( RECHECKED ) )
-                  {  
-                     TT[t]->Mark( RECHECKED );
-                     Triangles.AddTail( TT[t] );
-                  }		     
       }
-      
    }
+
    // VertexToRemove may have been re-inserted in ElimVtxTree: remove it
    //
    if( ElimVtxTree.IsIn( VertexToRemove ) )
@@ -3566,42 +3680,33 @@ void TDecCDT::RecheckOptimizedRegion()
 
 
 // Equal to MT_AddComponent but add what follows,
-// for each visited triangle t:
+// for each new triangle t:
 // - delete mark NEW_EDGE from marked edges belonging to TE(t)
 // - delete mark RECHEKED from marked vertices belonging to TV(t)
-// - delete mark RECHEKED from any visited triangle t
 //   
 void TDecCDT::ExtMT_AddComponent()
 {
 
+   TIndex j;
+
    #ifdef MT_DEBUG
       MT_DEBUG << "TDecCDT::ExtMT_AddComponent() record retriangulation after deleting V" << VertexToRemove->VID << endl;
    #endif
 
    #ifdef ROBUST
-      check( (FirstTriangle == NULL || !FirstTriangle->Marked( NEW_TRIANGLE )),
-             "TDecCDT::ExtMT_AddComponent(), inconsistency detected" );
+      check( NewTrgs.IsEmpty(), "TDecCDT::ExtMT_AddComponent(), inconsistency detected" );
    #endif
      
-   TDoubleList<PTTriangle> Triangles;
-     
-   FirstTriangle->UnMark( NEW_TRIANGLE );
-   Triangles.AddHead( FirstTriangle );
-   
-   while ( ! Triangles.IsEmpty() )
+   for( j=0; j<NewTrgs.Count(); j++ )
    {
-      PTTriangle T = Triangles.RemoveHead();
-      PTTriangle TT[3];
+      PTTriangle T = NewTrgs[j];
       PTVertex   TV[3];
 
       T->GetTV( TV[0], TV[1], TV[2] );
-      T->GetTT( TT[0], TT[1], TT[2] );
 
       // operations of version Ext
       //
 
-      T->UnMark( RECHECKED );
-
       int i;
       for( i = 0; i <= 2; i++ )
       {
@@ -3609,22 +3714,10 @@ void TDecCDT::ExtMT_AddComponent()
          T->TE[i]->UnMark( NEW_EDGE );
       }
 
-      double Error = 0.0;  
-      Error = Error;  //  needed to avoid warning
-      if ( ! T->PointList.IsEmpty() ) Error = T->PointList.GetHead()->Error;
-      
+      T->UnMark( NEW_TRIANGLE );
       MT->MakeTriangle( T );
-
-      // enqueue adjacent triangles that are not yet in queue
-      //
-      for( int t=0; t<3; t++ )
-         if ( TT[t] != NULL && TT[t]->Marked( NEW_TRIANGLE ) )
-         {
-            TT[t]->UnMark( NEW_TRIANGLE );
-            Triangles.AddTail( TT[t] );
-         }
-      
    }
+   NewTrgs.Clear();
       
    MT->MeshOk();
   
@@ -3694,6 +3787,9 @@ void TDecCDT::Del_InflRegnBorder( TDoubleList<PTEdge> & InflRegnBorder )
 //
 void TDecCDT::ExtDelBaseDelInflRegn()
 {
+   TIndex i;
+   int e;
+
    #ifdef DEBUG
       DEBUG << "\nTDecCDT::ExtDelBaseDelInflRegn( "
             << "FirstTrgToDel = ";
@@ -3702,108 +3798,41 @@ void TDecCDT::ExtDelBaseDelInflRegn()
       DEBUG << " )" << endl;
    #endif // DEBUG
 
-   #ifdef DEBUG15
-      DEBUG15 << "\nTDecCDT::ExtDelBaseDelInflRegn : visit the following entities:\n";
-   #endif
+   //
+   // the region has usually been collected already by MT_KillInterference
+   // or RecheckOptimizedRegion; CollectInfluenceRegion() skips edges 
+   // marked as TO_DELETE with a NULL triangle in their ET relation
+   //
 
-   // if no triangles to be deleted
-   if ( FirstTrgToDel == NULL ) return; 
-     
-   TDoubleList<PTTriangle> TrgToDel;
-   PTTriangle CurrTrg, NextTrg;
-   PTEdge NextEdg;
+   CollectInfluenceRegion();
 
-   TrgToDel.AddHead( FirstTrgToDel );
-     
-   while ( ! TrgToDel.IsEmpty() )
+   for( i=0; i<OldTrgs.Count(); i++ )
    {
-      CurrTrg = TrgToDel.RemoveHead();
+      PTTriangle CurrTrg = OldTrgs[i];
 
       #ifdef DEBUG15
          DEBUG15 << "T" << CurrTrg->TID << endl;
       #endif
-      
-      #ifdef ROBUST
-         check( (CurrTrg == NULL), "TDelaunayBase::DeleteInfluenceRegion(), <1> this should not happen");
-      #endif
-        
-      for( int e=0; e<3; e++ )
-      {      
-         NextEdg = CurrTrg->TE[e];
 
-         //
-         // edge may have been deleted in previous iterations of the
-         // while loop, we need to check
-         //
-         
-         if ( NextEdg != NULL ) 
+      for( e=0; e<3; e++ )
+      {
+         PTEdge NextEdg = CurrTrg->TE[e];
+
+         // remove mark COPIED, if present
+         if( NextEdg != NULL && NextEdg->Marked(COPIED) )
          {
             #ifdef DEBUG15
-               DEBUG15 << *NextEdg << endl;
+               DEBUG15 << "Unmark copied " << *NextEdg << endl;
             #endif
-      
-            // smarco la marctura COPIED se presente
-            if( NextEdg->Marked(COPIED) )
-            {
-               #ifdef DEBUG15
-                  DEBUG15 << "Unmark copied " << *NextEdg << endl;
-               #endif
-               NextEdg->UnMark(COPIED);
-            }
+            NextEdg->UnMark(COPIED);
+         }
 
-            if ( NextEdg->Marked(TO_DELETE) )
-            {
-               // NextTrg = ( (NextEdg->ET[0] == CurrTrg || NextEdg->ET[0] == NULL) ? NextEdg->ET[1] : NextEdg->ET[0] );
-               if( NextEdg->OnConvexHull() )
-                  NextTrg = NULL;
-               else
-               {
-                  check( NextEdg->ET[0] == NULL || NextEdg->ET[1] == NULL, "ExtDelBaseDelInflRegn: <a> inconsistency detected\n" );
-                  NextTrg = ( NextEdg->ET[0] == CurrTrg ? NextEdg->ET[1] : NextEdg->ET[0] ); 
-               }    
-               DetachEdge( NextEdg );
-               
-               #ifdef _GC_ON
-                  GC::DeleteEdge( NextEdg );
-               #else
-                  delete( NextEdg );
-               #endif // _GC_ON
-          
-               NextEdg = NULL;
-            }
-            else
-               NextTrg = NULL;
-      
-            if ( NextTrg != NULL )
-            {
-               if ( NextTrg->Marked( TO_DELETE ) )
-               {
-                  NextTrg->UnMark( TO_DELETE );
-                  TrgToDel.AddTail( NextTrg );
-               }
-            }
-                       
-         } // end ...if( NextEdg != NULL )...
-    
-      } // end...for
-    
-      //
-      // remove CurrTrg from the triangulation, destructor of TTriangle
-      // sets to NULL the pointers to CurrTrg contained in edges adjacent
-      // to it
-      //
-       
-      DetachTriangle( CurrTrg );
-    
-      #ifdef _GC_ON
-         GC::DeleteTriangle( CurrTrg );
-      #else
-         delete( CurrTrg );
-      #endif // _GC_ON
-    
-      CurrTrg = NULL;
-       
-   } // end ...while( !TrgToDel.IsEmpty() )
+         if( NextEdg != NULL && NextEdg->Marked(TO_DELETE) && ! NextEdg->OnConvexHull() )
+            check( NextEdg->ET[0] == NULL || NextEdg->ET[1] == NULL, "ExtDelBaseDelInflRegn: <a> inconsistency detected\n" );
+      }
+   }
+
+   TDelaunayBase::DeleteInfluenceRegion();
      
    #ifdef DEBUG
       DEBUG << "exit TDecCDT::ExtDelBaseDelInflRegn" << endl;
@@ -3812,46 +3841,33 @@ void TDecCDT::ExtDelBaseDelInflRegn()
 
 
 //
-// Restore original E->ET relation and remove the copy of E from
-// OrigEdgList.
+// Restore original E->ET relation and remove E from OrigET.
 // Given an original edge E that must be removed from the triangulation
-// (marked as TO_DELETE) and the list OrigEdgList containing the copies
-// of original edges involved in the optimization,
-// extract from the list the copy of E and reconstruct from it the
-// ET relation of E (by copying from the copy).
+// (marked as TO_DELETE) and the table OrigET containing the ET
+// relations of original edges involved in the optimization,
+// set the ET relation of E to the saved one and remove it from the
+// table.
 //
-void TDecCDT::ReconstructET( PTEdge E, TDoubleList<TEdge> &OrigEdgList )
+void TDecCDT::ReconstructET( PTEdge E, TEdgeETMap &OrigET )
 {
-   TDoubleListIterator<TEdge> OrigEdgIter( &OrigEdgList );
-   OrigEdgIter.Restart();
-   PTEdge edg;
-   while ( ! OrigEdgIter.EndOfList() )
+   if( ! OrigET.Restore( E ) )
    {
-      edg = &( OrigEdgIter.Current()->object );
-      if( edg->EID == E->EID )
-      {
-         E->ET[0] = edg->ET[0];
-         E->ET[1] = edg->ET[1];
-         OrigEdgList.RemoveAt( OrigEdgIter.Current() );
-         return;
-      }
-      OrigEdgIter.GoNext();
+      // if we arrive here, we have not saved the edge
+      cerr << "TDecCDT::ReconstructET(" << *E << " , OrigET): edge not found in table\n";
+      Pause("");
    }
-   // if we arrive here, we have not found the edge
-   cerr << "TDecCDT::ReconstructET(" << *E << " , OrigEdgList): edge not found in list\n";
-   Pause("");
 }
 
 //----------------------------------------------------------------------------
 //
-//  void TDecCDT ::ConvertData(int *vNum, int *tNum, int *eNum,
-//                             float **vData, int **tData, int **eData)
+//  void TDecCDT ::ConvertData(TIndex *vNum, TIndex *tNum, TIndex *eNum,
+//                             float **vData, TIndex **tData, TIndex **eData)
 //
 
-void TDecCDT::ConvertData(int *vNum, int *tNum, int *eNum,
-                          float **vData, int **tData, int **eData)
+void TDecCDT::ConvertData(TIndex *vNum, TIndex *tNum, TIndex *eNum,
+                          float **vData, TIndex **tData, TIndex **eData)
 {
-    int iv, it, ie, i;
+    TIndex iv, it, ie, i;
 
      #ifdef DEBUG
       DEBUG << "\nTDecCDT::ConvertData(" << outfname << ")" << endl;
@@ -3862,7 +3878,7 @@ void TDecCDT::ConvertData(int *vNum, int *tNum, int *eNum,
     //
     
     // PAOLA: number or really existing vertices
-    int nVrt = 0;
+    TIndex nVrt = 0;
 
     PTVertex *VtxArray;   
     PTTriangle *TrgArray;
@@ -3928,7 +3944,8 @@ void TDecCDT::ConvertData(int *vNum, int *tNum, int *eNum,
        int i;
        for( i=0; i<3; i++ )
        {
-          if( ! CurTrg->TE[i]->Marked( VISITED ) && CurTrg->TE[i]->Marked( CONSTRAINED )) // ogni edge e' comune a due triangoli quindi
+          if( ConstrSet == NULL &&
+              ! CurTrg->TE[i]->Marked( VISITED ) && CurTrg->TE[i]->Marked( CONSTRAINED )) // ogni edge e' comune a due triangoli quindi
           {        // it may have been already visited
             #ifdef ROBUST
                check( ie >= nConstrInTRI, "TDecCDT::ConvertData(), constraints inconsistency detected" );
@@ -3979,7 +3996,7 @@ if (it != nTrg) printf("it = %d diverso da nTrg = %d\n",it, nTrg);
     // The number of non-NULL vertices must be equal to iv.
     // 
     nVrt = iv;
-    {  int new_vid = 0;
+    {  TIndex new_vid = 0;
        for ( iv=0; iv<nPts; iv++ )
        {
          if (VtxArray[iv]) VtxArray[iv]->VID = new_vid++;
@@ -3988,6 +4005,10 @@ if (it != nTrg) printf("it = %d diverso da nTrg = %d\n",it, nTrg);
               "TDecCDT::ConvertData(), error in vertex number");
     }
 
+    ReorderOutput( VtxArray, nVrt, TrgArray, nTrg );
+
+    if ( ConstrSet ) ie = ListConstraints( EdgArray );
+
     //
     // output data ...first of all allocate memory
     //
@@ -3996,7 +4017,7 @@ if (it != nTrg) printf("it = %d diverso da nTrg = %d\n",it, nTrg);
     *tNum = nTrg;
     *eNum = 0;
     *vData = (float*)malloc(3*nVrt*sizeof(float));
-    *tData = (int*)malloc(3*nTrg*sizeof(int));
+    *tData = (TIndex*)malloc(3*nTrg*sizeof(TIndex));
 
     //
     // ...first vertices...
@@ -4052,13 +4073,13 @@ if (it != nTrg) printf("it = %d diverso da nTrg = %d\n",it, nTrg);
     //
 
     (*eNum) = nConstrInTRI;
-    *eData = (int*)malloc(2*nConstrInTRI*sizeof(int));
+    *eData = (TIndex*)malloc(2*nConstrInTRI*sizeof(TIndex));
 
     check( ie != nConstrInTRI, "TDecCDT::ConvertData(), <3> inconsistency detected");
 
     for( ie=0; ie<nConstrInTRI; ie++ )
     {
-       int vIndx[2];
+       TIndex vIndx[2];
 
        vIndx[0] = EdgArray[ie]->EV[0]->VID;
        vIndx[1] = EdgArray[ie]->EV[1]->VID;
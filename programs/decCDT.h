@@ -34,19 +34,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define _DECCDT_H
 
 #include "decdel.h"
+#include "etmap.h"
+#include "segint.h"
+#include "constrset.h"
 
 
-// Macros for the result of function
-// TRA_intersect( PTEdge e1, PTEdge e2 ): intersection test 
-// between two edges
-
-#define NO_INTER      0   /* no intersection */
-#define ONLY_1CV      1   /* intersection just in a vertex */
-#define NOT_PROPER    2   /* a vertex of one falls inside the other one */
-#define PROPER_INTER  3   /* proper intersection */
-#define UPON_NO_CV    4   /* partially coincident without common vertices */
-#define UPON_AND_1CV  5   /* partially coincident with one common vertex */
-#define UPON_AND_2CV  6   /* coincident edges */
+// The result of function Tra_intersect( PTEdge e1, PTEdge e2 ),
+// intersection test between two edges, is defined in segint.h
 
 // Macros for the result of function InitCalcEdgeWideInflRegn
 
@@ -109,20 +103,27 @@ class TDecCDT : virtual public TDecimDelaunay
       // a chain of three edges.
       boolean AllowChainBrk;                   
 
+      // Budget on the deviation of each simplified chain of constraints
+      // from the original one (negative = no budget, the default).
+      // The Error field of a constraint edge keeps an upper bound on the
+      // (xy) Hausdorff distance between it and the part of the original
+      // chain it replaces, so that the budget is checked without
+      // scanning the chain.
+      double ChainTol;
+
       // Right and left boundary w.r.t. to the edge directed from v0 to v1.
       // Used during the insertion of a constraint.
       // Set by function CalcEdgInflRegn. They store, in CCW order,
       // the boundary edges of the regions of influence of an edge.
       TDoubleList<PTEdge> Right_Border, Left_Border;
       
-      // List containing a copy of the original edges involved in the 
+      // Table of the original ET relations (by EID) of the original
+      // edges involved in the optimization, as they were before
       // optimization.
-      // Such copies contain tha attributes of the original edges as
-      // they were before optimization.
-      // When the copy of an edge is inserted in this list, the edge is
-      // marked as COPIED. When the copy is deleted from the list, the
+      // When the ET relation of an edge is saved in this table, the edge
+      // is marked as COPIED. When it is removed from the table, the
       // COPIED mark is removed from the edge.
-      // The list is initialized just after the computation of the
+      // The table is filled just after the computation of the
       // influence region by TDedCDT::ExtRIRPrepare, with the edges of
       // InflRegnBorder, that may be later involved in the optimization,
       // and be removed from the triangulation.
@@ -135,39 +136,41 @@ class TDecCDT : virtual public TDecimDelaunay
       // same area.
       // When an original edge is marked as TO_DELETE during the 
       // optimization, certainly it is no more considered for the
-      // optimization, thus we can remove its copy from OrigEdgList and
-      // remove the COPIED mark from the corresponding original edge.
-      // At the end of optimization, list OrigEdgList contains all original
+      // optimization, thus we restore its ET relation, remove it from
+      // OrigET and remove the COPIED mark from it.
+      // At the end of optimization, OrigET contains all original
       // edges considered during the optimization but not swapped. Such
       // edges represent the boundary of the region involved in the 
-      // optimization. Thus we empty the list of copies and remove the
+      // optimization. Thus we empty the table and remove the
       // COPIED mark from original edges. This last operation can be
       // done while traversing the influence region marked as TO_DELETE
       // in function ExtDelBaseDelInflRegn.
       // The optimization may coniser an original edge outside the region 
-      // of influence. It is necessary to save a copy of original 
+      // of influence. It is necessary to save its original 
       // topological relations before its two original adjacent triangles
       // are modified. During optimization, before an edge is swapped,
       // we compute the quadrilateral and, if the edges of the quadrilateral
-      // are original and not in OrigEdgList, we insert them in OrigEdgList
+      // are original and not in OrigET, we save them in OrigET
       // and mark them as COPIED.
+      // The table is emptied, not deallocated, after each update.
       // See also comments in function ExtSwapEdge.
-      TDoubleList<TEdge> OrigEdgList;
+      TEdgeETMap OrigET;
 
       // VIDs of already removed vertices
-      TDoubleList<int> RemovedVertexIndex;
+      TDoubleList<TIndex> RemovedVertexIndex;
 
       // Number of vertices already removed from the triangulation
-      int nRemovedVertex;
+      TIndex nRemovedVertex;
       
-      // Array of pointers to the constraints
-      PTEdge *Constraints;
+      // Set of the constraints, NULL if they are stored only as
+      // CONSTRAINED marks (see SetConstraintStorage).
+      PTConstraintSet ConstrSet;
       
       // Number of constraints present in input file (.tac)
-      int nConstrInFile;
+      TIndex nConstrInFile;
       
       // Number of constraints currently present in the triangulation
-      int nConstrInTRI;  
+      TIndex nConstrInTRI;  
 							      
       // NOTE: the input file may cointain "wrong" constraints,
       // not corresponding to an edge of the triangulation.
@@ -181,12 +184,14 @@ class TDecCDT : virtual public TDecimDelaunay
       // Functions required for the insertion of a constraint
       // (Add_Constraint) 
       boolean OkConstrDegree( PTVertex V );
+      double ChainDeviation( PTVertex V );
       virtual boolean ReCheckVertex( PTVertex );
       int IsEdgeAdmissible( PTVertex V1, PTVertex V2 );
       void Edge2Constraint( PTEdge E );
+      void MT_InitialConstraints();
       void AdjustBordersVertices_VE( TDoubleList<PTEdge> Border );
       virtual void Delete_Constr_InfluenceRegion( PTEdge newConstr );
-      void TTra_Add_Constraint( PTVertex v0, PTVertex v1 );
+      PTEdge TTra_Add_Constraint( PTVertex v0, PTVertex v1 );
       virtual void UpdateStep();
 
       // Functions required for the extension of optimization
@@ -194,23 +199,22 @@ class TDecCDT : virtual public TDecimDelaunay
       // to manage the removal of constraints in case of vertices
       // with constraints incident in them.
       void ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge constr1, PTEdge constr2,
-                          boolean & closed, TDoubleList<TEdge> &OrigEdgList);
-      void ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge constraint,
-                          TDoubleList<TEdge> &OrigEdgList );
+                          boolean & closed, TEdgeETMap &OrigET);
+      void ExtRIRIPrepare(TDoubleList<PTEdge> & SwapEdgeQueue, PTEdge constraint );
       void Constraint2Edge( PTEdge E );
 
       void ExtRIRInitialTrg( TDoubleList<PTEdge> & InflRegnBorder,
                              TDoubleList<PTEdge> & SwapEdgeQueue   );
 
-      void ExtRIRDelOptTrg(TDoubleList<PTEdge> & SwapEdgeQueue, TDoubleList<TEdge> &OrigEdgList);
-      PTEdge ExtSwapEdge( PTEdge &E, TDoubleList<TEdge> &OrigEdgList );
+      void ExtRIRDelOptTrg(TDoubleList<PTEdge> & SwapEdgeQueue, TEdgeETMap &OrigET);
+      PTEdge ExtSwapEdge( PTEdge &E, TEdgeETMap &OrigET );
 
       void ExtDeleteInfluenceRegion( TDoubleList<PTEdge> & InflRegnBorder );
       void RecheckOptimizedRegion();
       void ExtMT_AddComponent();
       void Del_InflRegnBorder( TDoubleList<PTEdge> & InflRegnBorder );
       void ExtDelBaseDelInflRegn();
-      void ReconstructET( PTEdge E, TDoubleList<TEdge> &OrigEdgList );
+      void ReconstructET( PTEdge E, TEdgeETMap &OrigET );
 
 
       void CheckEdgeInflBorder( PTEdge E, TDoubleList<PTEdge> &border);
@@ -221,11 +225,16 @@ class TDecCDT : virtual public TDecimDelaunay
 
  
       int  Tra_intersect( PTEdge e1, PTEdge e2 );
+      int  Tra_intersect( PTSegment s1, PTEdge e2 );
+      // Intersection test between E and the three edges of T, results
+      // in Res; return the number of edges intersecting E.
+      int  Tra_intersect( PTEdge E, PTTriangle T, int *Res );
+      int  Tra_intersect( PTSegment S, PTTriangle T, int *Res );
       void Tra_intersect_test();
 
       void  Tra_Add_Constraint( PTVertex V1, PTVertex V2 );
-      boolean CalcEdgInflRegn( PTEdge newConstr, TDoubleList<PTEdge> &Right_Border,
-                    TDoubleList<PTEdge> &Left_Border, PTEdge & origEdg  );
+      boolean CalcEdgInflRegn( PTVertex v0, PTVertex v1, TDoubleList<PTEdge> &Right_Border,
+                    TDoubleList<PTEdge> &Left_Border, PTEdge & Edg  );
 
       boolean IsNewConstrOK( PTVertex );
       boolean OldIsNewConstrOK( PTVertex );
@@ -240,41 +249,51 @@ class TDecCDT : virtual public TDecimDelaunay
 
       void ReadConstraints( ifstream & );
 
+      // Checkpoints: the constraints are the edges marked CONSTRAINED,
+      // the counters and the removed vertices are added to the state.
+      virtual void SaveState( RTCheckpoint );
+      virtual void LoadState( RTCheckpoint );
+
        
       // Since the filtering function used more often is EqualsEV,
       // this is used as a default argument for the 
       // function pointer parameter filterFun.
       int FindEdgesInVE( PTVertex V, PTEdge filter, TDoubleList<PTEdge> & filtered, PF1b2PTEdge filterFun /*= EqualsEV*/);
       int FindEdgesInVE( PTVertex V, PTEdge filter, TDoubleList<PTEdge> & filtered);
+      int MatchEdgesInVE( PTVertex V, PTEdge filter, TDoubleList<PTEdge> *filtered,
+                          PTEdge & Match );
 
       int FindConstraintsInVE( PTVertex V, TDoubleList<PTEdge> & IncConstr);
 
       static boolean (EqualsEV)( PTEdge PTE1, PTEdge PTE2 );
+      static boolean (EqualsEV)( PTSegment S, PTEdge E );
       static boolean (EqualsMarkConstrained)( PTEdge PTE1, PTEdge PTE2 )
       { return PTE1->Marked(CONSTRAINED) && PTE2->Marked(CONSTRAINED); }
 
-      PTEdge FindEdgeInVE( PTVertex V, PTEdge Edge2find );
-      PTEdge FindConstraintInVE( PTVertex V, PTEdge constraint );
+      // Edge of endpoints V and W, NULL if not present.
+      PTEdge EdgeInVE( PTVertex V, PTVertex W );
+
+      PTEdge FindEdgeInVE( PTVertex V, PTVertex W );
+      PTEdge FindConstraintInVE( PTVertex V, PTVertex W );
 
-   #ifdef array_Constraints
-       virtual void WriteData( const char *outfname  ) 
-       {  // WriteData1: rename in WriteData to use this one
-          #ifdef DEBUG3
-             DEBUG3 << "\nTDecCDT::WiteData1(" << outfname << ")" << endl;
-          #endif
-			 TDecimDelaunay::WriteData(outfname);
-          cerr << "output " << nPts << " vertices, " << nPts-nRemovedVertex << " vertices still present in triangulation.\n";
-			 WriteConstraints( outfname );
-		 };
-   #else
-       virtual void WriteData( const char *outfname  );  
-       // WriteData2: rename in WriteData to use this one
-   #endif
+      virtual void WriteData( const char *outfname  );
 
-      virtual void ConvertData(int *vNum, int *tNum, int *eNum,
-                               float **vData, int **tData, int **eData);
+      // WriteData writes constraints with the triangles, and so do
+      // the levels of detail
+      virtual boolean HasConstraints() { return( TRUE ); };
 
-      void WriteConstraints( const char *outfname  );
+      virtual void ConvertData(TIndex *vNum, TIndex *tNum, TIndex *eNum,
+                               float **vData, TIndex **tData, TIndex **eData);
+
+      // Put in E the constraints of ConstrSet, sorted on the final VIDs
+      // of their endpoints, and return their number.
+      TIndex ListConstraints( PTEdge *E );
+
+      // Write the number of constraints and their vertices on outFile.
+      // The constraints are taken from array E, filled by visiting the
+      // triangulation (its edges are marked as VISITED, and unmarked
+      // here) or by ListConstraints.
+      void WriteConstraints( ofstream &outFile, PTEdge *E );
 
 
    public:
@@ -282,6 +301,17 @@ class TDecCDT : virtual public TDecimDelaunay
        TDecCDT( int iK, PMTTracer iMT );
        TDecCDT( int iK, PMTTracer iMT, boolean EXTActive, boolean ALLOWFeaturesDel, boolean ALLOWChainBrk );
 
+       // Choose how constraints are stored (CONSTR_MARKS or CONSTR_SET,
+       // see defs.h); to be called before BuildTriangulation(). With
+       // a set, the output lists the constraints sorted on their VIDs
+       // instead of in the order of the visit.
+       void SetConstraintStorage( int mode );
+
+       // Vertices with two incident constraints are removable only if
+       // the deviation of their chain stays within Tol; their error, in
+       // error-driven decimation, is increased by such deviation.
+       void SetChainTolerance( double Tol ) { ChainTol = Tol; };
+
 };
 
 
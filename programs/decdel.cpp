@@ -57,6 +57,30 @@ TDecimDelaunay::TDecimDelaunay( int iK, PMTTracer iMT ) : TDestroyDelaunay( iK),
 }
 
 
+// -----------------------------------------------------------------------------
+//  
+//  void TDecimDelaunay::SaveState( RTCheckpoint C )
+//  void TDecimDelaunay::LoadState( RTCheckpoint C )
+//
+//  A checkpoint is taken after the initial triangulation, which is not
+//  built again when resuming.
+//
+
+void TDecimDelaunay::SaveState( RTCheckpoint C )
+{
+   TDestroyDelaunay::SaveState( C );
+   MT->SaveState( C );
+}
+
+
+void TDecimDelaunay::LoadState( RTCheckpoint C )
+{
+   TDestroyDelaunay::LoadState( C );
+   MT->LoadState( C );
+   InitialPhase = FALSE;
+}
+
+
 // -----------------------------------------------------------------------------
 //  
 //  void TDecimDelaunay::InitialTriangulation()
@@ -198,11 +222,19 @@ void TDecimDelaunay::AddTriangle( PTTriangle T )
 {
    TDestroyDelaunay::AddTriangle( T );
    T->Mark( NEW_TRIANGLE );   
+   if ( ! InitialPhase ) NewTrgs.Add( T );
 }
 
 
 void TDecimDelaunay::DetachTriangle( PTTriangle T )
 {
+   //
+   // a triangle created and deleted within the same update step
+   // never reaches the MT
+   //
+
+   if ( ! InitialPhase && T->Marked( NEW_TRIANGLE ) ) NewTrgs.RemoveObject( T );
+
    TDestroyDelaunay::DetachTriangle( T );
    
    while ( ! T->PointList.IsEmpty() )
@@ -237,7 +269,8 @@ void TDecimDelaunay::EndTriangulation()
     //
     
     PTTriangle *TrgArray;
-    int it, i;
+    TIndex it;
+    int i;
 
     TrgArray = new PTTriangle[ nTrg ];
         
@@ -325,86 +358,54 @@ void TDecimDelaunay::MT_Initial()
     //
     // Triangles created during construction of the initial triangulation
     // are still marked as NEW_TRIANGLE (DeleteInfluenceRegion does not
-    // unmark them). We can call MT_AddComponent().
+    // unmark them), but have not been recorded in NewTrgs. Collect them,
+    // then we can call MT_AddComponent().
     //
     
+    CollectNewTriangles();
     MT_AddComponent();
     
 }
 
 
 //
-// INPUT: FirstTrgToDel points to an old triangle of the influence region,
-// the old triangles are all marked as TO_DELETE.
-//
-// ALGORITHM: traverse the old triangles of the region of influence through 
-// adjacency navigation, and call MT->KillTriangle(T) for each of such
-// triangles; mark TO_DELETE is not removed since it is needed later in 
-// TBuildDelaunay::DeleteInfluenceRegion().
+// ALGORITHM: collect the old triangles of the region of influence into
+// OldTrgs, and call MT->KillTriangle(T) for each of such triangles. 
+// They are deleted later, from the same buffer, by
+// TDelaunayBase::DeleteInfluenceRegion().
 //
 
 void TDecimDelaunay::MT_KillInterference()
 {
 
+   TIndex i;
+
    #ifdef MT_DEBUG
      MT_DEBUG << endl << "MT_KillInterference: eliminate V" << VertexToRemove->VID 
           << ": " << VertexToRemove->x << ", " << VertexToRemove->y << ", " << VertexToRemove->z
           << " => Potential Error : " << VertexToRemove->Error << endl;
    #endif
 
+   CollectInfluenceRegion();
 
-   if ( FirstTrgToDel != NULL )
-   {
-   
-      #ifdef ROBUST
-         check( (! FirstTrgToDel->Marked( TO_DELETE ) ),
-            "TDecimDelaunay::MT_KillInterference(), inconsistency detected" );
-      #endif
-
-      TDoubleList<PTTriangle> Triangles;
-      
-      FirstTrgToDel->Mark( MT_DELETED );
-      Triangles.AddHead( FirstTrgToDel );
-      
-      while( !Triangles.IsEmpty() )
-      {
-          PTTriangle T = Triangles.RemoveHead();
-          PTTriangle TT[3];
-      
-          // do not remove mark TO_DELETE, it is needed in 
-          //    TBuildDelaunay::DeleteInfluenceRegion()
-      
-          T->GetTT( TT[0], TT[1], TT[2] );
-      
-          MT->KillTriangle( T );
-      
-          for( int t=0; t<3; t++ )
-             if ( TT[t] != NULL && TT[t]->Marked( TO_DELETE ) 
-                  && ! TT[t]->Marked( MT_DELETED ) )
-                  {  
-                     TT[t]->Mark( MT_DELETED );
-	             Triangles.AddTail( TT[t] );
-                  }
-		     
-      }
-      
-   }
+   for( i=0; i<OldTrgs.Count(); i++ )
+      MT->KillTriangle( OldTrgs[i] );
    
 }
 
 //
-// INPUT: FirstTriangle points to a new triangle of the just re-triangulated
-// influence region; the new triangles of the influence region are all
-// marked as NEW_TRIANGLE.
+// INPUT: NewTrgs contains the new triangles of the just re-triangulated
+// influence region, all marked as NEW_TRIANGLE.
 //
-// ALGORITHM: traverse the new triangles of the region of influence through
-// adjacency navigation, and call MT->MakeTriangle(T) for each of such
-// triangles; at the end of traversal, call MT->MeshOk().
+// ALGORITHM: call MT->MakeTriangle(T) for each of such triangles and
+// unmark it; then empty NewTrgs and call MT->MeshOk().
 //
 
 void TDecimDelaunay::MT_AddComponent()
 {
 
+   TIndex i;
+
    #ifdef MT_DEBUG
       if( VertexToRemove == NULL )
          MT_DEBUG << "TDecimDelaunay::MT_AddComponent() to record initial triangulation\n";
@@ -412,38 +413,16 @@ void TDecimDelaunay::MT_AddComponent()
          MT_DEBUG << "TDecimDelaunay::MT_AddComponent() to record re-triangulation after deleting V" << VertexToRemove->VID << endl;
    #endif
 
-
    #ifdef ROBUST
-      check( (FirstTriangle == NULL || !FirstTriangle->Marked( NEW_TRIANGLE )),
-             "TDecimDelaunay::MT_AddComponent(), inconsistency detected" );
+      check( NewTrgs.IsEmpty(), "TDecimDelaunay::MT_AddComponent(), inconsistency detected" );
    #endif
      
-   TDoubleList<PTTriangle> Triangles;
-     
-   FirstTriangle->UnMark( NEW_TRIANGLE );
-   Triangles.AddHead( FirstTriangle );
-   
-   while ( ! Triangles.IsEmpty() )
+   for( i=0; i<NewTrgs.Count(); i++ )
    {
-      PTTriangle T = Triangles.RemoveHead();
-      PTTriangle TT[3];
-
-      T->GetTT( TT[0], TT[1], TT[2] );
-
-      double Error = 0.0;  
-      Error = Error;  //  to avoid a warning
-      if ( ! T->PointList.IsEmpty() ) Error = T->PointList.GetHead()->Error;
-
-      MT->MakeTriangle( T );
-      
-      for( int t=0; t<3; t++ )
-         if ( TT[t] != NULL && TT[t]->Marked( NEW_TRIANGLE ) )
-         {
-            TT[t]->UnMark( NEW_TRIANGLE );
-	    Triangles.AddTail( TT[t] );
-         }
-      
+      NewTrgs[i]->UnMark( NEW_TRIANGLE );
+      MT->MakeTriangle( NewTrgs[i] );
    }
+   NewTrgs.Clear();
       
    MT->MeshOk();
   
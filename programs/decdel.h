@@ -92,6 +92,14 @@ class TDecimDelaunay : public TDestroyDelaunay
       virtual boolean NoMoreUpdates()
         { return( ElimVtxTree.IsEmpty() || MT->TerminateCondition() ); };
 
+      virtual int NextLevel() { return( MT->LodReached() ); };
+
+      virtual void StartBudgets() { MT->StartClock(); };
+
+      // Checkpoints: the history is added to the state.
+      virtual void SaveState( RTCheckpoint );
+      virtual void LoadState( RTCheckpoint );
+
       virtual void RepositionPoint( PTPoint );
       
       virtual void AddTriangle( PTTriangle );
@@ -101,7 +101,7 @@ void TDecErrCDT::InitialTriangulation()
       DEBUG << "\nTDecErrCDT::InitialTriangulation()" << endl;
    #endif
        
-   for( int v=0; v<nPts; v++ )
+   for( TIndex v=0; v<nPts; v++ )
    {
 
       if( ((PTVertex) Points[v])->VE[0] != NULL )
@@ -123,6 +123,7 @@ void TDecErrCDT::InitialTriangulation()
    // Since TDecCDT inherits from both TDecimDelaunay and TRefCDTDelaunay
    // it is necessary to specify the base class
 
+   MT_InitialConstraints();
    TDecimDelaunay::MT_Initial();
 
    TDecimDelaunay::InitialPhase = FALSE;
@@ -150,3 +151,25 @@ boolean TDecErrCDT::ReCheckVertex( PTVertex V )
    else
       return(FALSE);
 }
+
+
+// ----------------------------------------------------------------------------
+// 
+//  void TDecErrCDT::RecalcVertexError( PTVertex V )
+//
+//  If a budget on the deviation of chains is set (see
+//  TDecCDT::SetChainTolerance), the error of a vertex inside a chain of
+//  constraints is its vertical error plus the deviation of the chain
+//  after its removal, so that the vertices whose removal leaves a chain
+//  close to the original one come first. Such deviation is read from
+//  the two incident constraints, and is updated with the vertical error
+//  each time V is rechecked.
+//
+
+void TDecErrCDT::RecalcVertexError( PTVertex V )
+{
+   TDecErrDelaunay::RecalcVertexError( V );
+
+   if ( ChainTol >= 0.0 && V->nIncConstr == 2 )
+      V->Error += ChainDeviation( V );
+}
@@ -81,6 +81,10 @@ class TDecErrCDT : public TDecCDT, public TDecErrDelaunay
       virtual void InitialTriangulation();
 
       virtual boolean ReCheckVertex( PTVertex );
+
+      // Vertical error, plus the deviation of the chain of constraints
+      // if V is inside a chain and a chain budget is set.
+      virtual void RecalcVertexError( PTVertex );
 /*
       virtual void RecalcVertexError( PTVertex );
       virtual void RecalcVertexErrorApprox( PTVertex );
@@ -100,3 +100,40 @@ void TDecErrDeBerg::NextVertex()
     #endif
 
 }
+
+
+// ---------------------------------------------------------------------------------
+//
+//  void TDecErrDeBerg::SaveState( RTCheckpoint C )
+//  void TDecErrDeBerg::LoadState( RTCheckpoint C )
+//
+//  The vertices of list DeBergVertices, which have already been taken
+//  out of ElimVtxTree, are saved in their order of removal.
+//
+
+void TDecErrDeBerg::SaveState( RTCheckpoint C )
+{
+    TDoubleListIterator<PTVertex> I( &DeBergVertices );
+
+    TDecErrDelaunay::SaveState( C );
+
+    C.PutIndex( DeBergVertices.Lenght() );
+    while( !I.EndOfList() )
+    {
+       SavePoint( C, I.Current()->object );
+       I.GoNext();
+    }
+}
+
+
+void TDecErrDeBerg::LoadState( RTCheckpoint C )
+{
+    TIndex i, n;
+
+    TDecErrDelaunay::LoadState( C );
+
+    DeBergVertices.ClearList();
+    n = C.GetIndex();
+    for( i=0; i<n; i++ )
+       DeBergVertices.AddTail( (PTVertex)LoadPoint( C ) );
+}
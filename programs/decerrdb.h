@@ -54,6 +54,11 @@ class TDecErrDeBerg : public TDecErrDelaunay
    protected:
 
       TDoubleList<PTVertex> DeBergVertices;
+
+      // Checkpoints: the vertices of the current independent set,
+      // which are no longer in ElimVtxTree, are added to the state.
+      virtual void SaveState( RTCheckpoint );
+      virtual void LoadState( RTCheckpoint );
       
    public:
    
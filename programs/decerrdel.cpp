@@ -86,7 +86,7 @@ TDecErrDelaunay::TDecErrDelaunay( int iK, PMTTracer iMT, int iRecalcError )
 
 void TDecErrDelaunay::InitialTriangulation()
 {
-    int v;
+    TIndex v;
 
     #ifdef DEBUG
        DEBUG << "TDecErrDelaunay::InitialTriangulation()" << endl;
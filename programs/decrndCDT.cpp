@@ -77,7 +77,7 @@ void TDecRndCDT::InitialTriangulation()
        
    srand48( (int) time(NULL) );
 
-   for( int v=0; v<nPts; v++ )
+   for( TIndex v=0; v<nPts; v++ )
    {
 
       if( ((PTVertex) Points[v])->VE[0] != NULL ) 
@@ -98,6 +98,7 @@ void TDecRndCDT::InitialTriangulation()
    // Since TDecCDT inherits from both TDecimDelaunay and TRefCDTDelaunay
    // it is necessary to specify the base class
 
+   MT_InitialConstraints();
    TDecimDelaunay::MT_Initial();         
                                          
    TDecimDelaunay::InitialPhase = FALSE; 
@@ -103,3 +103,53 @@ void TDecRndDeBerg::NextVertex()
     #endif
 
 }
+
+
+// ---------------------------------------------------------------------------------
+//
+//  void TDecRndDeBerg::SaveState( RTCheckpoint C )
+//  void TDecRndDeBerg::LoadState( RTCheckpoint C )
+//
+//  void TDecRndDeBerg::SaveDeBergVertices( RTCheckpoint C )
+//  void TDecRndDeBerg::LoadDeBergVertices( RTCheckpoint C )
+//
+//  The vertices of list DeBergVertices, which have already been taken
+//  out of ElimVtxTree, are saved in their order of removal.
+//
+
+void TDecRndDeBerg::SaveDeBergVertices( RTCheckpoint C )
+{
+    TDoubleListIterator<PTVertex> I( &DeBergVertices );
+
+    C.PutIndex( DeBergVertices.Lenght() );
+    while( !I.EndOfList() )
+    {
+       SavePoint( C, I.Current()->object );
+       I.GoNext();
+    }
+}
+
+
+void TDecRndDeBerg::LoadDeBergVertices( RTCheckpoint C )
+{
+    TIndex i, n;
+
+    DeBergVertices.ClearList();
+    n = C.GetIndex();
+    for( i=0; i<n; i++ )
+       DeBergVertices.AddTail( (PTVertex)LoadPoint( C ) );
+}
+
+
+void TDecRndDeBerg::SaveState( RTCheckpoint C )
+{
+    TDecRndDelaunay::SaveState( C );
+    SaveDeBergVertices( C );
+}
+
+
+void TDecRndDeBerg::LoadState( RTCheckpoint C )
+{
+    TDecRndDelaunay::LoadState( C );
+    LoadDeBergVertices( C );
+}
@@ -57,6 +57,14 @@ class TDecRndDeBerg : public TDecRndDelaunay
    protected:
 
       TDoubleList<PTVertex> DeBergVertices;
+
+      // Checkpoints: the vertices of the current independent set,
+      // which are no longer in ElimVtxTree, are added to the state.
+      void SaveDeBergVertices( RTCheckpoint );
+      void LoadDeBergVertices( RTCheckpoint );
+
+      virtual void SaveState( RTCheckpoint );
+      virtual void LoadState( RTCheckpoint );
       
    public:
    
@@ -31,14 +31,15 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //  removed.
 //  To this aim, procedure DeBerg::SelectVertices of class DeBerg is used
 //  (files: deberg.h/deberg.cpp).
-//  The only re-implemented functions are NoMoreUpdates (implemented
-//  inline in file decrnddbCDT.h) and NextVertex().
+//  Re-implemented functions are NoMoreUpdates and NextVertex(), and
+//  those of the parallel removal of the vertices of a set.
 //
 
 
 
 #include "defs.h"
 #include "error.h"
+#include "geom.h"
 #include "ttriang.h"
 
 #include "tbtree.h"
@@ -51,16 +52,40 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 // ---------------------------------------------------------------------------------
 //
-//  void TDecRndDeBergCDT::NextVertex()
+//  boolean TDecRndDeBergCDT::NoMoreUpdates()
 //
-//  Choose the next vertex in the following way: if there is still some
-//  vertex in list DeBergVertices, take the head of such list;
-//  otherwise, by calling DeBerg::SelectVertices(), create a new list
-//  of independent removable vertices and take the head of such new list.
+//  The vertices of the current set that are no longer removable are
+//  dropped first: the removal of the previous ones may have changed
+//  their constraints or degree even if they are independent (e.g., a
+//  new constraint that makes their own new constraint not admissible).
+//  Also, the extension of optimization, or with plain sets the region
+//  of influence of a new constraint, which is not bounded by the 1-ring,
+//  may have put them back in ElimVtxTree.
 //
 
+boolean TDecRndDeBergCDT::NoMoreUpdates()
+{
+    while( !DeBergVertices.IsEmpty() )
+    {
+       PTVertex V = DeBergVertices.GetHead();
+
+       if ( ElimVtxTree.IsIn( V ) ) ElimVtxTree.Remove( V );
+       if ( ReCheckVertex( V ) ) break;
+       DeBergVertices.RemoveHead();
+    }
+
+    return( TDecRndDeBerg::NoMoreUpdates() );
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//  void TDecRndDeBergCDT::NextVertex()
+//
+//  As TDecRndDeBerg::NextVertex(), but with DeBerg::SelectVerticesCDT if
+//  the independent sets are chain-aware or removed in parallel.
+//
 
-/* PAOLA: In .h it is commented
 void TDecRndDeBergCDT::NextVertex()
 {
 
@@ -68,43 +93,27 @@ void TDecRndDeBergCDT::NextVertex()
        DEBUG << "\nTDecRndDeBergCDT::NextVertex()" << endl;
     #endif
 
+    if ( !ChainAware && nThreads <= 1 )
+    {
+       TDecRndDeBerg::NextVertex();
+       return;
+    }
+
     #ifdef ROBUST
        check( (DeBergVertices.IsEmpty() && ElimVtxTree.IsEmpty()), 
               "TDecRndDeBergCDT::NextVertex(), <1> no more points to remove" );
     #endif
- 
- 
 
     if ( DeBergVertices.IsEmpty() )
     {
- 
-        DeBerg::SelectVertices( ElimVtxTree, DeBergVertices );
- 
- 	
-	#ifdef DEBUG
-        
-	   // show the content of DeBergVertices
-	
-	   DEBUG << "DeBergVtx : ";
-	   TDoubleListIterator<PTVertex> I( &DeBergVertices );
-	   while( !I.EndOfList() )
-	   {
-	      DEBUG << " -> V" << (I.Current()->object)->VID;
-	      I.GoNext();
-	   }
-	   DEBUG  << endl << endl;
-	
-	#endif // DEBUG
-	
-	
+        DeBerg::SelectVerticesCDT( ElimVtxTree, DeBergVertices, ExtActive, nThreads > 1 );
+
         #ifdef ROBUST
            check( (DeBergVertices.IsEmpty()),
-                "TDestroyDelaunay::NextVertex(), <2> no more points to remove" );
+                "TDecRndDeBergCDT::NextVertex(), <2> no more points to remove" );
         #endif
- 
-    } // end ...if ( DeBergVertices.IsEmpty() )
- 
-    
+    }
+
     VertexToRemove = DeBergVertices.RemoveHead();
 
     #ifdef DEBUG    
@@ -113,4 +122,256 @@ void TDecRndDeBergCDT::NextVertex()
 
 }
 
-*/
+
+// ---------------------------------------------------------------------------------
+//
+//  void TDecRndDeBergCDT::SetThreads( int n )
+//
+
+void TDecRndDeBergCDT::SetThreads( int n )
+{
+    check( (n < 1), "TDecRndDeBergCDT::SetThreads(), invalid number of threads" );
+    nThreads = n;
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//  void TDecRndDeBergCDT::CreateWorkers()
+//
+//  Create the nThreads workers, and make the identifiers of edges and
+//  triangles safe for them.
+//
+
+void TDecRndDeBergCDT::CreateWorkers()
+{
+    int i;
+
+    Workers = new PTDecRndDeBergCDT[ nThreads ];
+    check( (Workers == NULL), "TDecRndDeBergCDT::CreateWorkers(), insufficient memory" );
+
+    for( i=0; i<nThreads; i++ )
+    {
+       Workers[i] = new TDecRndDeBergCDT( KDegree, MT );
+       check( (Workers[i] == NULL), "TDecRndDeBergCDT::CreateWorkers(), insufficient memory" );
+       Workers[i]->Master = this;
+       Workers[i]->InitialPhase = FALSE;
+    }
+
+    TEdge::EIDs.SetShared( TRUE );
+    TTriangle::TIDs.SetShared( TRUE );
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//  void TDecRndDeBergCDT::UpdateStep()
+//
+//  With more threads, the vertices of the current set without incident
+//  constraints are dealt to the workers, which remove them at the same
+//  time, and the vertices on the border of their influence regions are
+//  then checked again. Vertices with incident constraints, whose removal
+//  may go beyond their star, are removed one at a time by
+//  TDecCDT::UpdateStep() once the others are done. At most the updates
+//  left before the termination or the next level of detail are dealt,
+//  and the workers stop as soon as one of them is reached: the vertices
+//  they did not remove go back to the set.
+//
+
+void TDecRndDeBergCDT::UpdateStep()
+{
+    TDoubleList<PTVertex> Others;
+    TIndex n, Left;
+    int i;
+
+    if ( nThreads <= 1 )
+    {
+       TDecRndCDT::UpdateStep();
+       return;
+    }
+
+    if ( Workers == NULL ) CreateWorkers();
+
+    if ( DeBergVertices.IsEmpty() )
+       DeBerg::SelectVerticesCDT( ElimVtxTree, DeBergVertices, ExtActive, TRUE );
+
+    Left = MT->UpdatesLeft();
+    n = 0;
+    while( !DeBergVertices.IsEmpty() )
+    {
+       PTVertex V = DeBergVertices.RemoveHead();
+
+       if ( V->nIncConstr > 0 || n == Left )
+          Others.AddTail( V );
+       else
+       {
+          if ( ElimVtxTree.IsIn( V ) ) ElimVtxTree.Remove( V );
+          if ( ReCheckVertex( V ) ) Workers[ n++ % nThreads ]->DeBergVertices.AddTail( V );
+       }
+    }
+    while( !Others.IsEmpty() )
+       DeBergVertices.AddTail( Others.RemoveHead() );
+
+    if ( n == 0 )
+    {
+       if ( !DeBergVertices.IsEmpty() || !ElimVtxTree.IsEmpty() )
+          TDecRndCDT::UpdateStep();
+       return;
+    }
+
+    for( i=0; i<nThreads; i++ )
+       check( (pthread_create( &Workers[i]->Thread, NULL, WorkerMain, Workers[i] ) != 0),
+              "TDecRndDeBergCDT::UpdateStep(), cannot create thread" );
+    for( i=0; i<nThreads; i++ )
+       pthread_join( Workers[i]->Thread, NULL );
+
+    //
+    // collect the results of the workers
+    //
+
+    for( i=nThreads-1; i>=0; i-- )
+    {
+       PTDecRndDeBergCDT W = Workers[i];
+
+       while( !W->DeBergVertices.IsEmpty() )
+          DeBergVertices.AddHead( W->DeBergVertices.RemoveHead() );
+
+       while( !W->Recheck.IsEmpty() )
+       {
+          PTVertex V = W->Recheck.RemoveHead();
+
+          if ( ElimVtxTree.IsIn( V ) ) ElimVtxTree.Remove( V );
+          if ( ReCheckVertex( V ) ) ElimVtxTree.Insert( V );
+       }
+
+       while( !W->RemovedVertexIndex.IsEmpty() )
+          RemovedVertexIndex.AddTail( W->RemovedVertexIndex.RemoveHead() );
+       nRemovedVertex += W->nRemovedVertex;
+       W->nRemovedVertex = 0;
+
+       // the last triangle created by a worker is not deleted by the others
+       nTrg += W->nTrg;
+       W->nTrg = 0;
+       if ( W->FirstTriangle != NULL ) FirstTriangle = W->FirstTriangle;
+       W->FirstTriangle = NULL;
+    }
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//  void *TDecRndDeBergCDT::WorkerMain( void *W )
+//  void TDecRndDeBergCDT::RemoveVertices()
+//
+//  Body of the thread of a worker: remove the vertices given by the
+//  master, until the termination condition or a level of detail is
+//  reached.
+//
+
+void *TDecRndDeBergCDT::WorkerMain( void *W )
+{
+    ((PTDecRndDeBergCDT)W)->RemoveVertices();
+    return( NULL );
+}
+
+
+void TDecRndDeBergCDT::RemoveVertices()
+{
+    boolean Stop = FALSE;
+
+    while( !Stop && !DeBergVertices.IsEmpty() )
+    {
+       pthread_mutex_lock( &Master->Lock );
+       Stop = ( MT->TerminateCondition() || MT->LodPending() );
+       pthread_mutex_unlock( &Master->Lock );
+
+       if ( !Stop )
+       {
+          VertexToRemove = DeBergVertices.RemoveHead();
+          RemoveVertex();
+       }
+    }
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//  void TDecRndDeBergCDT::RepositionPoint( PTPoint P )
+//
+//  In a worker, the point is in the re-triangulated influence region,
+//  i.e., in one of the new triangles: they are searched instead of
+//  walking from FirstTriangle, which may cross the regions being changed
+//  by the other workers.
+//
+
+void TDecRndDeBergCDT::RepositionPoint( PTPoint P )
+{
+    PTVertex V[3];
+    TIndex i;
+    int j, Aligned, Turn;
+
+    if ( Master == NULL )
+    {
+       TDecRndCDT::RepositionPoint( P );
+       return;
+    }
+
+    for( i=0; i<NewTrgs.Count(); i++ )
+    {
+       NewTrgs[i]->GetTV( V[0], V[1], V[2] );
+
+       for( j=0; j<3; j++ )
+          if ( P->Equalsxy( V[j] ) )
+             error( "TDecRndDeBergCDT::RepositionPoint(), duplicate point" );
+
+       // after GetTV, TE[j] is the edge of endpoints V[j], V[(j+1)%3]
+       Aligned = -1;
+       for( j=0; j<3; j++ )
+       {
+          Turn = Geom::Turnxy( V[j], V[(j+1)%3], P );
+          if ( Turn == TURN_RIGHT ) break;
+          if ( Turn == ALIGNED ) Aligned = j;
+       }
+       if ( j < 3 ) continue;
+
+       if ( Aligned == -1 ) NewTrgs[i]->AddPoint( P );
+       else NewTrgs[i]->TE[Aligned]->AddPoint( P );
+       return;
+    }
+
+    error( "TDecRndDeBergCDT::RepositionPoint(), point outside the influence region" );
+}
+
+
+// ---------------------------------------------------------------------------------
+//
+//  void TDecRndDeBergCDT::DeleteInfluenceRegion()
+//  boolean TDecRndDeBergCDT::ReCheckVertex( PTVertex V )
+//
+//  In a worker, the update is recorded in the MT tracer under the lock
+//  of the master, and the vertices of the border of the influence region
+//  are checked again by the master, after the workers are done: the
+//  admissibility of a new constraint is tested beyond the star of V.
+//
+
+void TDecRndDeBergCDT::DeleteInfluenceRegion()
+{
+    if ( Master == NULL )
+    {
+       TDecRndCDT::DeleteInfluenceRegion();
+       return;
+    }
+
+    pthread_mutex_lock( &Master->Lock );
+    TDecRndCDT::DeleteInfluenceRegion();
+    pthread_mutex_unlock( &Master->Lock );
+}
+
+
+boolean TDecRndDeBergCDT::ReCheckVertex( PTVertex V )
+{
+    if ( Master == NULL ) return( TDecRndCDT::ReCheckVertex( V ) );
+
+    Recheck.AddTail( V );
+    return( FALSE );
+}
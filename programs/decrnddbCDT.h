@@ -30,7 +30,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //  removal of independent vertices and a random choice of vertices to be
 //  removed.
 //  To this aim, procedure DeBerg::SelectVertices of class DeBerg is used
-//  (files: deberg.h/deberg.cpp).
+//  (files: deberg.h/deberg.cpp), or DeBerg::SelectVerticesCDT if the
+//  independent sets must account for chains of constraints.
+//  The vertices of a set without incident constraints may be removed
+//  by more threads at the same time (see SetThreads).
 //
 
 
@@ -38,6 +41,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef _DECRNDDEBCDT_H
 #define _DECRNDDEBCDT_H
 
+#include <pthread.h>
+
 
 #include "defs.h"
 #include "ttriang.h"
@@ -58,10 +63,49 @@ typedef class TDecRndDeBergCDT &RTDecRndDeBergCDT;
 #include "decrnddb.h"
 class TDecRndDeBergCDT : public TDecRndCDT, public TDecRndDeBerg
 {
+   private:
+
+      // TRUE if vertices are selected by DeBerg::SelectVerticesCDT.
+      boolean ChainAware;
+
+      //
+      // Parallel removal. The master (the triangulation built by the
+      // program) gives the vertices of a set to nThreads workers,
+      // objects of this class that only remove vertices: all their
+      // state (influence region, new triangles, detached points...) is
+      // their own, while the triangulation, the MT tracer and the
+      // edge / triangle identifiers are shared.
+      //
+
+      // Number of threads (1 = no parallel removal).
+      int nThreads;
+
+      // (master) The workers, created at the first parallel step, and
+      // the lock on the MT tracer, held by the workers while they
+      // record an update.
+      PTDecRndDeBergCDT *Workers;
+      pthread_mutex_t Lock;
+
+      // (worker) The master, the thread running this worker, and the
+      // vertices whose star has changed, to be checked again by the
+      // master (ReCheckVertex reads beyond the star).
+      PTDecRndDeBergCDT Master;
+      pthread_t Thread;
+      TDoubleList<PTVertex> Recheck;
+
+      void CreateWorkers();
+      static void *WorkerMain( void * );
+      void RemoveVertices();
+
    public:
       TDecRndDeBergCDT( int iK, PMTTracer iMT ) 
 	      : TDecRndCDT( iK, iMT ), TDecRndDeBerg( iK, iMT ), TDecimDelaunay( iK, iMT )
 	{
+		ChainAware = FALSE;
+		nThreads = 1;
+		Workers = NULL;
+		Master = NULL;
+		pthread_mutex_init( &Lock, NULL );
 		// #ifdef DEBUG
 		 cout << "TDecRndDeBergCDT Constructor" << endl;
 		// #endif
@@ -72,14 +116,47 @@ class TDecRndDeBergCDT : public TDecRndCDT, public TDecRndDeBerg
             TDecRndDeBerg( iK, iMT ),
             TDecimDelaunay( iK, iMT )
         {
+		ChainAware = FALSE;
+		nThreads = 1;
+		Workers = NULL;
+		Master = NULL;
+		pthread_mutex_init( &Lock, NULL );
 		// #ifdef DEBUG
 		 cout << "TDecRndDeBergCDT(Options) Constructor" << endl;
 		// #endif
 	};
 
+	// Select independent sets which account for chains of constraints
+	// and for the extension of optimization (see DeBerg::SelectVerticesCDT).
+	void SetChainAware( boolean CA ) { ChainAware = CA; };
+
+	// Remove the vertices of a set without incident constraints with n
+	// threads. The sets are then chosen with disjoint conflict zones
+	// (DeBerg::SelectVerticesCDT with Disjoint), so that the removals
+	// done at the same time change disjoint parts of the triangulation;
+	// the other vertices of a set are removed afterwards, one at a time.
+	// The order of the updates, and so the output, may change from a
+	// run to another, and a termination on error, time, memory or
+	// number of triangles may be passed by at most n-1 updates.
+	void SetThreads( int n );
+
 	protected:
 		virtual void InitialTriangulation() { TDecRndCDT::InitialTriangulation(); };
-		virtual boolean NoMoreUpdates() { return TDecRndDeBerg::NoMoreUpdates(); }
+		virtual boolean NoMoreUpdates();
+		virtual void NextVertex();
+		virtual void UpdateStep();
+
+		// In a worker: the detached points are located among the new
+		// triangles, the update is recorded under the lock of the
+		// master, and the vertices of the border are left to the master.
+		virtual void RepositionPoint( PTPoint );
+		virtual void DeleteInfluenceRegion();
+		virtual boolean ReCheckVertex( PTVertex );
+
+		virtual void SaveState( RTCheckpoint C )
+		  { TDecRndCDT::SaveState( C ); SaveDeBergVertices( C ); };
+		virtual void LoadState( RTCheckpoint C )
+		  { TDecRndCDT::LoadState( C ); LoadDeBergVertices( C ); };
 };
 
 /*
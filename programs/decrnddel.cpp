@@ -67,7 +67,7 @@ void TDecRndDelaunay::InitialTriangulation()
        
     srand48( (int) time(NULL) );
 
-    for( int v=0; v<nPts; v++ )
+    for( TIndex v=0; v<nPts; v++ )
 	 Points[v]->Error = drand48();
 	
        
@@ -36,28 +36,59 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //
 // OUTPUT : show for instance the number of entities processed so far
 //
-// array_Constraints, mark_CONSTRAINED : decimate CDT by using the array
-//             "Constraints" or by marking edges as CONSTRAINED.
-//
 // CC_GCC, CC_SILICON, CC_VISUAL5 : one of them must be defined,
 //             according to the compiler.
 //
 // DEBUG     : show several messages on cout during computation
 //             (script show redirects such output on file "output")
 // MT_TRACER : enable generation of an MT
+// MT_NATIVE : enable generation of an MT without the MT package, written
+//             on a binary file (see mtbuild.h and mtfile.h)
+// MT_STREAM : with MT_NATIVE, write each update on the MT file as soon
+//             as it is completed, instead of keeping the whole history
+//             in memory until the end
 // MT_DEBUG  : as DEBUG, but just show which functions of the MT building
 //             interface are called.
 // ROBUST    : perform several consistency checks for problems that should
 //             not arise, but ... one can never know
 // PS_OUTPUT : output triangulation contains just x and y, no z,
 //            of its vertices
+// LARGE_INDEX : use 64-bit indices (type TIndex) for points, vertices,
+//            edges and triangles, for datasets beyond 2^31 elements
+// COMPACT_COORDS : store point coordinates as 32-bit integers on a
+//            grid of step QUANT_STEP around a tile origin, and point
+//            errors as float; this halves the size of points and makes
+//            the orientation test exact (see class TQCoord in ttriang.h)
+// PIPELINED_INPUT : in refinement, parse the input points in a separate
+//            thread and collect the candidates for the convex hull
+//            while reading (needs -lpthread)
+// PIPELINED_OUTPUT : write the intermediate triangulations (levels of
+//            detail) in a separate thread, while the updates go on
+//            (needs -lpthread)
+// PARALLEL_CLEAN : share the sweeps of the cleaning of segments (class
+//            SegClean) among CLEAN_THREADS threads (needs -lpthread)
+// CHECKPOINT : every CHECKPOINT_SECONDS, save the state of the updates
+//            on file "outfile.ckp" from a child process, and resume
+//            from such file when the same command is run again on the
+//            same input file (needs fork(); not available with
+//            MT_TRACER; off by default)
 
 
-// #define array_Constraints  1
-#define mark_CONSTRAINED  2
-
 // #define PAOLO 1
 
+// #define PIPELINED_INPUT 1
+
+#define PIPELINED_OUTPUT 1
+
+#define PARALLEL_CLEAN 1
+#define CLEAN_THREADS 4
+
+// #define CHECKPOINT 1
+
+// #define LARGE_INDEX 1
+
+// #define COMPACT_COORDS 1
+
 //#define CC_GCC  1
 // #define CC_SILICON  2
  #define CC_VISUAL5  3
@@ -76,6 +107,43 @@ const boolean TRUE = 1;
 const boolean FALSE = 0;
 
 
+//
+// Type of identifiers (PID, VID, EID, TID) and of indices and counts
+// of points, vertices, edges and triangles. With LARGE_INDEX it is a
+// long, i.e., 64 bits on LP64 platforms.
+//
+
+#ifdef LARGE_INDEX
+typedef long TIndex;
+#else
+typedef int TIndex;
+#endif
+
+
+//
+// Interval between two checkpoints, in seconds (see CHECKPOINT above).
+// It can be changed from the compiler command line.
+//
+
+#ifndef CHECKPOINT_SECONDS
+#define CHECKPOINT_SECONDS 600
+#endif
+
+
+//
+// Quantization grid used with COMPACT_COORDS. Coordinates are rounded
+// to multiples of QUANT_STEP, and must lie within QUANT_MAX steps from
+// the tile origin (the grid point nearest to the first point read).
+// QUANT_MAX is chosen so that the orientation test cannot overflow
+// a long long.
+//
+
+#ifdef COMPACT_COORDS
+const double QUANT_STEP = 1.0/1024.0;
+const int QUANT_MAX = (1<<30) - 1;
+#endif
+
+
 //
 // These constants are used in the point location process
 //
@@ -96,4 +164,24 @@ const int PL_VERTEX    = 3;     // point coincident with a vertex
 const int RECALC_APPROX = 1;
 const int RECALC_EXACT  = 2;
 
+//
+// These constants define the space-filling curve along which vertices
+// and triangles are renumbered after reading the input and before
+// writing the output. They are used in classes TTriangulation and Reorder.
+//
+
+const int REORDER_NONE    = 0;   // keep input / construction order
+const int REORDER_MORTON  = 1;   // Morton (Z-order) curve
+const int REORDER_HILBERT = 2;   // Hilbert curve
+
+//
+// These constants define how the constraints of a CDT are stored, besides
+// the CONSTRAINED marks of their edges (in class TDecCDT, chosen at run
+// time). With a set, the constraints are written without visiting the
+// triangulation.
+//
+
+const int CONSTR_MARKS = 0;   // CONSTRAINED marks only
+const int CONSTR_SET   = 1;   // also a TConstraintSet (see constrset.h)
+
 #endif // _DEFS_H
@@ -52,6 +52,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ttriang.h"
 #include "basedel.h"
 #include "destrdel.h"
+#include "reorder.h"
 
 // -------------------------------------------------------------------------
 //
@@ -164,6 +165,8 @@ void TDestroyDelaunay::ReadData( const char *infname )
    
    ReadTriangles( inFile );
 
+   ReorderInput();
+
 }
 
 
@@ -179,7 +182,7 @@ void TDestroyDelaunay::ReadData( const char *infname )
 void TDestroyDelaunay::ReadVertices( ifstream &inFile )
 {
 
-   int i;
+   TIndex i;
 
    #ifdef DEBUG
        DEBUG << "\nTDestroyDelaunay::ReadVertices()" << endl;
@@ -217,6 +220,7 @@ void TDestroyDelaunay::ReadVertices( ifstream &inFile )
        //
        
        inFile >> (*p); 
+       p->PID = i;
        
        #ifdef DEBUG
         DEBUG << "read vertex: " << (*p) << endl;
@@ -224,9 +228,40 @@ void TDestroyDelaunay::ReadVertices( ifstream &inFile )
               
        if ( i % 1000 == 0 ) cerr << "\rread " << i << " points" << flush;
        
-       Points[i] = new TVertex( p );
+       if ( ReorderMode == REORDER_NONE )
+          Points[i] = new TVertex( p );
+       else
+          Points[i] = new TPoint( *p );
        check( (Points[i] == NULL), "TDestroyDelaunay::ReadData(), insufficient memory");
        
+   }
+
+   delete p;
+
+   //
+   // If a reordering is required, create the vertices along the curve,
+   // so that vertices close in space are also close in memory.
+   // Points[i] still refers to the i-th input vertex (with VID = i),
+   // as required by ReadTriangles().
+   //
+
+   if ( ReorderMode != REORDER_NONE )
+   {
+      PTPoint *Aux = new PTPoint[nPts];
+      check( (Aux == NULL), "TDestroyDelaunay::ReadData(), insufficient memory" );
+
+      for( i=0; i<nPts; i++ ) Aux[i] = Points[i];
+      Reorder::SortPoints( Aux, nPts, ReorderMode );
+
+      for( i=0; i<nPts; i++ )
+      {
+         PTVertex V = new TVertex( Aux[i] );
+         check( (V == NULL), "TDestroyDelaunay::ReadData(), insufficient memory");
+         V->VID = Aux[i]->PID;
+         Points[V->VID] = V;
+         delete Aux[i];
+      }
+      delete[] Aux;
    }
    
     cerr << "\rread " << nPts << " points" << endl;
@@ -257,7 +292,7 @@ Some auxiliary functions are needed, which are defined below as
    plus one of its adjacent triangles. */
 typedef struct
 {
-  int ind1, ind2; /* vertex indexes of edge endpoints */
+  TIndex ind1, ind2; /* vertex indexes of edge endpoints */
   PTTriangle t;   /* one triangle adjacent to edge */
   PTEdge e;       /* the edge (it will be created later) */
 } aux;
@@ -268,7 +303,7 @@ static int cmp_aux( const void *p, const void *q )
 {
   aux *a = (aux *) p ;
   aux *b = (aux *) q ;
-  int min_a, min_b, max_a, max_b;
+  TIndex min_a, min_b, max_a, max_b;
   if ( a->ind1 < a->ind2 ) {  min_a = a->ind1; max_a = a->ind2;  }
   else {  min_a = a->ind2; max_a = a->ind1;  }
   if ( b->ind1 < b->ind2 ) {  min_b = b->ind1; max_b = b->ind2;  }
@@ -313,14 +348,15 @@ static void OrientTriangle ( PTTriangle t )
 void TDestroyDelaunay::ReadTriangles( ifstream &inFile )
 {
 
-   int e, t, v, i, k;
+   int e, v;
+   TIndex t, i, k;
    aux *triedge_vec ; /* auxiliary vector for adjacency reconstuction */
-   int triedge_ind = 0;
+   TIndex triedge_ind = 0;
 
    PTTriangle NewT;
    PTEdge NewE, TmpE;
-   int vidx[3];
-   int nt = 0;
+   TIndex vidx[3];
+   TIndex nt = 0;
    PTVertex TmpV[3];
 
    #ifdef DEBUG
@@ -362,7 +398,7 @@ void TDestroyDelaunay::ReadTriangles( ifstream &inFile )
 	  case TURN_RIGHT:
 	       {
 	          // ...swap vidx[1] e vidx[2]
-		  int vtmp = vidx[1];
+		  TIndex vtmp = vidx[1];
 		  vidx[1] = vidx[2];
 		  vidx[2] = vtmp;       
 	       }
@@ -558,7 +594,7 @@ END OF UNNECESSARY THING */
 void TDestroyDelaunay::InitialTriangulation()
 {
 
-   int v;
+   TIndex v;
 
    #ifdef DEBUG
        DEBUG << "\nTDestroyDelaunay::InitialTriangulation()" << endl;
@@ -2259,3 +2295,40 @@ boolean TDestroyDelaunay::ReCheckVertex( PTVertex V )
    return( IsVtxElim(V) && OkDegree( CalcDegree(V) ) );
 }
 
+
+
+
+// -----------------------------------------------------------------------------
+//  
+//   void TDestroyDelaunay::SaveState( RTCheckpoint C )
+//   void TDestroyDelaunay::LoadState( RTCheckpoint C )
+//
+//   Add the removable vertices to the state of the triangulation. Since
+//   ElimVtxTree is sorted on error and coordinates, inserting them again
+//   gives the same order of removal.
+//
+
+void TDestroyDelaunay::SaveState( RTCheckpoint C )
+{
+   TDoubleList<PTVertex> L;
+
+   TTriangulation::SaveState( C );
+
+   ElimVtxTree.GetSorted( L );
+   C.PutIndex( L.Lenght() );
+   while( !L.IsEmpty() )
+      SavePoint( C, L.RemoveHead() );
+}
+
+
+void TDestroyDelaunay::LoadState( RTCheckpoint C )
+{
+   TIndex i, n;
+
+   TTriangulation::LoadState( C );
+
+   ElimVtxTree.ClearTree();
+   n = C.GetIndex();
+   for( i=0; i<n; i++ )
+      ElimVtxTree.Insert( (PTVertex)LoadPoint( C ) );
+}
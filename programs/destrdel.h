@@ -96,6 +96,15 @@ class TDestroyDelaunay : virtual public TDelaunayBase
      virtual boolean NoMoreUpdates()
        { return( ElimVtxTree.IsEmpty() ); };
 
+     //
+     // Checkpoints: all input points are vertices, and ElimVtxTree
+     // is added to the state.
+     //
+
+     virtual boolean AllPointsAreVertices() { return( TRUE ); };
+     virtual void SaveState( RTCheckpoint );
+     virtual void LoadState( RTCheckpoint );
+
       
      //
      // Update step.
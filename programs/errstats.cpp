@@ -0,0 +1,214 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : errstats.cpp
+//
+//   Implementation of class TErrStats (see errstats.h).
+//
+
+#include <math.h>
+
+#include "defs.h"
+#include "error.h"
+#include "errstats.h"
+
+
+TErrStats::TErrStats()
+{
+   int b;
+
+   n = 0;
+   Sum = SumC = Sq = SqC = 0.0;
+   nLevels = 0;
+   for( b=0; b<ERRSTATS_NBUCKETS; b++ ) Count[b] = 0;
+   Top = -1;
+   Max = 0.0;
+   nMax = 0;
+   MaxExact = TRUE;
+}
+
+
+void TErrStats::SetLevel( int i, double iLevel )
+{
+   check( (n != 0), "TErrStats::SetLevel(), threshold changed on non-empty set" );
+   check( (i < 0 || i >= ERRSTATS_MAXLEVELS), "TErrStats::SetLevel(), too many thresholds" );
+   while ( nLevels <= i )
+   {
+      Level[nLevels] = 0.0;
+      nAbove[nLevels] = nAtLevel[nLevels] = 0;
+      nLevels++;
+   }
+   Level[i] = iLevel;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//   Buckets. An error e = m * 2^x, with m in [0.5,1), goes to bucket
+//   (x - ERRSTATS_EMIN) * ERRSTATS_SUB + floor( (2m - 1) * ERRSTATS_SUB ).
+//
+
+int TErrStats::Bucket( double e )
+{
+   int x, b;
+   double m;
+
+   if ( e <= 0.0 ) return( 0 );
+
+   m = frexp( e, &x );
+   if ( x < ERRSTATS_EMIN ) return( 0 );
+   if ( x >= ERRSTATS_EMAX ) return( ERRSTATS_NBUCKETS - 1 );
+
+   b = (x - ERRSTATS_EMIN) * ERRSTATS_SUB + (int)( (2.0*m - 1.0) * ERRSTATS_SUB );
+   return( b );
+}
+
+
+double TErrStats::BucketTop( int b )
+{
+   int x = b / ERRSTATS_SUB + ERRSTATS_EMIN;
+   int s = b % ERRSTATS_SUB;
+
+   return( ldexp( 0.5 + 0.5 * (s+1) / ERRSTATS_SUB, x ) );
+}
+
+
+void TErrStats::KahanAdd( double &S, double &C, double x )
+{
+   double y = x - C;
+   double t = S + y;
+   C = ( t - S ) - y;
+   S = t;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//   Insertion and removal.
+//
+
+void TErrStats::Insert( double e )
+{
+   int b = Bucket( e );
+   int l;
+
+   n++;
+   KahanAdd( Sum, SumC, e );
+   KahanAdd( Sq, SqC, e*e );
+
+   for( l=0; l<nLevels; l++ )
+      if ( e > Level[l] ) nAbove[l]++;
+      else if ( e == Level[l] ) nAtLevel[l]++;
+
+   Count[b]++;
+
+   if ( n == 1 || b > Top )
+   {
+      // e is certainly the largest error
+      Max = e;  nMax = 1;  MaxExact = TRUE;
+   }
+   else if ( MaxExact )
+   {
+      if ( e > Max ) { Max = e;  nMax = 1; }
+      else if ( e == Max ) nMax++;
+   }
+   if ( b > Top ) Top = b;
+}
+
+
+void TErrStats::Remove( double e )
+{
+   int b = Bucket( e );
+   int l;
+
+   check( (n == 0 || Count[b] == 0), "TErrStats::Remove(), error not present" );
+
+   n--;
+   KahanAdd( Sum, SumC, -e );
+   KahanAdd( Sq, SqC, -e*e );
+
+   for( l=0; l<nLevels; l++ )
+      if ( e > Level[l] ) nAbove[l]--;
+      else if ( e == Level[l] ) nAtLevel[l]--;
+
+   Count[b]--;
+
+   if ( n == 0 )
+   {
+      // restart from exact zeros, rather than from cancellation residues
+      Sum = SumC = Sq = SqC = 0.0;
+      Top = -1;  Max = 0.0;  nMax = 0;  MaxExact = TRUE;
+      return;
+   }
+
+   if ( MaxExact && e == Max && --nMax == 0 ) MaxExact = FALSE;
+
+   while ( Count[Top] == 0 ) Top--;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//   Queries.
+//
+
+double TErrStats::GetMax()
+{
+   if ( n == 0 ) return( 0.0 );
+   return( MaxExact ? Max : BucketTop( Top ) );
+}
+
+
+TIndex TErrStats::PercentileRank( double Pct )
+{
+   TIndex k = (TIndex)ceil( Pct * n / 100.0 );
+
+   if ( k < 1 ) k = 1;
+   if ( k > n ) k = n;
+   return( k );
+}
+
+
+double TErrStats::Percentile( double Pct )
+{
+   TIndex k, Seen;
+   int b;
+
+   if ( n == 0 ) return( 0.0 );
+
+   k = PercentileRank( Pct );
+   if ( k == n ) return( GetMax() );
+
+   // visit buckets from the highest one, until the k-th smallest error
+   // (i.e., the (n-k+1)-th largest one) is reached
+   Seen = 0;
+   for( b=Top; b>=0; b-- )
+   {
+      Seen += Count[b];
+      if ( Seen >= n - k + 1 ) break;
+   }
+   return( b == Top ? GetMax() : BucketTop( b ) );
+}
@@ -0,0 +1,137 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : errstats.h
+//
+//   Definition of class TErrStats, which keeps statistics on a multiset
+//   of non-negative errors (in practice, the errors of the triangles of
+//   the current triangulation), for the termination criteria of
+//   class MTTracer.
+//
+//   Memory is fixed and insertion / removal of an error take constant
+//   time:
+//   - errors are counted in a histogram of ERRSTATS_NBUCKETS buckets,
+//     ERRSTATS_SUB buckets for each power of two between 2^ERRSTATS_EMIN
+//     and 2^ERRSTATS_EMAX (errors out of this range go to the first or
+//     last bucket). The histogram gives the maximum and the percentiles
+//     within the width of one bucket; the maximum is exact as long as
+//     its value has not been removed.
+//   - sums of errors and of squared errors are Kahan-compensated, so
+//     that means do not drift after millions of updates.
+//   - errors above and equal to each of at most ERRSTATS_MAXLEVELS
+//     thresholds (the error level of the termination condition, and
+//     the levels at which intermediate meshes are written) are counted
+//     exactly, so that comparing the maximum or a percentile with a
+//     threshold is exact.
+//
+
+#ifndef _ERRSTATS_H
+#define _ERRSTATS_H
+
+#include "defs.h"
+#include "checkpoint.h"
+
+
+#define ERRSTATS_SUB      16
+#define ERRSTATS_EMIN     (-64)
+#define ERRSTATS_EMAX     64
+#define ERRSTATS_NBUCKETS ((ERRSTATS_EMAX - ERRSTATS_EMIN) * ERRSTATS_SUB)
+#define ERRSTATS_MAXLEVELS 17
+
+
+class TErrStats
+{
+   private:
+
+      TIndex n;                     // number of errors
+
+      // Kahan sums of errors and of squared errors, with compensations.
+      double Sum, SumC, Sq, SqC;
+
+      // Thresholds, and exact number of errors above / equal to each.
+      double Level[ERRSTATS_MAXLEVELS];
+      TIndex nAbove[ERRSTATS_MAXLEVELS], nAtLevel[ERRSTATS_MAXLEVELS];
+      int nLevels;
+
+      // Histogram, and highest non-empty bucket (-1 if none).
+      TIndex Count[ERRSTATS_NBUCKETS];
+      int Top;
+
+      // Largest error, with its multiplicity. Max is exact only if
+      // MaxExact is TRUE, i.e., if it has not been removed since
+      // it was inserted.
+      double Max;
+      TIndex nMax;
+      boolean MaxExact;
+
+      // Bucket of an error, and upper bound of the errors in a bucket.
+      static int Bucket( double e );
+      static double BucketTop( int b );
+
+      // Add a term (possibly negative) to a Kahan sum.
+      static void KahanAdd( double &S, double &C, double x );
+
+   public:
+
+      TErrStats();
+
+      // Set the i-th threshold; it must be done while the multiset
+      // is empty.
+      void SetLevel( int i, double iLevel );
+
+      void Insert( double e );
+      void Remove( double e );
+
+      TIndex Number() { return( n ); };
+
+      // Number of errors larger than / at least equal to the i-th
+      // threshold.
+      TIndex NumberAbove( int i ) { return( nAbove[i] ); };
+      TIndex NumberAtLeast( int i ) { return( nAbove[i] + nAtLevel[i] ); };
+
+      // Mean error and mean squared error (0 if empty).
+      double Mean() { return( n > 0 ? Sum / n : 0.0 ); };
+      double MeanSquare() { return( n > 0 ? Sq / n : 0.0 ); };
+
+      // Maximum error (0 if empty): exact if known, otherwise the upper
+      // bound of the highest non-empty bucket.
+      double GetMax();
+
+      // Rank (from 1, in increasing order) of the Pct-th percentile,
+      // with the nearest-rank definition.
+      TIndex PercentileRank( double Pct );
+
+      // Upper bound of the bucket containing the Pct-th percentile
+      // (0 if empty). Not constant time: it visits the histogram.
+      double Percentile( double Pct );
+
+      // Write / read all counters on / from a checkpoint (the object
+      // contains no pointers, it is copied as it is).
+      void Save( RTCheckpoint C ) { C.Put( this, sizeof(TErrStats) ); };
+      void Load( RTCheckpoint C ) { C.Get( this, sizeof(TErrStats) ); };
+};
+
+#endif // _ERRSTATS_H
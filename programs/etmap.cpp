@@ -0,0 +1,149 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : etmap.cpp
+//
+//   Implementation of class TEdgeETMap (see etmap.h).
+//
+
+#include "defs.h"
+#include "error.h"
+#include "etmap.h"
+
+
+TEdgeETMap::TEdgeETMap()
+{
+   Slot = NULL;
+   nSlot = nUsed = 0;
+   CurStamp = 1;
+}
+
+
+TEdgeETMap::~TEdgeETMap()
+{
+   if ( Slot != NULL ) delete[] Slot;
+}
+
+
+TIndex TEdgeETMap::Find( TIndex EID )
+{
+   TIndex i;
+
+   if ( nUsed == 0 ) return( -1 );
+
+   // the table is never full, so an empty slot ends the search
+   for( i = Home( EID ); InUse( i ); i = (i+1) & (nSlot-1) )
+      if ( Slot[i].EID == EID ) return( i );
+   return( -1 );
+}
+
+
+void TEdgeETMap::Grow()
+{
+   TSlot *OldSlot = Slot;
+   TIndex nOld = nSlot;
+   unsigned long OldStamp = CurStamp;
+   TIndex i, j;
+
+   nSlot = ( nOld == 0 ? 64 : 2*nOld );
+   Slot = new TSlot[ nSlot ];
+   check( (Slot == NULL), "TEdgeETMap::Grow(), insufficient memory" );
+   for( i=0; i<nSlot; i++ ) Slot[i].Stamp = 0;
+   CurStamp = 1;
+
+   for( i=0; i<nOld; i++ )
+      if ( OldSlot[i].Stamp == OldStamp )
+      {
+         for( j = Home( OldSlot[i].EID ); InUse( j ); j = (j+1) & (nSlot-1) ) ;
+         Slot[j] = OldSlot[i];
+         Slot[j].Stamp = CurStamp;
+      }
+
+   if ( OldSlot != NULL ) delete[] OldSlot;
+}
+
+
+void TEdgeETMap::Save( PTEdge E )
+{
+   TIndex i;
+
+   #ifdef ROBUST
+      check( (Find( E->EID ) >= 0), "TEdgeETMap::Save(), edge already saved" );
+   #endif
+
+   if ( 2*(nUsed+1) > nSlot ) Grow();
+
+   for( i = Home( E->EID ); InUse( i ); i = (i+1) & (nSlot-1) ) ;
+   Slot[i].Stamp = CurStamp;
+   Slot[i].EID = E->EID;
+   Slot[i].Edge = E;
+   Slot[i].ET[0] = E->ET[0];
+   Slot[i].ET[1] = E->ET[1];
+   nUsed++;
+}
+
+
+boolean TEdgeETMap::Restore( PTEdge E )
+{
+   TIndex j, h;
+   TIndex i = Find( E->EID );
+
+   if ( i < 0 ) return( FALSE );
+
+   E->ET[0] = Slot[i].ET[0];
+   E->ET[1] = Slot[i].ET[1];
+
+   // Remove slot i, moving back the following slots of the same
+   // cluster whose home is not in (i,j], so that no search is broken
+   // by the hole.
+   for( j = (i+1) & (nSlot-1); InUse( j ); j = (j+1) & (nSlot-1) )
+   {
+      h = Home( Slot[j].EID );
+      if ( ( i <= j ) ? ( h <= i || h > j ) : ( h <= i && h > j ) )
+      {
+         Slot[i] = Slot[j];
+         i = j;
+      }
+   }
+   Slot[i].Stamp = 0;
+   nUsed--;
+   return( TRUE );
+}
+
+
+void TEdgeETMap::Clear()
+{
+   TIndex i;
+
+   nUsed = 0;
+   if ( ++CurStamp == 0 )
+   {
+      // stamps wrapped around: really empty the slots
+      for( i=0; i<nSlot; i++ ) Slot[i].Stamp = 0;
+      CurStamp = 1;
+   }
+}
@@ -0,0 +1,113 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : etmap.h
+//
+//   Definition of class TEdgeETMap, a small hash table (open
+//   addressing, linear probing) that saves the ET relation of some
+//   edges, by EID, so that it can be restored later. It is used by
+//   the extended optimization of TDecCDT, that must restore the
+//   original ET relation of the edges it swaps.
+//
+//   The table is meant to be emptied and filled again at each update:
+//   emptying it costs O(1) (the slots of previous fillings are
+//   recognized by their stamp) and does not free memory, so that once
+//   the table has reached its working size no more allocations take
+//   place.
+//
+
+
+#ifndef _ETMAP_H
+#define _ETMAP_H
+
+#include "defs.h"
+#include "ttriang.h"
+
+
+class TEdgeETMap;
+
+typedef TEdgeETMap *PTEdgeETMap;
+
+
+class TEdgeETMap
+{
+   private:
+
+      struct TSlot
+      {
+         unsigned long Stamp;   // slot in use if Stamp == CurStamp
+         TIndex EID;
+         PTEdge Edge;
+         PTTriangle ET[2];
+      };
+
+      TSlot *Slot;
+      TIndex nSlot;             // a power of 2 (0 if not allocated)
+      TIndex nUsed;
+      unsigned long CurStamp;
+
+      // Not copyable.
+      TEdgeETMap( const TEdgeETMap & );
+      void operator=( const TEdgeETMap & );
+
+      TIndex Home( TIndex EID ) 
+         { return( (TIndex)( ( (unsigned long)EID * 2654435761UL ) & (nSlot-1) ) ); };
+      boolean InUse( TIndex i ) { return( Slot[i].Stamp == CurStamp ); };
+
+      // Position of EID in the table, -1 if not present.
+      TIndex Find( TIndex EID );
+
+      // Double the size of the table (at most half of it is in use).
+      void Grow();
+
+   public:
+
+      TEdgeETMap();
+      ~TEdgeETMap();
+
+      TIndex Count() { return( nUsed ); };
+      boolean IsEmpty() { return( nUsed == 0 ); };
+
+      boolean Contains( PTEdge E ) { return( Find( E->EID ) >= 0 ); };
+
+      // Save the ET relation of E (E must not be in the table).
+      void Save( PTEdge E );
+
+      // Restore the saved ET relation of E and remove E from the
+      // table. Return FALSE if E is not in the table.
+      boolean Restore( PTEdge E );
+
+      // The i-th edge in the table, for 0 <= i < Slots() (NULL if the
+      // slot is empty); used only for consistency checks.
+      TIndex Slots() { return( nSlot ); };
+      PTEdge EdgeAt( TIndex i ) { return( InUse( i ) ? Slot[i].Edge : (PTEdge)NULL ); };
+
+      // Empty the table, keeping its memory.
+      void Clear();
+};
+
+#endif // _ETMAP_H
@@ -195,13 +195,21 @@ double Geom::Det3x3( PTVertex v1,  PTVertex v2,  PTVertex v3 )
 
 int Geom::Turnxy( PTPoint P0, PTPoint P1, PTPoint P2 )
 { 
-    return( 
-           Sign( 
-	        Det3x3( P0->x, P0->y,
-	                P1->x, P1->y,
-		        P2->x, P2->y )
-	       )
-	  );
+#ifdef COMPACT_COORDS
+    // Exact test on the integer grid: the differences fit in an int
+    // and their products in a long long, since grid coordinates are
+    // bounded by QUANT_MAX.
+    long long det =
+       (long long)( P1->x.Grid() - P0->x.Grid() ) * ( P2->y.Grid() - P0->y.Grid() ) -
+       (long long)( P1->y.Grid() - P0->y.Grid() ) * ( P2->x.Grid() - P0->x.Grid() );
+    return( det > 0 ? TURN_LEFT : ( det < 0 ? TURN_RIGHT : ALIGNED ) );
+#else
+    // Exact test too: with a tolerance on the determinant, the turns of
+    // almost aligned points may be inconsistent with each other, and the
+    // points added by the cleaning of constraints (see segclean.h) are
+    // often exactly aligned on their grid
+    return( TurnExactxy( P0, P1, P2 ) );
+#endif
 }
   
       
@@ -209,8 +217,8 @@ int Geom::Turnxy( PTPoint P0, PTPoint P1, PTPoint P2 )
 //
 // boolean Geom::Alignedxy( PTPoint, PTPoint, PTPoint )
 //
-// Return true iff the three points are aligned, i.e., the
-// determinant is 0 up to the tolerance contained in EQ_TOLL.
+// Return true iff the three points are aligned, i.e., Turnxy()
+// returns ALIGNED.
 // Consider points in the plane (z coordinate is ignored).
 //
 
@@ -220,6 +228,118 @@ boolean Geom::Alignedxy( PTPoint P0, PTPoint P1, PTPoint P2 )
 }
 
 
+// -----------------------------------------------------------------
+//
+// int Geom::TurnExactxy( PTPoint, PTPoint, PTPoint )
+//
+// Filtered exact version of Turnxy() (see J.R. Shewchuk, "Adaptive
+// precision floating-point arithmetic and fast robust geometric
+// predicates", 1997). The determinant
+//
+//    (x0-x2)*(y1-y2) - (y0-y2)*(x1-x2)
+//
+// is first computed in floating point; its sign is correct unless
+// its absolute value is below TURN_ERRBOUND times the sum of the
+// absolute values of the two products. Only in that case the
+// determinant is recomputed exactly, as the sum of the six products
+// of the expanded formula.
+//
+
+// (3 + 16 eps) eps, with eps = 2^-53
+#define TURN_ERRBOUND  3.3306690738754716e-16
+
+// 2^27 + 1, to split a double in two halves of 26 bits
+#define TURN_SPLITTER  134217729.0
+
+void Geom::TwoSum( double a, double b, double &x, double &y )
+{
+   x = a + b;
+   double bv = x - a;
+   double av = x - bv;
+   y = ( a - av ) + ( b - bv );
+}
+
+
+void Geom::TwoProduct( double a, double b, double &x, double &y )
+{
+   double c, ahi, alo, bhi, blo;
+
+   x = a * b;
+   c = TURN_SPLITTER * a;  ahi = c - ( c - a );  alo = a - ahi;
+   c = TURN_SPLITTER * b;  bhi = c - ( c - b );  blo = b - bhi;
+   y = alo * blo - ( ( ( x - ahi * bhi ) - alo * bhi ) - ahi * blo );
+}
+
+
+//
+// e is sorted by increasing magnitude, without zeros; so is the
+// result, whose sign is the sign of its last component.
+//
+
+int Geom::GrowExpansion( int n, double *e, double b )
+{
+   int i, k = 0;
+   double q = b, hh;
+
+   for( i=0; i<n; i++ )
+   {
+      TwoSum( q, e[i], q, hh );
+      if ( hh != 0.0 ) e[k++] = hh;
+   }
+   if ( q != 0.0 || k == 0 ) e[k++] = q;
+   return( k );
+}
+
+
+int Geom::TurnExactxy( PTPoint P0, PTPoint P1, PTPoint P2 )
+{
+#ifdef COMPACT_COORDS
+    // Turnxy() is already exact on the integer grid
+    return( Turnxy( P0, P1, P2 ) );
+#else
+    double x0 = P0->x, y0 = P0->y;
+    double x1 = P1->x, y1 = P1->y;
+    double x2 = P2->x, y2 = P2->y;
+
+    double detleft  = ( x0 - x2 ) * ( y1 - y2 );
+    double detright = ( y0 - y2 ) * ( x1 - x2 );
+    double det = detleft - detright;
+    double detsum;
+
+    if ( detleft > 0.0 )
+    {
+       if ( detright <= 0.0 ) return( Sign( det ) );
+       detsum = detleft + detright;
+    }
+    else if ( detleft < 0.0 )
+    {
+       if ( detright >= 0.0 ) return( Sign( det ) );
+       detsum = - detleft - detright;
+    }
+    else return( Sign( det ) );
+
+    if ( det >= TURN_ERRBOUND * detsum || -det >= TURN_ERRBOUND * detsum )
+       return( Sign( det ) );
+
+    //
+    // exact sum of  x0*y1 - x0*y2 - x2*y1 - y0*x1 + y0*x2 + y2*x1
+    //
+
+    double e[12], p, q;
+    int n = 0;
+
+    TwoProduct(  x0, y1, p, q );  n = GrowExpansion( n, e, q );  n = GrowExpansion( n, e, p );
+    TwoProduct( -x0, y2, p, q );  n = GrowExpansion( n, e, q );  n = GrowExpansion( n, e, p );
+    TwoProduct( -x2, y1, p, q );  n = GrowExpansion( n, e, q );  n = GrowExpansion( n, e, p );
+    TwoProduct( -y0, x1, p, q );  n = GrowExpansion( n, e, q );  n = GrowExpansion( n, e, p );
+    TwoProduct(  y0, x2, p, q );  n = GrowExpansion( n, e, q );  n = GrowExpansion( n, e, p );
+    TwoProduct(  y2, x1, p, q );  n = GrowExpansion( n, e, q );  n = GrowExpansion( n, e, p );
+
+    return( Sign( e[n-1] ) );
+#endif
+}
+
+
 // -----------------------------------------------------------------
 //
 // double Geom::Distancexy( PTPoint, PTPoint )
@@ -241,6 +361,33 @@ double Geom::Distancexy( PTPoint p0, PTPoint p1 )
 {
    return( Geom::Distancexy( p0->x, p0->y, p1->x, p1->y ) );	 
 }
+
+
+// -----------------------------------------------------------------
+//
+// double Geom::SegmentDistancexy( PTPoint, PTPoint, PTPoint )
+//
+// Return distance between point p and segment p0-p1, i.e., between p
+// and its projection on the line of p0-p1, if inside the segment, or
+// its nearest endpoint otherwise.
+// Consider points in the plane (z coordinate is ignored).
+//
+
+double Geom::SegmentDistancexy( PTPoint p, PTPoint p0, PTPoint p1 )
+{
+   double dx = p1->x - p0->x;
+   double dy = p1->y - p0->y;
+   double l2 = dx*dx + dy*dy;
+   double t;
+
+   if ( l2 == 0.0 ) return( Geom::Distancexy( p, p0 ) );
+
+   t = ( (p->x - p0->x) * dx + (p->y - p0->y) * dy ) / l2;
+   if ( t <= 0.0 ) return( Geom::Distancexy( p, p0 ) );
+   if ( t >= 1.0 ) return( Geom::Distancexy( p, p1 ) );
+
+   return( Geom::Distancexy( p->x, p->y, p0->x + t*dx, p0->y + t*dy ) );
+}
      
       
 // -----------------------------------------------------------------
@@ -268,8 +415,11 @@ void Geom::CalcCirclexy( PTPoint p0, PTPoint p1, PTPoint p2,
    
    double G = 2.0 * ( ( A * ( p2->y - p1->y ) ) - ( B * ( p2->x - p1->x ) ) );
 
-   if (EqDouble(G, 0.0)) cerr << "\n Points " << *p0 << "  " << *p1 << "  " << *p2 << endl;
-   check( (EqDouble(G, 0.0)), "Geom::CalcCirclexy(), points are collinear");
+   // Turnxy() is exact, so a triangle may be almost flat (e.g., at a
+   // crossing of constraints split without rounding, see segclean.h):
+   // its circle is then very large, but it exists
+   if (G == 0.0) cerr << "\n Points " << *p0 << "  " << *p1 << "  " << *p2 << endl;
+   check( (G == 0.0), "Geom::CalcCirclexy(), points are collinear");
    
    CX = ( (D*E) - (B*F) ) / G;
    CY = ( (A*F) - (C*E) ) / G;
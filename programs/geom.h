@@ -75,6 +75,13 @@ class Geom
       // The default constructor is private. This makes it impossible
       // to create instances of this class.
       Geom() { error("private constructor Geom::Geom() called" ); };
+
+      // Exact arithmetic for TurnExactxy(): a+b and a*b as the sum x+y
+      // of two non-overlapping doubles, and in-place addition of b to
+      // the n components of expansion e (returns the new length).
+      static void TwoSum( double a, double b, double &x, double &y );
+      static void TwoProduct( double a, double b, double &x, double &y );
+      static int GrowExpansion( int n, double *e, double b );
       
    public:
 
@@ -118,14 +125,23 @@ class Geom
       static int Turnxy( PTPoint P0, PTPoint P1, PTPoint P2 );
       
       // Return true iff the three points are aligned, i.e., the
-      // determinant is 0 up to the tolerance contained in EQ_TOLL.
+      // determinant is exactly 0 (see TurnExactxy).
       // Consider points in the plane (z coordinate is ignored).
       static boolean Alignedxy( PTPoint P0, PTPoint P1, PTPoint P2 );
 
+      // The exact test used by Turnxy(): the determinant is computed
+      // in floating point, and again with exact arithmetic only if its
+      // sign is uncertain.
+      static int TurnExactxy( PTPoint P0, PTPoint P1, PTPoint P2 );
+
       // Return distance between two points.
       // Consider points in the plane (z coordinate is ignored).
       static double Distancexy( PTPoint p0, PTPoint p1 );
       static double Distancexy(double x0, double y0, double x1, double y1 );
+
+      // Return distance between point p and segment p0-p1.
+      // Consider points in the plane (z coordinate is ignored).
+      static double SegmentDistancexy( PTPoint p, PTPoint p0, PTPoint p1 );
       
       
       // Test, by using turns, if point p falls inside or on the boundary
@@ -0,0 +1,262 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : lodwriter.cpp
+//
+//   Implementation of classes TLodMesh and TLodWriter (see lodwriter.h).
+//
+
+#include <iostream>
+#include <fstream>
+#include <string.h>
+
+#include "defs.h"
+#include "error.h"
+#include "lodwriter.h"
+
+using namespace std;
+
+
+// -----------------------------------------------------------------
+//
+//  TLodMesh::TLodMesh( const char *, TIndex, TIndex, TIndex, boolean )
+//
+//  Allocate the arrays; they are filled by the caller.
+//
+
+TLodMesh::TLodMesh( const char *iFileName, TIndex inVrt, TIndex inTrg, TIndex inCon,
+                    boolean WithPrm )
+{
+   FileName = new char[ strlen(iFileName) + 1 ];
+   strcpy( FileName, iFileName );
+
+   nVrt = inVrt;
+   nTrg = inTrg;
+   nCon = inCon;
+
+   Vtx = new double[ 3*nVrt ];
+   Trg = new TIndex[ 3*nTrg ];
+   Con = ( nCon > 0 ) ? new TIndex[ 2*nCon ] : (TIndex *)NULL;
+   Prm = ( WithPrm ) ? new TIndex[ nVrt ] : (TIndex *)NULL;
+
+   check( ( Vtx == NULL || Trg == NULL || (nCon > 0 && Con == NULL) ||
+            (WithPrm && Prm == NULL) ),
+          "TLodMesh::TLodMesh(), insufficient memory" );
+
+   Next = NULL;
+}
+
+
+TLodMesh::~TLodMesh()
+{
+   delete[] FileName;
+   delete[] Vtx;
+   delete[] Trg;
+   if ( Con ) delete[] Con;
+   if ( Prm ) delete[] Prm;
+}
+
+
+// -----------------------------------------------------------------
+//
+//  void TLodMesh::Write()
+//
+//  Write the mesh on file FileName, and the permutation of its
+//  vertices (if any) on FileName.prm, in the same format as
+//  TTriangulation::WriteData and TTriangulation::WritePermutation.
+//
+
+void TLodMesh::Write()
+{
+   TIndex i;
+
+   ofstream outFile;
+   outFile.open( FileName );
+   check( !outFile, "TLodMesh::Write(), cannot open output file" );
+
+   outFile.precision( 12 );
+
+   outFile << nVrt << endl;
+   for( i=0; i<nVrt; i++ )
+      outFile << Vtx[3*i] << '\t' << Vtx[3*i+1] << '\t' << Vtx[3*i+2] << endl;
+
+   outFile << nTrg << endl;
+   for( i=0; i<nTrg; i++ )
+      outFile << Trg[3*i] << '\t' << Trg[3*i+1] << '\t' << Trg[3*i+2] << endl;
+
+   if ( nCon >= 0 )
+   {
+      outFile << nCon << endl;
+      for( i=0; i<nCon; i++ )
+         outFile << Con[2*i] << '\t' << Con[2*i+1] << endl;
+   }
+
+   outFile.close();
+
+   if ( Prm != NULL )
+   {
+      char *prmfname = new char[ strlen(FileName) + 5 ];
+      check( (prmfname == NULL), "TLodMesh::Write(), insufficient memory" );
+      strcpy( prmfname, FileName );
+      strcat( prmfname, ".prm" );
+
+      ofstream prmFile;
+      prmFile.open( prmfname );
+      check( !prmFile, "TLodMesh::Write(), cannot open output file" );
+
+      prmFile << nVrt << endl;
+      for( i=0; i<nVrt; i++ )
+         prmFile << Prm[i] << endl;
+
+      prmFile.close();
+      delete[] prmfname;
+   }
+}
+
+
+#ifdef PIPELINED_OUTPUT
+
+// -----------------------------------------------------------------
+//
+//  TLodWriter::TLodWriter()
+//
+//  Start the writer thread, which waits for meshes to write.
+//
+
+TLodWriter::TLodWriter()
+{
+   First = Last = NULL;
+   Done = FALSE;
+
+   pthread_mutex_init( &Lock, NULL );
+   pthread_cond_init( &NotEmpty, NULL );
+
+   check( (pthread_create( &Thread, NULL, ConsumerMain, this ) != 0),
+          "TLodWriter::TLodWriter(), cannot create writer thread");
+}
+
+
+// -----------------------------------------------------------------
+//
+//  TLodWriter::~TLodWriter()
+//
+//  Tell the writer thread that no more meshes will come, and wait
+//  until it has written the ones in the queue.
+//
+
+TLodWriter::~TLodWriter()
+{
+   pthread_mutex_lock( &Lock );
+   Done = TRUE;
+   pthread_cond_signal( &NotEmpty );
+   pthread_mutex_unlock( &Lock );
+
+   pthread_join( Thread, NULL );
+
+   pthread_cond_destroy( &NotEmpty );
+   pthread_mutex_destroy( &Lock );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  void TLodWriter::Write( PTLodMesh M )
+//
+//  Append M to the queue of the writer thread.
+//
+
+void TLodWriter::Write( PTLodMesh M )
+{
+   M->Next = NULL;
+
+   pthread_mutex_lock( &Lock );
+   if ( Last == NULL ) First = M;
+   else Last->Next = M;
+   Last = M;
+   pthread_cond_signal( &NotEmpty );
+   pthread_mutex_unlock( &Lock );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  void TLodWriter::Consume()
+//
+//  Write the meshes of the queue, in order, until the queue is
+//  empty and Done is set.
+//
+
+void TLodWriter::Consume()
+{
+   PTLodMesh M;
+
+   while ( TRUE )
+   {
+      pthread_mutex_lock( &Lock );
+      while ( First == NULL && !Done )
+         pthread_cond_wait( &NotEmpty, &Lock );
+      M = First;
+      if ( M != NULL )
+      {
+         First = M->Next;
+         if ( First == NULL ) Last = NULL;
+      }
+      pthread_mutex_unlock( &Lock );
+
+      if ( M == NULL ) return;   // empty queue and Done
+
+      // the mesh is not accessed by the owner once it is in the queue
+      M->Write();
+      delete M;
+   }
+}
+
+
+void *TLodWriter::ConsumerMain( void *Writer )
+{
+   ((PTLodWriter) Writer)->Consume();
+   return( NULL );
+}
+
+
+#else // PIPELINED_OUTPUT
+
+TLodWriter::TLodWriter()
+{
+}
+
+
+TLodWriter::~TLodWriter()
+{
+}
+
+
+void TLodWriter::Write( PTLodMesh M )
+{
+   M->Write();
+   delete M;
+}
+
+#endif // PIPELINED_OUTPUT
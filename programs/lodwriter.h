@@ -0,0 +1,128 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : lodwriter.h
+//
+//   Definition of class TLodWriter, which writes the intermediate
+//   triangulations (levels of detail) reached during a run.
+//
+//   The triangulation owning the writer converts the current mesh into
+//   arrays (class TLodMesh) and hands them over; the mesh can then be
+//   updated further while the arrays are written. If macro
+//   PIPELINED_OUTPUT is defined in defs.h, writing is done by a
+//   separate thread, so that it overlaps with the updates; otherwise
+//   each mesh is written as soon as it is handed over.
+//
+
+
+#ifndef _LODWRITER_H
+#define _LODWRITER_H
+
+#include "defs.h"
+
+#ifdef PIPELINED_OUTPUT
+#include <pthread.h>
+#endif
+
+
+// ----------------------------------------------------------------------
+//
+//  class TLodMesh
+//
+//  A triangulation in indexed format, in the same form as the output
+//  files written by TTriangulation::WriteData.
+//
+
+class TLodMesh
+{
+   public:
+
+      char *FileName;
+
+      TIndex nVrt;          // vertices, as x,y,z triples
+      double *Vtx;
+
+      TIndex nTrg;          // triangles, as triples of vertex indices
+      TIndex *Trg;
+
+      TIndex nCon;          // constraints, as pairs of vertex indices;
+      TIndex *Con;          // no constraint section if nCon < 0
+
+      TIndex *Prm;          // input index of each vertex (NULL if the
+                            // file .prm is not written)
+
+      TLodMesh *Next;       // next mesh in the queue of the writer
+
+      TLodMesh( const char *iFileName, TIndex inVrt, TIndex inTrg, TIndex inCon,
+                boolean WithPrm );
+      ~TLodMesh();
+
+      void Write();
+};
+
+typedef class TLodMesh *PTLodMesh;
+
+
+// ----------------------------------------------------------------------
+//
+//  class TLodWriter
+//
+
+class TLodWriter
+{
+   private:
+
+#ifdef PIPELINED_OUTPUT
+
+      // meshes handed over and not yet written, in order
+      PTLodMesh First, Last;
+
+      // TRUE when no more meshes will be handed over
+      boolean Done;
+
+      pthread_t       Thread;
+      pthread_mutex_t Lock;
+      pthread_cond_t  NotEmpty;
+
+      // Body of the writer thread.
+      void Consume();
+      static void *ConsumerMain( void * );
+
+#endif
+
+   public:
+
+      TLodWriter();
+
+      // Wait until all meshes handed over have been written.
+      ~TLodWriter();
+
+      // Write mesh M, and delete it when done.
+      void Write( PTLodMesh M );
+};
+
+typedef class TLodWriter *PTLodWriter;
+
+#endif // _LODWRITER_H
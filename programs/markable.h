@@ -74,10 +74,7 @@ const MARKTYPE VISITED      = 0x04;         // bit 2
 // MT_Hist.
 const MARKTYPE NEW_TRIANGLE = 0x08;         // bit 3
 
-// This mark is used by function MT_KillInterference to mark triangles
-// previously marked as TO_DELETE, and means that such triangles have been
-// registered as deleted by MT_Hist
-const MARKTYPE MT_DELETED   = 0x10;         // bit 4
+// Bit 4 is not used.
 
 // Other constants used by function TDecimDelaunay::RetriangulateInflRegn()
 const MARKTYPE INFL_BORDER_AUX = 0x20;      // bit 5
@@ -103,9 +100,9 @@ const MARKTYPE NEW_EDGE = 0x100;          // bit 8
 // of a vertex with some constraint edges indicent in it.
 const MARKTYPE RECHECKED = 0x200;          // bit 9
 
-// This mark is used to mark original edges that have a copy of themselves 
-// in TDecCDT::OrigEdgList. The copy contains all edge attributes as they
-// were before starting the retriangulation process.
+// This mark is used to mark original edges whose ET relation is saved
+// in TDecCDT::OrigET, as it was before starting the retriangulation
+// process.
 const MARKTYPE COPIED = 0x400;          // bit 10
 
 // REMARK: If you add or modify any constant, ALWAYS remember to update
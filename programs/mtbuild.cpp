@@ -0,0 +1,472 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : mtbuild.cpp
+//
+//   Implementation of class TMTBuilder (see mtbuild.h).
+//
+
+
+#include "mtbuild.h"
+
+#ifdef MT_NATIVE
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "mttracer.h"
+
+using namespace std;
+
+// Initial capacity of the arrays of vertices and tiles.
+const TIndex MTB_INITSIZE = 1024;
+
+
+//
+// Make room for one more element in array p of Size-byte elements,
+// containing n elements out of Max.
+//
+
+static void *Grow( void *p, TIndex n, TIndex &Max, size_t Size )
+{
+   if ( n < Max ) return( p );
+   Max = ( Max == 0 ? MTB_INITSIZE : 2*Max );
+   p = realloc( p, Max * Size );
+   check( (p == NULL), "TMTBuilder, insufficient memory" );
+   return( p );
+}
+
+
+//
+// Read n elements of Size bytes into array p, of capacity Max.
+//
+
+static void *LoadArray( RTCheckpoint C, void *p, TIndex n, TIndex &Max, size_t Size )
+{
+   if ( n > Max )
+   {
+      Max = n;
+      p = realloc( p, Max * Size );
+      check( (p == NULL), "TMTBuilder, insufficient memory" );
+   }
+   C.Get( p, n * Size );
+   return( p );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Constructor and destructor.
+//
+
+TMTBuilder::TMTBuilder()
+{
+   Type = MT_REFINING;
+   Vertex = NULL;
+   nVertices = MaxVertices = 0;
+   nTiles = 0;
+   nAlive = 0;
+   CurUpdate = 0;
+   Description = NULL;
+#ifdef MT_STREAM
+   fd = NULL;
+   Killed = NULL;
+   nKilled = MaxKilled = 0;
+   Created = NULL;
+   nCreated = MaxCreated = 0;
+   nTotVertices = 0;
+   UpdateOffset = NULL;
+   MaxUpdates = 0;
+   EndOffset = 0;
+#else
+   Tile = NULL;
+   MaxTiles = 0;
+#endif
+}
+
+TMTBuilder::~TMTBuilder()
+{
+   if ( Vertex != NULL ) free( Vertex );
+   if ( Description != NULL ) free( Description );
+#ifdef MT_STREAM
+   if ( fd != NULL ) fclose( fd );
+   if ( Killed != NULL ) free( Killed );
+   if ( Created != NULL ) free( Created );
+   if ( UpdateOffset != NULL ) free( UpdateOffset );
+#else
+   if ( Tile != NULL ) free( Tile );
+#endif
+}
+
+
+int TMTBuilder::FileType()
+{
+   return( Type == MT_COARSENING ? MTFILE_COARSENING : MTFILE_REFINING );
+}
+
+
+void TMTBuilder::SetDescription( const char *Desc )
+{
+   if ( Description != NULL ) free( Description );
+   Description = (char *) malloc( strlen(Desc)+1 );
+   check( (Description == NULL), "TMTBuilder::SetDescription(), insufficient memory" );
+   strcpy( Description, Desc );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Vertices (common to both modes; with MT_STREAM array Vertex only
+//  contains the vertices of the current update).
+//
+
+TIndex TMTBuilder::UseVertex( TIndex Idx, double x, double y, double z )
+{
+   if ( Idx >= 0 ) return( Idx );
+
+   Vertex = (float *) Grow( Vertex, nVertices, MaxVertices, 3*sizeof(float) );
+   Vertex[3*nVertices]   = (float)x;
+   Vertex[3*nVertices+1] = (float)y;
+   Vertex[3*nVertices+2] = (float)z;
+#ifdef MT_STREAM
+   nVertices++;
+   return( nTotVertices++ );
+#else
+   return( nVertices++ );
+#endif
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Checkpoints.
+//
+
+void TMTBuilder::SaveState( RTCheckpoint C )
+{
+   C.PutInt( Type );
+   C.PutIndex( nTiles );
+   C.PutIndex( nAlive );
+   C.PutIndex( CurUpdate );
+   C.PutIndex( nVertices );
+   C.Put( Vertex, nVertices * 3*sizeof(float) );
+
+#ifdef MT_STREAM
+   // ...the updates written so far must be on disk
+   if ( !TCheckpoint::Sync( fd ) ) C.Fail();
+
+   C.Put( &EndOffset, sizeof(long) );
+   C.PutIndex( nTotVertices );
+   C.Put( UpdateOffset, CurUpdate * sizeof(long) );
+   C.PutIndex( nKilled );
+   C.Put( Killed, nKilled * sizeof(TIndex) );
+   C.PutIndex( nCreated );
+   C.Put( Created, nCreated * sizeof(TMTStreamTile) );
+#else
+   C.Put( Tile, nTiles * sizeof(TMTFileTile) );
+#endif
+}
+
+
+void TMTBuilder::LoadState( RTCheckpoint C, const char *FileName )
+{
+   Type = C.GetInt();
+   nTiles = C.GetIndex();
+   nAlive = C.GetIndex();
+   CurUpdate = C.GetIndex();
+   nVertices = C.GetIndex();
+   Vertex = (float *) LoadArray( C, Vertex, nVertices, MaxVertices, 3*sizeof(float) );
+
+#ifdef MT_STREAM
+   C.Get( &EndOffset, sizeof(long) );
+   nTotVertices = C.GetIndex();
+   UpdateOffset = (long *) LoadArray( C, UpdateOffset, CurUpdate, MaxUpdates, sizeof(long) );
+   nKilled = C.GetIndex();
+   Killed = (TIndex *) LoadArray( C, Killed, nKilled, MaxKilled, sizeof(TIndex) );
+   nCreated = C.GetIndex();
+   Created = (TMTStreamTile *) LoadArray( C, Created, nCreated, MaxCreated, sizeof(TMTStreamTile) );
+
+   // ...drop the updates written after the checkpoint
+   fd = fopen( FileName, "r+b" );
+   check( (fd == NULL), "TMTBuilder::LoadState(), cannot open MT file" );
+   check( (!TCheckpoint::Truncate( fd, EndOffset )),
+          "TMTBuilder::LoadState(), MT file shorter than the checkpoint" );
+#else
+   Tile = (TMTFileTile *) LoadArray( C, Tile, nTiles, MaxTiles, sizeof(TMTFileTile) );
+#endif
+}
+
+
+#ifdef MT_STREAM
+
+// ----------------------------------------------------------------------
+//
+//  Streaming mode: each update is written when it is completed.
+//
+
+void TMTBuilder::StartHistory( int HistoryType, const char *FileName )
+{
+   Type = HistoryType;
+   nVertices = nTotVertices = nTiles = nAlive = 0;
+   nKilled = nCreated = 0;
+   CurUpdate = 0;
+
+   fd = fopen( FileName, "wb" );
+   check( (fd == NULL), "TMTBuilder::StartHistory(), cannot open output file" );
+   WriteHeader( -1, -1, -1 );
+   PadFile();
+   EndOffset = ftell( fd );
+}
+
+
+void TMTBuilder::WriteHeader( TIndex nv, TIndex nt, TIndex nn )
+{
+   TMTFileHeader H;
+
+   memset( &H, 0, sizeof(H) );
+   memcpy( H.Magic, MTSTREAM_MAGIC, 4 );
+   H.IndexSize = sizeof(TIndex);
+   H.HistoryType = FileType();
+   H.DescLen = ( Description != NULL && nn >= 0 ? strlen(Description) : 0 );
+   H.nVertices = nv;
+   H.nTiles = nt;
+   H.nNodes = nn;
+
+   fseek( fd, 0L, SEEK_SET );
+   check( (fwrite( &H, sizeof(H), 1, fd ) != 1),
+          "TMTBuilder::WriteHeader(), error writing MT file" );
+}
+
+
+TIndex TMTBuilder::MakeTile( TIndex V0, TIndex V1, TIndex V2, double Error )
+{
+   Created = (TMTStreamTile *) Grow( Created, nCreated, MaxCreated, sizeof(TMTStreamTile) );
+
+   TMTStreamTile &T = Created[nCreated++];
+   T.V[0] = V0;
+   T.V[1] = V1;
+   T.V[2] = V2;
+   T.Error = (float)Error;
+
+   nAlive++;
+   return( nTiles++ );
+}
+
+
+void TMTBuilder::KillTile( TIndex Idx )
+{
+   check( (Idx < 0 || Idx >= nTiles), "TMTBuilder::KillTile(), tile not alive" );
+   Killed = (TIndex *) Grow( Killed, nKilled, MaxKilled, sizeof(TIndex) );
+   Killed[nKilled++] = Idx;
+   nAlive--;
+}
+
+
+void TMTBuilder::EndUpdate()
+{
+   WriteUpdate();
+   CurUpdate++;
+}
+
+
+//
+// Write zeroes up to the next multiple of MTFILE_ALIGN bytes.
+//
+
+void TMTBuilder::PadFile()
+{
+   static const char Pad[MTFILE_ALIGN] = { 0 };
+   size_t len = ( MTFILE_ALIGN - ftell( fd ) % MTFILE_ALIGN ) % MTFILE_ALIGN;
+
+   check( (fwrite( Pad, 1, len, fd ) != len), "TMTBuilder::PadFile(), error writing MT file" );
+}
+
+
+void TMTBuilder::WriteUpdate()
+{
+   TMTStreamUpdate U;
+
+   UpdateOffset = (long *) Grow( UpdateOffset, CurUpdate, MaxUpdates, sizeof(long) );
+   UpdateOffset[CurUpdate] = ftell( fd );
+
+   U.nKilled = nKilled;
+   U.nCreated = nCreated;
+   U.nNewVertices = nVertices;
+
+   boolean ok =
+      fwrite( &U, sizeof(U), 1, fd ) == 1 &&
+      fwrite( Killed, sizeof(TIndex), nKilled, fd ) == (size_t)nKilled &&
+      fwrite( Created, sizeof(TMTStreamTile), nCreated, fd ) == (size_t)nCreated &&
+      fwrite( Vertex, 3*sizeof(float), nVertices, fd ) == (size_t)nVertices;
+   check( (!ok), "TMTBuilder::WriteUpdate(), error writing MT file" );
+   PadFile();
+   EndOffset = ftell( fd );
+
+   // let readers see the update
+   fflush( fd );
+
+   nKilled = nCreated = nVertices = 0;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  void TMTBuilder::EndHistory( const char *FileName )
+//
+//  Write the last update (if not empty), the footer, and the counts
+//  in the header. The program must have removed all tiles.
+//
+
+void TMTBuilder::EndHistory( const char *FileName )
+{
+   if ( nKilled > 0 || nCreated > 0 ) EndUpdate();
+
+   check( (nAlive > 0), "TMTBuilder::EndHistory(), final triangulation not removed" );
+
+   TIndex DescLen = ( Description != NULL ? strlen(Description) : 0 );
+   boolean ok =
+      fwrite( UpdateOffset, sizeof(long), CurUpdate, fd ) == (size_t)CurUpdate &&
+      fwrite( Description, 1, DescLen, fd ) == (size_t)DescLen;
+   check( (!ok), "TMTBuilder::EndHistory(), error writing MT file" );
+
+   WriteHeader( nTotVertices, nTiles, CurUpdate );
+   fclose( fd );
+   fd = NULL;
+
+   cerr << "MT with " << CurUpdate << " nodes, " << nTiles << " tiles, "
+        << nTotVertices << " vertices written on " << FileName << endl;
+}
+
+
+#else // MT_STREAM
+
+// ----------------------------------------------------------------------
+//
+//  Recording the history.
+//
+
+void TMTBuilder::StartHistory( int HistoryType, const char *FileName )
+{
+   Type = HistoryType;
+   nVertices = nTiles = nAlive = 0;
+   CurUpdate = 0;
+}
+
+
+TIndex TMTBuilder::MakeTile( TIndex V0, TIndex V1, TIndex V2, double Error )
+{
+   Tile = (TMTFileTile *) Grow( Tile, nTiles, MaxTiles, sizeof(TMTFileTile) );
+
+   TMTFileTile &T = Tile[nTiles];
+
+   T.V[0] = V0;
+   T.V[1] = V1;
+   T.V[2] = V2;
+   T.Creator = CurUpdate;
+   T.Killer = -1;
+   T.Error = (float)Error;
+
+   nAlive++;
+   return( nTiles++ );
+}
+
+
+void TMTBuilder::KillTile( TIndex Idx )
+{
+   check( (Idx < 0 || Idx >= nTiles || Tile[Idx].Killer != -1),
+          "TMTBuilder::KillTile(), tile not alive" );
+   Tile[Idx].Killer = CurUpdate;
+   nAlive--;
+}
+
+
+void TMTBuilder::EndUpdate()
+{
+   CurUpdate++;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  void TMTBuilder::EndHistory( const char *FileName )
+//
+//  Convert the history into an MT (see MTIndexHistory() in mtfile.h)
+//  and write it.
+//
+
+void TMTBuilder::EndHistory( const char *FileName )
+{
+   TIndex nNodes = CurUpdate;
+   TIndex *NodeFirstTile, *NodeFirstKilled, *KilledTile;
+
+   TMTFileTile *T = MTIndexHistory( FileType(), Tile, nTiles, nNodes,
+                                    NodeFirstTile, NodeFirstKilled, KilledTile );
+   nAlive = 0;
+
+   FILE *fd = fopen( FileName, "wb" );
+   check( (fd == NULL), "TMTBuilder::EndHistory(), cannot open output file" );
+   Write( fd, T, NodeFirstTile, NodeFirstKilled, KilledTile, nNodes );
+   fclose( fd );
+
+   cerr << "MT with " << nNodes << " nodes, " << nTiles << " tiles, "
+        << nVertices << " vertices written on " << FileName << endl;
+
+   if ( T != Tile ) free( T );
+   free( NodeFirstTile );
+   free( NodeFirstKilled );
+   free( KilledTile );
+}
+
+
+void TMTBuilder::Write( FILE *fd, TMTFileTile *T, TIndex *NodeFirstTile,
+                        TIndex *NodeFirstKilled, TIndex *KilledTile, TIndex nNodes )
+{
+   TMTFileHeader H;
+
+   memset( &H, 0, sizeof(H) );
+   memcpy( H.Magic, MTFILE_MAGIC, 4 );
+   H.IndexSize = sizeof(TIndex);
+   H.HistoryType = FileType();
+   H.DescLen = ( Description != NULL ? strlen(Description) : 0 );
+   H.nVertices = nVertices;
+   H.nTiles = nTiles;
+   H.nNodes = nNodes;
+
+   boolean ok =
+      fwrite( &H, sizeof(H), 1, fd ) == 1 &&
+      fwrite( T, sizeof(TMTFileTile), nTiles, fd ) == (size_t)nTiles &&
+      fwrite( NodeFirstTile, sizeof(TIndex), nNodes+1, fd ) == (size_t)(nNodes+1) &&
+      fwrite( NodeFirstKilled, sizeof(TIndex), nNodes+1, fd ) == (size_t)(nNodes+1) &&
+      fwrite( KilledTile, sizeof(TIndex), nTiles, fd ) == (size_t)nTiles &&
+      fwrite( Vertex, 3*sizeof(float), nVertices, fd ) == (size_t)nVertices &&
+      fwrite( Description, 1, H.DescLen, fd ) == (size_t)H.DescLen;
+
+   check( (!ok), "TMTBuilder::Write(), error writing MT file" );
+}
+
+#endif // MT_STREAM
+
+#endif // MT_NATIVE
@@ -0,0 +1,150 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : mtbuild.h
+//
+//   Definition of class TMTBuilder, which records the history of the
+//   updates of a triangulation and turns it into a Multi-Triangulation
+//   (MT), written as a binary file in the format of mtfile.h.
+//   It is used by class MTTracer when macro MT_NATIVE is defined, and
+//   does not need the external MT library.
+//
+//   The history is kept in growing arrays: the vertices used so far,
+//   and all tiles created so far, each with the update that created it
+//   and the update that removed it (or -1 while it is still alive).
+//   If macro MT_STREAM is defined, only the current update is kept in
+//   memory, and it is appended to the MT file when it is completed.
+//
+
+
+#ifndef _MTBUILD_H
+#define _MTBUILD_H
+
+#include <stdio.h>
+#include "defs.h"
+#include "mtfile.h"
+#include "checkpoint.h"
+
+#ifdef MT_NATIVE
+
+
+class TMTBuilder;
+
+typedef TMTBuilder *PTMTBuilder;
+
+
+class TMTBuilder
+{
+   private:
+
+      int Type;                  // MT_REFINING or MT_COARSENING
+
+      float *Vertex;             // coordinates of the vertices
+      TIndex nVertices, MaxVertices;
+
+      TIndex nTiles;             // number of tiles created so far
+      TIndex nAlive;             // number of tiles not yet removed
+      TIndex CurUpdate;          // index of the update in progress
+
+      char *Description;
+
+      // History type as stored in the file header.
+      int FileType();
+
+#ifdef MT_STREAM
+
+      FILE *fd;                  // MT file being written
+
+      // Current update: tiles removed and created, and coordinates of
+      // the vertices used for the first time (Vertex, nVertices are the
+      // ones of the current update, and nTotVertices the total count).
+      TIndex *Killed;
+      TIndex nKilled, MaxKilled;
+      TMTStreamTile *Created;
+      TIndex nCreated, MaxCreated;
+      TIndex nTotVertices;
+
+      // Position of each update in the file, and end of the last one
+      // (the file offset itself is shared with the process writing
+      // a checkpoint, see SaveState()).
+      long *UpdateOffset;
+      TIndex MaxUpdates;
+      long EndOffset;
+
+      void WriteUpdate();
+      void PadFile();
+      void WriteHeader( TIndex nv, TIndex nt, TIndex nn );
+
+#else
+
+      TMTFileTile *Tile;         // all tiles, in order of creation
+      TIndex MaxTiles;
+
+      // Write the converted MT on a file.
+      void Write( FILE *fd, TMTFileTile *T, TIndex *NodeFirstTile,
+                  TIndex *NodeFirstKilled, TIndex *KilledTile, TIndex nNodes );
+
+#endif
+
+   public:
+
+      TMTBuilder();
+      ~TMTBuilder();
+
+      // Start the history; with MT_STREAM, the MT is written on file
+      // FileName while the history goes on.
+      void StartHistory( int HistoryType, const char *FileName );
+
+      // Return the index of a vertex with the given coordinates; if
+      // Idx >= 0 the vertex has already been used and Idx is returned.
+      TIndex UseVertex( TIndex Idx, double x, double y, double z );
+
+      // Record a new tile in the current update, and return its index.
+      TIndex MakeTile( TIndex V0, TIndex V1, TIndex V2, double Error );
+
+      // Record the removal of a tile in the current update.
+      void KillTile( TIndex Idx );
+
+      // Close the current update.
+      void EndUpdate();
+
+      // Close the history, convert it into an MT in the refinement
+      // direction and write it on file FileName (with MT_STREAM, just
+      // complete the file).
+      void EndHistory( const char *FileName );
+
+      void SetDescription( const char *Desc );
+
+      // Write / read the history on / from a checkpoint. With MT_STREAM,
+      // the checkpoint records the length of the MT file, which is cut
+      // back to it when resuming.
+      void SaveState( RTCheckpoint C );
+      void LoadState( RTCheckpoint C, const char *FileName );
+};
+
+
+#endif // MT_NATIVE
+
+#endif // _MTBUILD_H
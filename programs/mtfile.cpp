@@ -0,0 +1,113 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : mtfile.cpp
+//
+//   Functions shared by the programs that write and read MT files
+//   (see mtfile.h).
+//
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "mtfile.h"
+
+
+// ----------------------------------------------------------------------
+//
+//  TMTFileTile *MTIndexHistory( ... )
+//
+//  All steps use counting sorts on node indices, so the whole
+//  conversion takes linear time.
+//
+
+TMTFileTile *MTIndexHistory( int HistoryType, TMTFileTile *Tile, TIndex nTiles,
+                             TIndex &nNodes, TIndex *&NodeFirstTile,
+                             TIndex *&NodeFirstKilled, TIndex *&KilledTile )
+{
+   TIndex i, n;
+   boolean drain = FALSE;
+
+   for( i=0; i<nTiles; i++ )
+      if ( Tile[i].Killer == -1 )
+      {
+         Tile[i].Killer = nNodes;
+         drain = TRUE;
+      }
+   if ( drain ) nNodes++;
+
+   if ( HistoryType == MTFILE_COARSENING )
+      for( i=0; i<nTiles; i++ )
+      {
+         TIndex c = Tile[i].Creator;
+         Tile[i].Creator = nNodes - 1 - Tile[i].Killer;
+         Tile[i].Killer  = nNodes - 1 - c;
+      }
+
+   NodeFirstTile   = (TIndex *) calloc( nNodes+1, sizeof(TIndex) );
+   NodeFirstKilled = (TIndex *) calloc( nNodes+1, sizeof(TIndex) );
+   KilledTile      = (TIndex *) malloc( (nTiles+1) * sizeof(TIndex) );
+   check( (NodeFirstTile == NULL || NodeFirstKilled == NULL || KilledTile == NULL),
+          "MTIndexHistory(), insufficient memory" );
+
+   //
+   // sort tiles by creator
+   //
+
+   for( i=0; i<nTiles; i++ )
+      NodeFirstTile[ Tile[i].Creator+1 ]++;
+   for( n=0; n<nNodes; n++ )
+      NodeFirstTile[n+1] += NodeFirstTile[n];
+
+   TMTFileTile *T = Tile;
+   if ( HistoryType == MTFILE_COARSENING )
+   {
+      T = (TMTFileTile *) malloc( (nTiles+1) * sizeof(TMTFileTile) );
+      check( (T == NULL), "MTIndexHistory(), insufficient memory" );
+
+      // NodeFirstKilled is used here as the next free place of each node
+      memcpy( NodeFirstKilled, NodeFirstTile, (nNodes+1) * sizeof(TIndex) );
+      for( i=0; i<nTiles; i++ )
+         T[ NodeFirstKilled[ Tile[i].Creator ]++ ] = Tile[i];
+      memset( NodeFirstKilled, 0, (nNodes+1) * sizeof(TIndex) );
+   }
+
+   //
+   // index tiles by killer
+   //
+
+   for( i=0; i<nTiles; i++ )
+      NodeFirstKilled[ T[i].Killer+1 ]++;
+   for( n=0; n<nNodes; n++ )
+      NodeFirstKilled[n+1] += NodeFirstKilled[n];
+   for( i=0; i<nTiles; i++ )
+      KilledTile[ NodeFirstKilled[ T[i].Killer ]++ ] = i;
+   for( n=nNodes; n>0; n-- )
+      NodeFirstKilled[n] = NodeFirstKilled[n-1];
+   NodeFirstKilled[0] = 0;
+
+   return( T );
+}
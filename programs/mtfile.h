@@ -0,0 +1,156 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : mtfile.h
+//
+//   Layout of the binary files containing a Multi-Triangulation (MT),
+//   as written by class TMTBuilder (see mtbuild.h).
+//
+//   The MT is always stored in the refinement direction: node 0 is the
+//   root, which creates the coarsest mesh, and the last node is the
+//   drain, which removes the finest one. Each tile (triangle) is created
+//   by one node and removed by a later one, i.e., it labels an arc of
+//   the DAG. The file consists of the following sections, each one
+//   aligned to the size of TIndex, so that it can be mapped in memory
+//   and used in place:
+//
+//     TMTFileHeader   Header;
+//     TMTFileTile     Tile[nTiles];           sorted by creator node
+//     TIndex          NodeFirstTile[nNodes+1];
+//     TIndex          NodeFirstKilled[nNodes+1];
+//     TIndex          KilledTile[nTiles];     sorted by killer node
+//     float           Vertex[nVertices][3];
+//     char            Description[DescLen];
+//
+//   The tiles created by node n are Tile[NodeFirstTile[n]] ...
+//   Tile[NodeFirstTile[n+1]-1]; the tiles removed by node n are those
+//   indexed by KilledTile[NodeFirstKilled[n]] ...
+//   KilledTile[NodeFirstKilled[n+1]-1].
+//
+//   When macro MT_STREAM is defined, the builder writes instead each
+//   update as soon as it is completed, in the order of the history
+//   (i.e., in the coarsening direction for a decimation), so that the
+//   history never needs to be kept in memory and the file can be read
+//   while it is growing:
+//
+//     TMTFileHeader   Header;                 Magic = MTSTREAM_MAGIC
+//     (padding to a multiple of MTFILE_ALIGN bytes)
+//     for each update:
+//        TMTStreamUpdate  Update;
+//        TIndex           Killed[nKilled];
+//        TMTStreamTile    Created[nCreated];
+//        float            NewVertex[nNewVertices][3];
+//        (padding to a multiple of MTFILE_ALIGN bytes)
+//     long            UpdateOffset[nNodes];   position of each update
+//     char            Description[DescLen];
+//
+//   Tiles and vertices are numbered in the order in which they appear
+//   in the file. The counts in the header are -1 until the history is
+//   complete, then they are filled in; the footer (offsets and
+//   description) starts nNodes*sizeof(long)+DescLen bytes before the end.
+//
+
+
+#ifndef _MTFILE_H
+#define _MTFILE_H
+
+#include "defs.h"
+
+
+// Magic strings at the beginning of the file.
+#define MTFILE_MAGIC    "DMT1"
+#define MTSTREAM_MAGIC  "DMS1"
+
+// Alignment of the updates in a streamed file.
+const int MTFILE_ALIGN = 8;
+
+// Values of field HistoryType of the header.
+const int MTFILE_REFINING   = 1;
+const int MTFILE_COARSENING = 2;
+
+
+typedef struct
+{
+   char   Magic[4];       // MTFILE_MAGIC
+   int    IndexSize;      // sizeof(TIndex) of the program that wrote it
+   int    HistoryType;    // MTFILE_REFINING or MTFILE_COARSENING
+   int    DescLen;        // length of the description
+   TIndex nVertices;
+   TIndex nTiles;
+   TIndex nNodes;
+} TMTFileHeader;
+
+
+typedef struct
+{
+   TIndex V[3];           // vertices, in counterclockwise order
+   TIndex Creator;        // node creating the tile
+   TIndex Killer;         // node removing the tile
+   float  Error;          // approximation error of the tile
+} TMTFileTile;
+
+
+typedef struct
+{
+   TIndex nKilled;        // number of tiles removed by the update
+   TIndex nCreated;       // number of tiles created by the update
+   TIndex nNewVertices;   // number of vertices used for the first time
+} TMTStreamUpdate;
+
+
+typedef struct
+{
+   TIndex V[3];           // vertices, in counterclockwise order
+   float  Error;          // approximation error of the tile
+} TMTStreamTile;
+
+
+//
+// Size in bytes of the sections preceding the vertices and the
+// description.
+//
+
+inline long MTFileTopologySize( TIndex nTiles, TIndex nNodes )
+{
+   return( (long)sizeof(TMTFileHeader) + (long)nTiles * sizeof(TMTFileTile)
+           + (long)( 2*(nNodes+1) + nTiles ) * sizeof(TIndex) );
+}
+
+
+//
+// Turn a history into the layout of an MT file. On input, the Creator
+// and Killer of each tile are the indices of the updates in the order
+// of the history (Killer is -1 for tiles never removed), and nNodes is
+// the number of updates. Tiles never removed are given to a new drain
+// node, a coarsening history is reversed, and the tiles are sorted
+// by creator. Return the sorted tiles (Tile itself if it was already
+// sorted, otherwise a new array) and allocate the three indices.
+//
+
+TMTFileTile *MTIndexHistory( int HistoryType, TMTFileTile *Tile, TIndex nTiles,
+                             TIndex &nNodes, TIndex *&NodeFirstTile,
+                             TIndex *&NodeFirstKilled, TIndex *&KilledTile );
+
+#endif // _MTFILE_H
@@ -0,0 +1,539 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : mtquery.cpp
+//
+//   Implementation of class TMTQuery (see mtquery.h).
+//
+
+
+#include <iostream>
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "error.h"
+#include "mtquery.h"
+
+using namespace std;
+
+
+// Initial capacity of the stacks and of the arrays of a streamed file.
+const TIndex MTQ_INITSIZE = 1024;
+
+
+//
+// Make room for one more element in array p of Size-byte elements,
+// containing n elements out of Max.
+//
+
+static void *Grow( void *p, TIndex n, TIndex &Max, size_t Size )
+{
+   if ( n < Max ) return( p );
+   Max = ( Max == 0 ? MTQ_INITSIZE : 2*Max );
+   p = realloc( p, Max * Size );
+   check( (p == NULL), "TMTQuery, insufficient memory" );
+   return( p );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Constructor and destructor.
+//
+
+TMTQuery::TMTQuery( const char *FileName )
+{
+   TIndex i;
+
+   Data = NULL;
+   DataLen = 0;
+   TileStack = NodeStack = NULL;
+   nTileStack = MaxTileStack = nNodeStack = MaxNodeStack = 0;
+
+   if ( !Load( FileName ) ) LoadStream( FileName );
+
+   InCut    = (boolean *) calloc( nNodes, sizeof(boolean) );
+   nCovered = (TIndex *) calloc( nNodes, sizeof(TIndex) );
+   Mesh     = (TIndex *) malloc( (nTiles+1) * sizeof(TIndex) );
+   MeshPos  = (TIndex *) malloc( (nTiles+1) * sizeof(TIndex) );
+   check( (InCut == NULL || nCovered == NULL || Mesh == NULL || MeshPos == NULL),
+          "TMTQuery::TMTQuery(), insufficient memory" );
+
+   for( i=0; i<nTiles; i++ ) MeshPos[i] = -1;
+   nMesh = 0;
+
+   //
+   // initial cut: the root
+   //
+
+   InCut[0] = TRUE;
+   for( i=NodeFirstTile[0]; i<NodeFirstTile[1]; i++ )
+      MeshAdd( i );
+
+   SetUniform( 0.0 );
+}
+
+
+TMTQuery::~TMTQuery()
+{
+   if ( Data != NULL )
+      munmap( Data, DataLen );
+   else
+   {
+      free( Tile );
+      free( NodeFirstTile );
+      free( NodeFirstKilled );
+      free( KilledTile );
+      free( Vertex );
+   }
+   free( InCut );
+   free( nCovered );
+   free( Mesh );
+   free( MeshPos );
+   if ( TileStack != NULL ) free( TileStack );
+   if ( NodeStack != NULL ) free( NodeStack );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  boolean TMTQuery::Load( const char *FileName )
+//
+//  Map a complete MT file in memory and set the pointers to its
+//  sections. Return FALSE if the file is a streamed one.
+//
+
+boolean TMTQuery::Load( const char *FileName )
+{
+   struct stat st;
+   TMTFileHeader *H;
+   int fd;
+
+   fd = open( FileName, O_RDONLY );
+   check( (fd < 0), "TMTQuery::Load(), cannot open MT file" );
+   check( (fstat( fd, &st ) != 0 || st.st_size < (long)sizeof(TMTFileHeader)),
+          "TMTQuery::Load(), invalid MT file" );
+
+   DataLen = st.st_size;
+   Data = (char *) mmap( NULL, DataLen, PROT_READ, MAP_PRIVATE, fd, 0 );
+   close( fd );
+   check( (Data == (char *) MAP_FAILED), "TMTQuery::Load(), cannot map MT file" );
+
+   H = (TMTFileHeader *) Data;
+   if ( memcmp( H->Magic, MTFILE_MAGIC, 4 ) != 0 )
+   {
+      check( (memcmp( H->Magic, MTSTREAM_MAGIC, 4 ) != 0),
+             "TMTQuery::Load(), not an MT file" );
+      munmap( Data, DataLen );
+      Data = NULL;
+      return( FALSE );
+   }
+   check( (H->IndexSize != sizeof(TIndex)),
+          "TMTQuery::Load(), MT file written with a different index size" );
+
+   HistoryType = H->HistoryType;
+   nVertices = H->nVertices;
+   nTiles = H->nTiles;
+   nNodes = H->nNodes;
+   check( (nNodes < 1 ||
+           MTFileTopologySize( nTiles, nNodes ) + 3 * (long)sizeof(float) * nVertices
+           + H->DescLen != DataLen),
+          "TMTQuery::Load(), truncated MT file" );
+
+   char *p = Data + sizeof(TMTFileHeader);
+   Tile = (TMTFileTile *) p;          p += nTiles * sizeof(TMTFileTile);
+   NodeFirstTile = (TIndex *) p;      p += (nNodes+1) * sizeof(TIndex);
+   NodeFirstKilled = (TIndex *) p;    p += (nNodes+1) * sizeof(TIndex);
+   KilledTile = (TIndex *) p;         p += nTiles * sizeof(TIndex);
+   Vertex = (float *) p;
+
+   return( TRUE );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  void TMTQuery::LoadStream( const char *FileName )
+//
+//  Read a streamed MT file, possibly still being written (then only
+//  the updates completely written are read), and convert it.
+//
+
+void TMTQuery::LoadStream( const char *FileName )
+{
+   TMTFileHeader H;
+   TMTStreamUpdate U;
+   TMTStreamTile T;
+   TIndex MaxTiles = 0, MaxVertices = 0;
+   TIndex i, nUpd = 0;
+   long pos;
+
+   FILE *fd = fopen( FileName, "rb" );
+   check( (fd == NULL), "TMTQuery::LoadStream(), cannot open MT file" );
+   check( (fread( &H, sizeof(H), 1, fd ) != 1 || H.IndexSize != sizeof(TIndex)),
+          "TMTQuery::LoadStream(), invalid MT file" );
+   HistoryType = H.HistoryType;
+
+   Tile = NULL;
+   Vertex = NULL;
+   nTiles = nVertices = 0;
+
+   pos = sizeof(H);
+   while ( H.nNodes < 0 || nUpd < H.nNodes )
+   {
+      pos += ( MTFILE_ALIGN - pos % MTFILE_ALIGN ) % MTFILE_ALIGN;
+      if ( fseek( fd, pos, SEEK_SET ) != 0 || fread( &U, sizeof(U), 1, fd ) != 1 )
+         break;
+
+      // check that the update is complete before using it
+      long len = sizeof(U) + U.nKilled * sizeof(TIndex)
+                 + U.nCreated * sizeof(TMTStreamTile) + U.nNewVertices * 3 * sizeof(float);
+      if ( fseek( fd, pos + len - 1, SEEK_SET ) != 0 || fgetc( fd ) == EOF )
+         break;
+      fseek( fd, pos + sizeof(U), SEEK_SET );
+
+      for( i=0; i<U.nKilled; i++ )
+      {
+         TIndex k;
+         check( (fread( &k, sizeof(k), 1, fd ) != 1 || k < 0 || k >= nTiles),
+                "TMTQuery::LoadStream(), invalid MT file" );
+         Tile[k].Killer = nUpd;
+      }
+      for( i=0; i<U.nCreated; i++ )
+      {
+         check( (fread( &T, sizeof(T), 1, fd ) != 1), "TMTQuery::LoadStream(), invalid MT file" );
+         Tile = (TMTFileTile *) Grow( Tile, nTiles, MaxTiles, sizeof(TMTFileTile) );
+         memcpy( Tile[nTiles].V, T.V, sizeof(T.V) );
+         Tile[nTiles].Creator = nUpd;
+         Tile[nTiles].Killer = -1;
+         Tile[nTiles].Error = T.Error;
+         nTiles++;
+      }
+      for( i=0; i<U.nNewVertices; i++ )
+      {
+         Vertex = (float *) Grow( Vertex, nVertices, MaxVertices, 3*sizeof(float) );
+         check( (fread( Vertex + 3*nVertices, sizeof(float), 3, fd ) != 3),
+                "TMTQuery::LoadStream(), invalid MT file" );
+         nVertices++;
+      }
+
+      pos += len;
+      nUpd++;
+   }
+   fclose( fd );
+
+   check( (nUpd == 0), "TMTQuery::LoadStream(), empty MT file" );
+   if ( H.nNodes < 0 )
+      cerr << "MT file still being written, " << nUpd << " updates read" << endl;
+
+   nNodes = nUpd;
+   TMTFileTile *Sorted = MTIndexHistory( HistoryType, Tile, nTiles, nNodes,
+                                         NodeFirstTile, NodeFirstKilled, KilledTile );
+   if ( Sorted != Tile )
+   {
+      free( Tile );
+      Tile = Sorted;
+   }
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Setting the query.
+//
+
+void TMTQuery::SetUniform( double iEps )
+{
+   Type = QUERY_UNIFORM;
+   Eps = iEps;
+}
+
+void TMTQuery::SetROI( double iEps, double iEpsOut,
+                       double x0, double y0, double x1, double y1 )
+{
+   Type = QUERY_ROI;
+   Eps = iEps;
+   EpsOut = iEpsOut;
+   Box[0] = ( x0 < x1 ? x0 : x1 );
+   Box[1] = ( y0 < y1 ? y0 : y1 );
+   Box[2] = ( x0 < x1 ? x1 : x0 );
+   Box[3] = ( y0 < y1 ? y1 : y0 );
+}
+
+void TMTQuery::SetView( double iEps, double vx, double vy, double vz )
+{
+   Type = QUERY_VIEW;
+   Eps = iEps;
+   View[0] = vx;
+   View[1] = vy;
+   View[2] = vz;
+}
+
+
+boolean TMTQuery::Fails( TIndex t )
+{
+   TMTFileTile &T = Tile[t];
+   float *v0, *v1, *v2;
+   double min[3], max[3], d, dd;
+   int k;
+
+   if ( Type == QUERY_UNIFORM ) return( T.Error > Eps );
+
+   v0 = Vertex + 3*T.V[0];
+   v1 = Vertex + 3*T.V[1];
+   v2 = Vertex + 3*T.V[2];
+   for( k=0; k<3; k++ )
+   {
+      min[k] = max[k] = v0[k];
+      if ( v1[k] < min[k] ) min[k] = v1[k]; else if ( v1[k] > max[k] ) max[k] = v1[k];
+      if ( v2[k] < min[k] ) min[k] = v2[k]; else if ( v2[k] > max[k] ) max[k] = v2[k];
+   }
+
+   if ( Type == QUERY_ROI )
+   {
+      if ( max[0] < Box[0] || min[0] > Box[2] || max[1] < Box[1] || min[1] > Box[3] )
+         return( T.Error > EpsOut );
+      return( T.Error > Eps );
+   }
+
+   // QUERY_VIEW: distance from the viewpoint to the bounding box
+   dd = 0.0;
+   for( k=0; k<3; k++ )
+   {
+      d = 0.0;
+      if ( View[k] < min[k] ) d = min[k] - View[k];
+      else if ( View[k] > max[k] ) d = View[k] - max[k];
+      dd += d*d;
+   }
+   return( T.Error > Eps * sqrt( dd ) );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Maintenance of the current mesh and of the stacks.
+//
+
+void TMTQuery::MeshAdd( TIndex t )
+{
+   MeshPos[t] = nMesh;
+   Mesh[nMesh++] = t;
+}
+
+void TMTQuery::MeshRemove( TIndex t )
+{
+   TIndex last = Mesh[--nMesh];
+   Mesh[ MeshPos[t] ] = last;
+   MeshPos[last] = MeshPos[t];
+   MeshPos[t] = -1;
+}
+
+void TMTQuery::PushTile( TIndex t )
+{
+   TileStack = (TIndex *) Grow( TileStack, nTileStack, MaxTileStack, sizeof(TIndex) );
+   TileStack[nTileStack++] = t;
+}
+
+void TMTQuery::PushNode( TIndex n )
+{
+   NodeStack = (TIndex *) Grow( NodeStack, nNodeStack, MaxNodeStack, sizeof(TIndex) );
+   NodeStack[nNodeStack++] = n;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  void TMTQuery::AddNode( TIndex n )
+//
+//  The ancestors are added first, by using the node stack: the node
+//  on top is added as soon as all the tiles it removes are in the
+//  mesh (i.e., their creators are in the cut). The tiles created by
+//  added nodes are pushed on the tile stack, to be checked by Refine().
+//
+
+void TMTQuery::AddNode( TIndex n )
+{
+   TIndex i, m;
+   boolean ready;
+
+   PushNode( n );
+   while ( nNodeStack > 0 )
+   {
+      m = NodeStack[nNodeStack-1];
+      if ( InCut[m] ) { nNodeStack--; continue; }
+
+      ready = TRUE;
+      for( i=NodeFirstKilled[m]; i<NodeFirstKilled[m+1]; i++ )
+      {
+         TIndex c = Tile[ KilledTile[i] ].Creator;
+         if ( !InCut[c] ) { PushNode( c ); ready = FALSE; }
+      }
+      if ( !ready ) continue;
+
+      nNodeStack--;
+      InCut[m] = TRUE;
+      for( i=NodeFirstKilled[m]; i<NodeFirstKilled[m+1]; i++ )
+      {
+         TIndex k = KilledTile[i];
+         MeshRemove( k );
+         nCovered[ Tile[k].Creator ]++;
+      }
+      for( i=NodeFirstTile[m]; i<NodeFirstTile[m+1]; i++ )
+      {
+         MeshAdd( i );
+         PushTile( i );
+      }
+   }
+}
+
+
+void TMTQuery::RemoveNode( TIndex n )
+{
+   TIndex i;
+
+   InCut[n] = FALSE;
+   for( i=NodeFirstTile[n]; i<NodeFirstTile[n+1]; i++ )
+      MeshRemove( i );
+   for( i=NodeFirstKilled[n]; i<NodeFirstKilled[n+1]; i++ )
+   {
+      TIndex k = KilledTile[i];
+      MeshAdd( k );
+      if ( --nCovered[ Tile[k].Creator ] == 0 )
+         PushNode( Tile[k].Creator );
+   }
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Selective refinement.
+//
+//  Coarsen() removes from the cut the nodes without children in the
+//  cut whose removal brings back only tiles satisfying the query;
+//  Refine() then adds the nodes removing tiles that do not satisfy it.
+//  The drain is never added, since it removes the tiles at full
+//  resolution.
+//
+
+void TMTQuery::Coarsen()
+{
+   TIndex i, n;
+   boolean ok;
+
+   nNodeStack = 0;
+   for( i=0; i<nMesh; i++ )
+   {
+      n = Tile[ Mesh[i] ].Creator;
+      if ( n > 0 && nCovered[n] == 0 ) PushNode( n );
+   }
+
+   while ( nNodeStack > 0 )
+   {
+      n = NodeStack[--nNodeStack];
+      if ( n == 0 || !InCut[n] || nCovered[n] > 0 ) continue;
+
+      ok = TRUE;
+      for( i=NodeFirstKilled[n]; ok && i<NodeFirstKilled[n+1]; i++ )
+         ok = !Fails( KilledTile[i] );
+      if ( ok ) RemoveNode( n );
+   }
+}
+
+
+void TMTQuery::Refine()
+{
+   TIndex i, t;
+
+   nTileStack = 0;
+   for( i=0; i<nMesh; i++ ) PushTile( Mesh[i] );
+
+   while ( nTileStack > 0 )
+   {
+      t = TileStack[--nTileStack];
+      if ( MeshPos[t] < 0 ) continue;
+      if ( Tile[t].Killer < nNodes-1 && Fails( t ) )
+         AddNode( Tile[t].Killer );
+   }
+}
+
+
+void TMTQuery::Extract()
+{
+   Coarsen();
+   Refine();
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  void TMTQuery::WriteMesh( const char *FileName )
+//
+//  Write the vertices used by the current mesh and its triangles.
+//
+
+void TMTQuery::WriteMesh( const char *FileName )
+{
+   TIndex i, k, nv = 0;
+   TIndex *NewIdx = (TIndex *) malloc( (nVertices+1) * sizeof(TIndex) );
+   TIndex *Used   = (TIndex *) malloc( (nVertices+1) * sizeof(TIndex) );
+   check( (NewIdx == NULL || Used == NULL), "TMTQuery::WriteMesh(), insufficient memory" );
+
+   for( i=0; i<nVertices; i++ ) NewIdx[i] = -1;
+   for( i=0; i<nMesh; i++ )
+      for( k=0; k<3; k++ )
+      {
+         TIndex v = Tile[ Mesh[i] ].V[k];
+         if ( NewIdx[v] < 0 ) { NewIdx[v] = nv; Used[nv++] = v; }
+      }
+
+   ofstream outFile;
+   outFile.open( FileName );
+   check( (!outFile), "TMTQuery::WriteMesh(), cannot open output file" );
+   outFile.precision( 12 );
+
+   outFile << nv << endl;
+   for( i=0; i<nv; i++ )
+   {
+      float *c = Vertex + 3*Used[i];
+      outFile << c[0] << " " << c[1] << " " << c[2] << endl;
+   }
+   outFile << nMesh << endl;
+   for( i=0; i<nMesh; i++ )
+   {
+      TIndex *V = Tile[ Mesh[i] ].V;
+      outFile << NewIdx[V[0]] << " " << NewIdx[V[1]] << " " << NewIdx[V[2]] << endl;
+   }
+   outFile.close();
+
+   free( NewIdx );
+   free( Used );
+}
@@ -0,0 +1,166 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : mtquery.h
+//
+//   Definition of class TMTQuery, which extracts triangle meshes from
+//   an MT file (see mtfile.h) through selective refinement.
+//
+//   The current mesh is described by a cut of the DAG, i.e., a set of
+//   nodes closed with respect to the ancestors and containing the root:
+//   the mesh is made of the tiles created by nodes in the cut and
+//   removed by nodes outside it. A query fixes the maximum error
+//   allowed for each tile; Extract() moves the cut, starting from the
+//   current one, until every tile of the mesh satisfies the query and no
+//   node can be removed without violating it. Since the work done
+//   is proportional to the changes, small changes of the query (e.g.,
+//   a slightly different threshold or region of interest) are answered
+//   quickly.
+//
+//   Files written at the end of the history are mapped in memory and
+//   used in place; streamed files (also partial ones, still being
+//   written) are read and converted in memory.
+//
+
+
+#ifndef _MTQUERY_H
+#define _MTQUERY_H
+
+#include "defs.h"
+#include "mtfile.h"
+
+
+// Types of query.
+const int QUERY_UNIFORM = 0;   // same error threshold everywhere
+const int QUERY_ROI     = 1;   // threshold inside a box, another outside
+const int QUERY_VIEW    = 2;   // threshold proportional to the distance
+                               // from a viewpoint
+
+
+class TMTQuery;
+
+typedef TMTQuery *PTMTQuery;
+
+
+class TMTQuery
+{
+   private:
+
+      //
+      // The MT
+      //
+
+      char *Data;                // mapped file, or NULL
+      long DataLen;
+
+      int HistoryType;
+      TIndex nVertices, nTiles, nNodes;
+      TMTFileTile *Tile;
+      TIndex *NodeFirstTile, *NodeFirstKilled, *KilledTile;
+      float *Vertex;
+
+      boolean Load( const char *FileName );
+      void LoadStream( const char *FileName );
+
+      //
+      // The current cut and mesh
+      //
+
+      boolean *InCut;            // nodes in the cut
+      TIndex *nCovered;          // number of tiles of each node removed
+                                 // by nodes in the cut
+      TIndex *Mesh;              // tiles of the current mesh
+      TIndex nMesh;
+      TIndex *MeshPos;           // position of each tile in Mesh, or -1
+
+      // Stacks of tiles and nodes to be examined.
+      TIndex *TileStack, nTileStack, MaxTileStack;
+      TIndex *NodeStack, nNodeStack, MaxNodeStack;
+
+      void PushTile( TIndex t );
+      void PushNode( TIndex n );
+
+      void MeshAdd( TIndex t );
+      void MeshRemove( TIndex t );
+
+      // Add node n and its missing ancestors to the cut.
+      void AddNode( TIndex n );
+
+      // Remove node n from the cut (it must have no children in the cut).
+      void RemoveNode( TIndex n );
+
+      void Refine();
+      void Coarsen();
+
+      //
+      // The current query
+      //
+
+      int Type;
+      double Eps, EpsOut;
+      double Box[4];             // xmin, ymin, xmax, ymax
+      double View[3];
+
+      // TRUE if tile t does not satisfy the query.
+      boolean Fails( TIndex t );
+
+   public:
+
+      // Load the MT in file FileName; the initial mesh is the one
+      // created by the root.
+      TMTQuery( const char *FileName );
+      ~TMTQuery();
+
+      //
+      // Set the query. Tiles with error larger than the threshold must
+      // be refined. With QUERY_ROI, the threshold is Eps for tiles
+      // whose bounding box intersects the box, EpsOut for the others.
+      // With QUERY_VIEW, the threshold of a tile is Eps times its
+      // distance from the viewpoint.
+      //
+
+      void SetUniform( double iEps );
+      void SetROI( double iEps, double iEpsOut,
+                   double x0, double y0, double x1, double y1 );
+      void SetView( double iEps, double vx, double vy, double vz );
+
+      // Update the current mesh so that it satisfies the query.
+      void Extract();
+
+      // Access to the current mesh.
+      TIndex MeshSize() { return( nMesh ); };
+      TMTFileTile &MeshTile( TIndex i ) { return( Tile[ Mesh[i] ] ); };
+      float *VertexCoord( TIndex v ) { return( Vertex + 3*v ); };
+
+      TIndex NumNodes() { return( nNodes ); };
+      TIndex NumTiles() { return( nTiles ); };
+
+      // Write the current mesh on a file, in the format of the
+      // triangulations read and written by the other programs.
+      void WriteMesh( const char *FileName );
+};
+
+
+#endif // _MTQUERY_H
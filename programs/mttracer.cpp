@@ -34,29 +34,20 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //
 
 
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
 #ifdef MT_TRACER
 #include "fieldmt.h"
 #endif
 
-#include "tbtree.h"
 #include "ttriang.h"
 #include "mttracer.h"
 #include "decdel.h"    // for TDecimDelaunay::InitialPhase
 
 
-// for TBTree Errors (used only if norm = NORM_MAX)
-
-int compare( double a , double b )
-{
-   if ( a<b ) return -1;
-   else
-   if ( a>b ) return +1;
-   else
-   return( 0 );
-}
-
-
-
 // -----------------------------------------------------------------------------------------
 //
 //  Constructor of class MTTracer.
@@ -68,9 +59,6 @@ MTTracer::MTTracer(void) : FieldWithErrorBuildingInterfaceClass()
 MTTracer::MTTracer(void)
 #endif
 {
-   TotError = 0.0;
- 
-   nTrgs = 0;
    nUpd = -1;
    // trick to ensure that the first time we call MTTracer::MeshOK()
    // (after creation of the initial triangulation), nUpd is correctly
@@ -78,7 +66,14 @@ MTTracer::MTTracer(void)
 
    // ...by default
    Term = NO_TERM;
-    
+   nLods = 0;
+
+   TimeLev = MemLev = StartTime = 0;
+   TrgLev = nTrg = 0;
+   BudgetHit = FALSE;
+
+   Log = NULL;
+
 }
 
 
@@ -96,6 +91,10 @@ void MTTracer::StartHistory ( int HistoryType )
       StartTileErrorHistory();
 
    #endif
+
+   #ifdef MT_NATIVE
+      Builder.StartHistory( HistoryType, MT_FILE_NAME );
+   #endif
    
    Type = HistoryType;
 }
@@ -132,10 +131,22 @@ void MTTracer::MakeTriangle( PTTriangle T )
       MakeTileError( T->MTIdx, Error );
    }
    #endif
+
+   #ifdef MT_NATIVE
+   {
+      int i;
+      for( i=0; i<3; i++ )
+         V[i]->MTIdx = Builder.UseVertex( V[i]->MTIdx, V[i]->x, V[i]->y, V[i]->z );
+      T->MTIdx = Builder.MakeTile( V[0]->MTIdx, V[1]->MTIdx, V[2]->MTIdx, Error );
+   }
+   #endif
    
+   nTrg++;
    if ( Term == TERM_ERR )
       UpdateError( ADDTRG, Error );
 
+   if ( Log ) Log->MakeTriangle( T );
+
 }
 
 
@@ -156,29 +167,45 @@ void MTTracer::KillTriangle( PTTriangle T )
    #ifdef MT_TRACER
       MT_KillTile( T->MTIdx );
    #endif
+
+   #ifdef MT_NATIVE
+      Builder.KillTile( T->MTIdx );
+      T->MTIdx = -1;
+   #endif
    
+   nTrg--;
    if ( Term == TERM_ERR )
       UpdateError( DELTRG, Error );
+
+   if ( Log ) Log->KillTriangle( T );
    
 }
 
 
 void MTTracer::MeshOk()
 {
-   if( Term == TERM_NUPD  /* &&  TDecimDelaunay::InitialPhase == FALSE */ )
-      nUpd++;
+   // counted also without TERM_NUPD, for the levels of detail
+   nUpd++;
+
+   // ...amortized over several updates, since they need system calls
+   if ( ( TimeLev > 0 || MemLev > 0 ) && nUpd % TERM_CHECK_UPDATES == 0 )
+      CheckBudgets();
    
    #ifdef MT_DEBUG
       MT_DEBUG << "MTTracer::MeshOk(";
       if ( Term == TERM_NUPD ) MT_DEBUG << "nUpd = " << nUpd << ", UpdLev = " << UpdLev;
       else 
-      if ( Term == TERM_ERR ) MT_DEBUG << "TotError" << TotError << ", ErrLev = " << ErrLev; 
+      if ( Term == TERM_ERR ) MT_DEBUG << "TotError" << TotError() << ", ErrLev = " << ErrLev; 
       MT_DEBUG << ")" << endl;
    #endif
 
    #ifdef MT_TRACER
       MT_EndUpdate();
    #endif
+
+   #ifdef MT_NATIVE
+      Builder.EndUpdate();
+   #endif
 }
 
 
@@ -214,6 +241,17 @@ void MTTracer::EndHistory()
       fclose(fd);
       delete mt;
    #endif
+
+   #ifdef MT_NATIVE
+      Builder.EndHistory( MT_FILE_NAME );
+   #endif
+
+   {
+      int i;
+      for( i=0; i<nLods; i++ )
+         if ( !LodDone[i] )
+            cerr << "level of detail " << i << " (" << LodLev[i] << ") not reached" << endl;
+   }
 }
 
 
@@ -225,25 +263,83 @@ void MTTracer::EndHistory()
 //
 
 
-void MTTracer::SetTerminateCondition( int iTerm, int iUpdLev )
+void MTTracer::SetTerminateCondition( int iTerm, TIndex iLev )
 {
-   check( (iTerm != TERM_NUPD), "MTTracer::SetTerminateCondition(), invalid arguments" );
-   Term = iTerm;   
-   UpdLev = iUpdLev;
-      
+   switch( iTerm )
+   {
+      case TERM_NUPD:
+           Term = iTerm;
+           UpdLev = iLev;
+           break;
+
+      // budgets, in addition to the termination condition
+      case TERM_TIME:
+           check( (iLev <= 0), "MTTracer::SetTerminateCondition(), invalid time budget" );
+           TimeLev = (long)iLev;
+           break;
+      case TERM_MEM:
+           check( (iLev <= 0), "MTTracer::SetTerminateCondition(), invalid memory budget" );
+           MemLev = (long)iLev * 1024;
+           break;
+      case TERM_NTRG:
+           check( (iLev <= 0), "MTTracer::SetTerminateCondition(), invalid number of triangles" );
+           TrgLev = iLev;
+           break;
+
+      default:
+           error( "MTTracer::SetTerminateCondition(), invalid arguments" );
+   }
 }
 
-void MTTracer::SetTerminateCondition( int iTerm, int iNorm, double iErrLev )
+void MTTracer::SetTerminateCondition( int iTerm, int iNorm, double iErrLev, double iPct )
 {
    check( (iTerm != TERM_ERR), "MTTracer::SetTerminateCondition(), invalid arguments" );
+   check( (iPct <= 0.0 || iPct > 100.0), "MTTracer::SetTerminateCondition(), invalid percentile" );
    Term   = iTerm;
    Norm   = iNorm;
    ErrLev = iErrLev;
+   Pct    = iPct;
+   Errors.SetLevel( 0, ErrLev );
+}
+
+void MTTracer::SetLodLevels( int iLods, double *iLev )
+{
+   int i;
+
+   check( (iLods < 0 || iLods > MT_MAXLODS), "MTTracer::SetLodLevels(), too many levels" );
+   nLods = iLods;
+   for( i=0; i<nLods; i++ )
+   {
+      LodLev[i]  = iLev[i];
+      LodDone[i] = FALSE;
+      if ( Term == TERM_ERR ) Errors.SetLevel( i+1, LodLev[i] );
+   }
+}
+
+
+double MTTracer::TotError()
+{
+   switch( Norm )
+   {
+      case NORM_MAX: return( Errors.GetMax() );
+      case NORM_MED: return( Errors.Mean() );
+      case NORM_SQM: return( Errors.MeanSquare() );
+      case NORM_PCT: return( Errors.Percentile( Pct ) );
+      default:
+         error( "MTTracer::TotError(), norm not implemented" );
+   }
+   return( 0.0 ); // ...to avoid warning
 }
 
 boolean MTTracer::TerminateCondition()
 {
    
+   if ( BudgetHit ) return( TRUE );
+
+   if ( TrgLev > 0 )
+      if ( Type == MT_REFINING ? nTrg >= TrgLev : nTrg <= TrgLev )
+         return( TRUE );
+
    switch( Term )
    {
    
@@ -254,16 +350,7 @@ boolean MTTracer::TerminateCondition()
 	      return( nUpd >= UpdLev );
 	   }
 	   
-      case TERM_ERR:
-           {
-	      switch( Type )
-	      {
-	          case MT_REFINING: return( TotError <= ErrLev );
-		  case MT_COARSENING: return( TotError >= ErrLev );
-		  default:
-                    error( "MTTracer::TerminateCondition(), <1> inconsistency detected" );
-   	      }
-	   }
+      case TERM_ERR: return( ErrorReached( 0, ErrLev ) );
 	   
       default: 
          error( "MTTracer::TerminateCondition(), <2> inconsistency detected" );
@@ -275,98 +362,187 @@ boolean MTTracer::TerminateCondition()
 }
 
 
+//
+// Wall-clock time in seconds, with the resolution of gettimeofday().
+//
+
+static double WallClock()
+{
+   struct timeval tv;
+
+   gettimeofday( &tv, NULL );
+   return( tv.tv_sec + tv.tv_usec * 1e-6 );
+}
+
+
+void MTTracer::StartClock()
+{
+   StartTime = WallClock();
+}
+
+
+//
+// Peak resident memory is used in place of the current one, which has
+// no portable system call; in kilobytes, as given by getrusage() on
+// Linux.
+//
+
+void MTTracer::CheckBudgets()
+{
+   if ( TimeLev > 0 && WallClock() - StartTime >= TimeLev )
+   {
+      cerr << endl << "time budget of " << TimeLev << " seconds exceeded" << endl;
+      BudgetHit = TRUE;
+   }
+
+   if ( MemLev > 0 )
+   {
+      struct rusage Usage;
+
+      if ( getrusage( RUSAGE_SELF, &Usage ) == 0 && Usage.ru_maxrss >= MemLev )
+      {
+         cerr << endl << "memory budget of " << MemLev / 1024 << " megabytes exceeded" << endl;
+         BudgetHit = TRUE;
+      }
+   }
+}
+
+
+boolean MTTracer::ErrorReached( int iLev, double Lev )
+{
+   //
+   // The maximum and the percentiles are compared with Lev through
+   // the exact counts of errors above and at Lev: the k-th smallest
+   // error is <= Lev iff at least k errors are <= Lev, and it is
+   // >= Lev iff at least n-k+1 errors are >= Lev.
+   //
+
+   TIndex n = Errors.Number();
+   TIndex k;
+
+   switch( Norm )
+   {
+      case NORM_MAX: k = n; break;
+      case NORM_PCT: k = Errors.PercentileRank( Pct ); break;
+      default:       k = -1;
+   }
+
+   switch( Type )
+   {
+      case MT_REFINING:
+           if ( k < 0 ) return( TotError() <= Lev );
+           return( n - Errors.NumberAbove( iLev ) >= k );
+      case MT_COARSENING:
+           if ( k < 0 ) return( TotError() >= Lev );
+           return( n > 0 && Errors.NumberAtLeast( iLev ) >= n - k + 1 );
+      default:
+           error( "MTTracer::ErrorReached(), inconsistency detected" );
+   }
+
+   return( FALSE ); // ...to avoid warning
+}
+
+
+boolean MTTracer::LodLevelReached( int i )
+{
+   if ( Term == TERM_ERR ) return( ErrorReached( i+1, LodLev[i] ) );
+   return( nUpd >= LodLev[i] );
+}
+
+
+int MTTracer::LodReached()
+{
+   int i;
+
+   for( i=0; i<nLods; i++ )
+      if ( !LodDone[i] && LodLevelReached( i ) )
+      {
+         LodDone[i] = TRUE;
+         return( i );
+      }
+   return( -1 );
+}
+
+
+boolean MTTracer::LodPending()
+{
+   int i;
+
+   for( i=0; i<nLods; i++ )
+      if ( !LodDone[i] && LodLevelReached( i ) ) return( TRUE );
+   return( FALSE );
+}
+
+
+TIndex MTTracer::UpdatesLeft()
+{
+   TIndex Left = -1;
+   TIndex n;
+   int i;
+
+   if ( Term == TERM_NUPD )
+      Left = ( UpdLev > nUpd ? UpdLev - nUpd : 0 );
+
+   if ( Term != TERM_ERR )
+      for( i=0; i<nLods; i++ )
+      {
+         if ( LodDone[i] ) continue;
+         n = (TIndex)ceil( LodLev[i] ) - nUpd;
+         if ( n < 0 ) n = 0;
+         if ( Left < 0 || n < Left ) Left = n;
+      }
+
+   return( Left );
+}
+
+
+// -----------------------------------------------------------------------------------------
+//
+//  Checkpoints. The termination condition and the levels of detail
+//  come from the command line, which is the same when resuming.
+//
+
+void MTTracer::SaveState( RTCheckpoint C )
+{
+   int i;
+
+   C.PutInt( Type );
+   C.PutIndex( nUpd );
+   C.PutIndex( nTrg );
+   C.PutInt( nLods );
+   for( i=0; i<nLods; i++ ) C.PutInt( LodDone[i] );
+   Errors.Save( C );
+
+   #ifdef MT_NATIVE
+      Builder.SaveState( C );
+   #endif
+}
+
+
+void MTTracer::LoadState( RTCheckpoint C )
+{
+   int i;
+
+   Type = C.GetInt();
+   nUpd = C.GetIndex();
+   nTrg = C.GetIndex();
+   check( (C.GetInt() != nLods), "MTTracer::LoadState(), levels of detail changed" );
+   for( i=0; i<nLods; i++ ) LodDone[i] = C.GetInt();
+   Errors.Load( C );
+
+   #ifdef MT_NATIVE
+      Builder.LoadState( C, MT_FILE_NAME );
+   #endif
+}
+
+
 void MTTracer::UpdateError( int op, double Error )
 {
 
    switch( op )
    {
-      case ADDTRG:
-           {
-	      nTrgs++;
-	      
-	      switch( Norm )
-	      {
-	         case NORM_MAX:
-		      {
-		         Errors.Insert( Error );
-			 TotError = Errors.GetMax();
-		      }
-		      break;
-		      
-		 case NORM_MED:
-		      {
-		         if ( nTrgs == 1 )
-			   TotError = Error;
-			 else
-                           TotError = ( ( TotError * (nTrgs-1) ) + Error ) / nTrgs;
-	              }
-		      break;
-		      
-		 case NORM_SQM:
-		      {
-		         if ( nTrgs == 1 )
-			   TotError = Error * Error;
-			 else
-			 {
-		           TotError *= (nTrgs-1);
-			   TotError += ( Error * Error );
-			   TotError /= nTrgs;
-			 }
-	              }
-		      break;
-		      
-		 default:
-		    error( "MTTracer::UpdateError(), norm not implemented" );
-		    		  
-	      }
-	   }
-           break;
-      
-      case DELTRG:
-           {
-	      nTrgs--;
-	      
-	      switch( Norm )	      
-	      {
-	         case NORM_MAX:
-		      {
-		         Errors.Remove( Error );
-			 if ( Errors.IsEmpty() )
-			    TotError = 0.0;
-			 else
-			    TotError = Errors.GetMax();
-		      }
-		      break;
-		      
-		 case NORM_MED:
-		      {
-		         if ( nTrgs == 1 )
-			    TotError = Error;
-			 else			    
-		            TotError = ( ( TotError * (nTrgs+1) ) - Error ) / nTrgs;
-	              }
-		      break;
-		      
-		 case NORM_SQM:
-		      {
-		         if ( nTrgs == 1 )
-			    TotError = Error * Error;
-			 else
-			 {
-		            TotError *= (nTrgs+1);
-			    TotError -= ( Error * Error );
-			    TotError  = TotError / nTrgs;
-			 }
-	              }
-		      break;
-		      
-		 default:
-		    error( "MTTracer::UpdateError(), norm not implemented" );
-		    		  
-	      }
-	   }
-           break;
-	   
+      case ADDTRG: Errors.Insert( Error ); break;
+      case DELTRG: Errors.Remove( Error ); break;
       default:
         error( "MTTracer::UpdateError(), inconsistency detected" );
    }
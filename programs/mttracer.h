@@ -38,7 +38,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "defs.h"
 #include "ttriang.h"
-#include "tbtree.h"
+#include "errstats.h"
+#include "updlog.h"
+
+#ifdef MT_NATIVE
+#include "mtbuild.h"
+#endif
 
 #ifdef MT_TRACER
 #include "fieldmt.h"
@@ -54,11 +59,28 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define NORM_MAX    0   // maximum error among triangles
 #define NORM_MED    1   // mean error among triangles
 #define NORM_SQM    2   // squared mean error among triangles
+#define NORM_PCT    3   // percentile of the errors of triangles
  
 #define NO_TERM     0   // no termination condition... (as long as updates arrive, axecute them)
 #define TERM_NUPD   1   // termination based on number of updates
 #define TERM_ERR    2   // termination based on error
 
+// Budgets, combined with the termination conditions above (the updates
+// stop as soon as one of them is reached).
+#define TERM_TIME   3   // wall-clock seconds since the budget was set
+#define TERM_MEM    4   // resident memory, in megabytes
+#define TERM_NTRG   5   // number of triangles (at least / at most)
+
+// Time and memory are checked once every TERM_CHECK_UPDATES updates.
+#define TERM_CHECK_UPDATES 64
+
+// Max number of levels at which intermediate meshes are written.
+#define MT_MAXLODS  (ERRSTATS_MAXLEVELS - 1)
+
+#ifdef MT_NATIVE
+#define MT_FILE_NAME "output.mt"   // file written by the native MT builder
+#endif
+
 
 class MTTracer;
 
@@ -81,9 +103,7 @@ class MTTracer
        // Variables for maintaining the current triangulation error
        //
        
-       double TotError;       // current triangulation error
-       TBTree<double> Errors; // pnly used if norm = NORM_MAX       
-       int nTrgs;             // number of triangles in the current triangulation
+       TErrStats Errors;      // errors of the triangles of the current triangulation
 
        //
        // Variables for termination
@@ -91,17 +111,65 @@ class MTTracer
               
        int Term;              // TERM_NUPD or TERM_ERR
        int Norm;              // type of norm
-       int UpdLev;            // max number of updates
+       TIndex UpdLev;         // max number of updates
        double ErrLev;         // max/min error level       
-       int nUpd;              // number of updates performed so far
+       double Pct;            // percentile, if norm = NORM_PCT
+       TIndex nUpd;           // number of updates performed so far
+
+       //
+       // Budgets (0 if not set)
+       //
+
+       long TimeLev;          // max seconds since StartTime
+       double StartTime;      // seconds, set by StartClock()
+       long MemLev;           // max resident memory, in kilobytes
+       TIndex TrgLev;         // target number of triangles
+       TIndex nTrg;           // number of triangles of the current triangulation
+       boolean BudgetHit;     // time or memory budget exceeded
+
+       // Check the time and memory budgets, setting BudgetHit.
+       void CheckBudgets();
+
+       //
+       // Levels of detail: error levels (if Term = TERM_ERR, in the
+       // same norm) or numbers of updates (otherwise) at which the
+       // current triangulation is written, and which of them have
+       // been reached so far.
+       //
+
+       int nLods;
+       double LodLev[MT_MAXLODS];
+       boolean LodDone[MT_MAXLODS];
+
+       // Check if the error of the triangulation has reached the iLev-th
+       // threshold of Errors, of value Lev.
+       boolean ErrorReached( int iLev, double Lev );
+
+       // Check if the i-th level of detail has been reached (returned
+       // before or not).
+       boolean LodLevelReached( int i );
+
+#ifdef MT_NATIVE
+       TMTBuilder Builder;    // native MT builder
+#endif
+
+       // Log of the updates, for undo / redo (NULL if not recorded).
+       PTUpdateLog Log;
       
    public:
    
        MTTracer(void);
        
        // Set termination contition.
-       void SetTerminateCondition( int, int ); // terminazione per numero update
-       void SetTerminateCondition( int, int, double ); // terminazione per livello di errore
+       void SetTerminateCondition( int, TIndex ); // terminazione per numero update, o budget
+       void SetTerminateCondition( int, int, double, double = 100.0 ); // terminazione per livello di errore
+
+       // Set the levels of detail (after the termination condition).
+       void SetLodLevels( int, double * );
+
+       // Start the clock of the time budget (when the updates begin,
+       // after the input is read).
+       void StartClock();
        
        void StartHistory( int );
       
@@ -112,18 +180,55 @@ class MTTracer
        // Record in MT History Tracer the deletion of a triangle.
        void KillTriangle( PTTriangle );
       
+       // Record the insertion / deletion of a constraint (CDT only;
+       // needed just by the update log).
+       void MakeConstraint( PTEdge E ) { if ( Log ) Log->MakeConstraint( E ); };
+       void KillConstraint( PTEdge E ) { if ( Log ) Log->KillConstraint( E ); };
+
        // Communicate to MT History Tracer that the update step is done
        // and the triangulation is in consistent state.
        void MeshOk();
       
        void EndHistory();
+
+       // Record also the triangles and constraints created and killed
+       // in L, from now on; it must be set before the initial
+       // triangulation is built.
+       void SetUpdateLog( PTUpdateLog L ) { Log = L; };
+       boolean LogsUpdates() { return( Log != NULL ); };
       
        // Update the triangulation error after the deletion or insertion 
        // of a triangle.
        void UpdateError( int, double );
        
+       // Current triangulation error, in the norm of the termination
+       // condition.
+       double TotError();
+
        // Check if the termination condition is satisfied.
        boolean TerminateCondition();
+
+       // Return the index of a level of detail reached by the current
+       // triangulation and not returned before, -1 if none.
+       int LodReached();
+
+       // TRUE if LodReached() would return some level of detail.
+       boolean LodPending();
+
+       // Number of updates still allowed by a termination on the number
+       // of updates, or before the next level of detail given as a
+       // number of updates; -1 if there is no such bound.
+       TIndex UpdatesLeft();
+
+       // Write / read the history on / from a checkpoint, between
+       // two updates.
+       void SaveState( RTCheckpoint C );
+       void LoadState( RTCheckpoint C );
+
+#ifdef MT_NATIVE
+       // Description stored in the MT file (e.g., the command line).
+       void MT_SetDescription( char *Desc ) { Builder.SetDescription( Desc ); };
+#endif
        
 };
 
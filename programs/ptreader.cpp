@@ -0,0 +1,272 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : ptreader.cpp
+//
+//   Implementation of class TPointReader, reading the input points
+//   in chunks through a separate thread.
+//
+
+#include "defs.h"
+
+#ifdef PIPELINED_INPUT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <pthread.h>
+
+#include "error.h"
+#include "ptreader.h"
+
+
+// -----------------------------------------------------------------
+//
+//  TPointReader::TPointReader( const char *infname )
+//
+
+TPointReader::TPointReader( const char *infname )
+{
+   int i;
+   double n;
+
+   inFile = fopen( infname, "r" );
+   check( (inFile == NULL), "TPointReader::TPointReader(), cannot open input file");
+
+   BufPos = BufLen = 0;
+
+   //
+   // read number of points (before starting the thread, the caller
+   // needs it for allocating its arrays)
+   //
+
+   check( !ReadNumber( n ), "TPointReader::TPointReader(), cannot read number of points");
+   nPts = (int) n;
+   nParsed = 0;
+
+   for ( i=0; i<READ_NCHUNKS; i++ )
+   {
+      Chunk[i] = new double[3*READ_CHUNK];
+      check( (Chunk[i] == NULL), "TPointReader::TPointReader(), insufficient memory");
+      ChunkLen[i] = 0;
+   }
+   Head = Tail = nFull = 0;
+   Done = FALSE;
+
+   pthread_mutex_init( &Lock, NULL );
+   pthread_cond_init( &NotFull, NULL );
+   pthread_cond_init( &NotEmpty, NULL );
+
+   check( (pthread_create( &Thread, NULL, ProducerMain, this ) != 0),
+          "TPointReader::TPointReader(), cannot create reader thread");
+}
+
+
+// -----------------------------------------------------------------
+//
+//  TPointReader::~TPointReader()
+//
+//  If the consumer stops before the end, the reader thread may be
+//  waiting for a free buffer: release all buffers so that it can
+//  terminate.
+//
+
+TPointReader::~TPointReader()
+{
+   int i;
+
+   pthread_mutex_lock( &Lock );
+   while ( !Done )
+   {
+      nFull = 0;
+      pthread_cond_signal( &NotFull );
+      pthread_cond_wait( &NotEmpty, &Lock );
+   }
+   pthread_mutex_unlock( &Lock );
+
+   pthread_join( Thread, NULL );
+
+   pthread_cond_destroy( &NotEmpty );
+   pthread_cond_destroy( &NotFull );
+   pthread_mutex_destroy( &Lock );
+
+   for ( i=0; i<READ_NCHUNKS; i++ )
+      delete[] Chunk[i];
+
+   fclose( inFile );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  int TPointReader::NextChar()
+//
+
+int TPointReader::NextChar()
+{
+   if ( BufPos >= BufLen )
+   {
+      BufLen = fread( Buf, 1, READ_BUFSIZE, inFile );
+      BufPos = 0;
+      if ( BufLen <= 0 ) return( EOF );
+   }
+   return( (unsigned char) Buf[BufPos++] );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  boolean TPointReader::ReadNumber( double &val )
+//
+//  Skip blanks, collect the characters of the next token and convert
+//  it with strtod (so that the result is the same as that of
+//  operator>> on streams).
+//
+
+boolean TPointReader::ReadNumber( double &val )
+{
+   char tok[64];
+   char *end;
+   int c, len = 0;
+
+   do c = NextChar(); while ( c != EOF && isspace(c) );
+
+   while ( c != EOF && !isspace(c) )
+   {
+      if ( len < 63 ) tok[len++] = (char) c;
+      c = NextChar();
+   }
+   tok[len] = '\0';
+
+   if ( len == 0 ) return( FALSE );
+
+   val = strtod( tok, &end );
+   return( *end == '\0' );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  void TPointReader::Produce()
+//
+//  Fill the buffers of the ring with the coordinates of the points,
+//  until nPts points have been read or the file ends.
+//
+
+void TPointReader::Produce()
+{
+   double *xyz;
+   int n;
+   boolean ok = TRUE;
+
+   while ( ok && nParsed < nPts )
+   {
+      //
+      // wait for a free buffer
+      //
+
+      pthread_mutex_lock( &Lock );
+      while ( nFull == READ_NCHUNKS )
+         pthread_cond_wait( &NotFull, &Lock );
+      pthread_mutex_unlock( &Lock );
+
+      //
+      // parse the points into it (the buffer is not accessed by the
+      // consumer until it is counted in nFull)
+      //
+
+      xyz = Chunk[Head];
+      for ( n=0; n<READ_CHUNK && nParsed<nPts && ok; n++, nParsed++ )
+      {
+         ok = ReadNumber( xyz[0] ) && ReadNumber( xyz[1] ) && ReadNumber( xyz[2] );
+         xyz += 3;
+      }
+      if ( !ok ) n--;
+
+      pthread_mutex_lock( &Lock );
+      ChunkLen[Head] = n;
+      Head = (Head+1) % READ_NCHUNKS;
+      nFull++;
+      pthread_cond_signal( &NotEmpty );
+      pthread_mutex_unlock( &Lock );
+   }
+
+   pthread_mutex_lock( &Lock );
+   Done = TRUE;
+   pthread_cond_signal( &NotEmpty );
+   pthread_mutex_unlock( &Lock );
+}
+
+
+void *TPointReader::ProducerMain( void *reader )
+{
+   ((PTPointReader) reader)->Produce();
+   return( NULL );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  int TPointReader::NextChunk( double *&xyz )
+//
+
+int TPointReader::NextChunk( double *&xyz )
+{
+   int n;
+
+   pthread_mutex_lock( &Lock );
+   while ( nFull == 0 && !Done )
+      pthread_cond_wait( &NotEmpty, &Lock );
+
+   if ( nFull == 0 )
+   {
+      // reader thread finished and all buffers consumed
+      pthread_mutex_unlock( &Lock );
+      xyz = NULL;
+      return( 0 );
+   }
+
+   xyz = Chunk[Tail];
+   n = ChunkLen[Tail];
+   pthread_mutex_unlock( &Lock );
+
+   return( n );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  void TPointReader::ReleaseChunk()
+//
+
+void TPointReader::ReleaseChunk()
+{
+   pthread_mutex_lock( &Lock );
+   Tail = (Tail+1) % READ_NCHUNKS;
+   nFull--;
+   pthread_cond_signal( &NotFull );
+   pthread_mutex_unlock( &Lock );
+}
+
+#endif // PIPELINED_INPUT
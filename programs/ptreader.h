@@ -0,0 +1,131 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : ptreader.h
+//
+//   Definition of class TPointReader, for reading the input points
+//   in chunks through a separate thread (compiled only if macro
+//   PIPELINED_INPUT is defined in defs.h).
+//
+//   The reader thread parses the input file and fills a small ring of
+//   buffers, each containing the coordinates (x,y,z) of at most
+//   READ_CHUNK points. Meanwhile, the thread that owns the triangulation
+//   takes the filled buffers, creates the points and processes them,
+//   in such a way that parsing the input overlaps with the work done
+//   on the points already read.
+//
+
+
+#ifndef _PTREADER_H
+#define _PTREADER_H
+
+#include "defs.h"
+
+#ifdef PIPELINED_INPUT
+
+#include <stdio.h>
+#include <pthread.h>
+
+
+// Number of points in each buffer, and number of buffers in the ring.
+const int READ_CHUNK   = 4096;
+const int READ_NCHUNKS = 4;
+
+// Size of the buffer used for reading the input file.
+const int READ_BUFSIZE = 65536;
+
+
+// ----------------------------------------------------------------------
+//
+//  class TPointReader
+//
+
+
+class TPointReader
+{
+   private:
+
+      // input file, and the buffer from which numbers are parsed
+      FILE *inFile;
+      char Buf[READ_BUFSIZE];
+      int  BufPos, BufLen;
+
+      // number of points declared in the header of the file, and
+      // number of points parsed so far by the reader thread
+      TIndex nPts;
+      TIndex nParsed;
+
+      // ring of buffers: ChunkLen[i] is the number of points in
+      // Chunk[i]; Head is the next buffer to be filled by the reader
+      // thread, Tail the next one to be taken by the consumer, nFull
+      // the number of buffers filled and not yet released
+      double *Chunk[READ_NCHUNKS];
+      int ChunkLen[READ_NCHUNKS];
+      int Head, Tail, nFull;
+
+      // TRUE when the reader thread has finished
+      boolean Done;
+
+      pthread_t       Thread;
+      pthread_mutex_t Lock;
+      pthread_cond_t  NotFull, NotEmpty;
+
+      // Next character of the input file, EOF at end of file.
+      int NextChar();
+
+      // Read the next number from the input file. Return FALSE at
+      // end of file, or if the next token is not a number.
+      boolean ReadNumber( double & );
+
+      // Body of the reader thread.
+      void Produce();
+      static void *ProducerMain( void * );
+
+   public:
+
+      // Open the file, read the number of points and start the
+      // reader thread.
+      TPointReader( const char *infname );
+
+      // Wait for the reader thread and close the file.
+      ~TPointReader();
+
+      // Number of points declared in the input file.
+      TIndex NumPoints() { return( nPts ); };
+
+      // Wait until a buffer has been filled, let xyz point to its
+      // coordinates and return its number of points. Return 0 when
+      // all points have been read (or the file ended prematurely).
+      int NextChunk( double *&xyz );
+
+      // Give back to the reader thread the buffer obtained by the
+      // last call to NextChunk().
+      void ReleaseChunk();
+};
+
+typedef class TPointReader *PTPointReader;
+
+#endif // PIPELINED_INPUT
+
+#endif // _PTREADER_H
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <stdlib.h>
 #include "refCDT.h"
 #include "geom.h"
+#include "reorder.h"
 
 
 #ifdef OUTPUT
@@ -47,6 +48,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // lies on it and if it does not intersect other constraints).
 // Therefore, check for admissibility of a constraint segment and, if it
 // is admissible, insert it.
+// Constraints have already been checked for invalid vertices by
+// PrepareToEnd. Repeated constraints are removed first, and, if
+// ReorderMode is set, the others are sorted along the same curve used
+// for the points, so that consecutive insertions modify close parts
+// of the triangulation.
+// The check is done also if the input has been cleaned (CleanTol >= 0):
+// the points added at the crossings are rounded, and the triangulation
+// may not see exactly the same crossings as the cleaning.
 //
 
 void TRefCDT :: Add_Constrain()
@@ -55,61 +64,54 @@ void TRefCDT :: Add_Constrain()
       DEBUG14 << "\n\nTRefCDT::Add_Constrain()\n";
    #endif
 
-   int i;
+   TIndex i, n;
+   PTVertex v0, v1;
 
-   nConstr *= 2; 
+   n = Reorder::SortSegments( constr_array, nConstr, Points, ReorderMode );
 
-   for (i=0; i<nConstr; i += 2)
+   #ifdef OUTPUT
+      if ( n < nConstr )
+         cerr << nConstr - n << " repeated constraints removed" << endl;
+   #endif
+
+   for (i=0; i<n; i++)
    {
+      v0 = (PTVertex) Points[constr_array[2*i]];
+      v1 = (PTVertex) Points[constr_array[2*i+1]];
+
       #ifdef DEBUG14
          cerr << "TRefCDT::Add_Constrain() : constraint insertion loop:" << endl
-              << "insert constraint C" << i/2 << "( " <<  constr_array[i] << ", "<< constr_array[i+1]
-              << " ) = ( " << * (PTVertex) Points[constr_array[i]] << ", "
-              <<  * (PTVertex) Points[constr_array[i+1]] << " )\n";
+              << "insert constraint C" << i << "( " <<  constr_array[2*i] << ", "<< constr_array[2*i+1]
+              << " ) = ( " << *v0 << ", " << *v1 << " )\n";
          Pause("");
       #endif
-                 
-      if (constr_array[i] == constr_array[i+1])
-      {
-         cerr << "Warning: constraint C" << i/2 << "( " << constr_array[i] << ", "<< constr_array[i+1] 
-              << " ) is degenerate: not inserted\n";
-         continue;
-      }
-
-      if ( constr_array[i] < 0   || constr_array[i] >= nPts   ||
-           constr_array[i+1] < 0 || constr_array[i+1] >= nPts    )
-      {
-         cerr << "Warning: constraint C" << i/2 << "( " << constr_array[i] << ", "<< constr_array[i+1] 
-              << " ) has non-existing vertices " << "( nPts = " << nPts << " ) : not inserted\n";
-         continue;
-      }
 
       #ifdef PAOLO
-         cerr << "\n\n\n\n INSERT CONSTRAINT " << i/2 << " :  " << constr_array[i] << " "<< *((PTVertex)Points[constr_array[i]]);
-         cerr << "    " << constr_array[i+1] <<" "<< *((PTVertex)Points[constr_array[i+1]]);
+         cerr << "\n\n\n\n INSERT CONSTRAINT " << i << " :  " << constr_array[2*i] << " "<< *v0;
+         cerr << "    " << constr_array[2*i+1] <<" "<< *v1;
       #endif
 
       // check for admissibility of current constraint
 
-      if( IsEdgeAdmissible( (PTVertex) Points[constr_array[i]], (PTVertex) Points[constr_array[i+1]] ) )
+      if( IsEdgeAdmissible( v0, v1 ) )
       {
-         TTra_Add_Constraint( (PTVertex) Points[constr_array[i]], (PTVertex) Points[constr_array[i+1]] );
+         TTra_Add_Constraint( v0, v1 );
 
          #ifdef DEBUG
-            DEBUG << "constraint inserted: ( " << Input_Constraints[i] << ", "
-                  << Input_Constraints[i+1] << " )\n";
+            DEBUG << "constraint inserted: ( " << constr_array[2*i] << ", "
+                  << constr_array[2*i+1] << " )\n";
          #endif
       }
       else
       {
-         cerr << "\nConstraint ( " << *((PTVertex)Points[constr_array[i]])
-              << "cannot be inserted, " << *((PTVertex)Points[constr_array[i+1]]) << " ) because not admisible\n";
+         cerr << "\nConstraint ( " << *v0
+              << "cannot be inserted, " << *v1 << " ) because not admisible\n";
       }
-//      if ( i % 1000 == 0 ) cerr << "\rread " << i << " constraints" << flush;  
-      cerr << "\rread " << i << " constraints" << flush;  
+      if ( i % 1000 == 0 ) cerr << "\rinserted " << i << " constraints" << flush;  
    }  // endfor
+   cerr << "\rinserted " << n << " constraints" << endl;
    
-   nConstr /= 2;
+   nConstr = n;
 }
 
 
@@ -190,6 +192,7 @@ void TRefCDT::Delete_Constr_InfluenceRegion( PTEdge newConstr )
    //
    
    if ( ! TDecimDelaunay::InitialPhase ) MT_AddComponent();
+   else NewTrgs.Clear();
 
 
    //
@@ -231,15 +234,31 @@ void TRefCDT::Delete_Constr_InfluenceRegion( PTEdge newConstr )
 
 void TRefCDT :: InitialTriangulation()
 {
-    
-    register int i;
-
     #ifdef PAOLO
        cerr << "TRefCDT::InitialTriangulation()" << endl;
     #endif 
    
     TRefineDelaunay::InitialPhase = TRUE;
 
+    TriangulateHull();
+
+    MT_Initial();
+    
+    TRefineDelaunay::InitialPhase = FALSE;
+}
+
+
+//
+// Compute the convex hull of the input points and triangulate it (first
+// part of InitialTriangulation). On exit, the vertices of the convex
+// hull are in positions [0...nChPts-1] of array Points, and iNextPoint
+// is nChPts.
+//
+
+void TRefCDT :: TriangulateHull()
+{
+    register TIndex i;
+
 
     //
     // compute convex hull of set of input points
@@ -270,7 +289,7 @@ void TRefCDT :: InitialTriangulation()
    // counterclockwise order.
    //
 
-   int ip2 = 2;
+   TIndex ip2 = 2;
 
    while( Geom::Alignedxy( Points[0], Points[1], Points[ip2] ) )
    {
@@ -428,11 +447,6 @@ void TRefCDT :: InitialTriangulation()
     #ifdef OUTPUT
       cout << "\ntriangulation of convex hull completed" << endl;
     #endif    
-
-    MT_Initial();
-    
-    TRefineDelaunay::InitialPhase = FALSE;
- 
 }
 
 
@@ -487,7 +501,7 @@ void TRefCDT :: NextPoint()
 
 void TRefCDT :: ReadData( const char *infname )
 {
-   register int i;
+   register TIndex i;
 
    #ifdef DEBUG
     DEBUG << "\nTRefCDT::ReadData()" << endl;
@@ -511,12 +525,10 @@ void TRefCDT :: ReadData( const char *infname )
    // read input points and store them in array Points
    //
    
-   OrderInitial = new int[nPts];
    Points = new PTPoint[nPts];
    check( (Points == NULL), "TRefCDT::ReadData(), insufficient memory for Points");
-   check( (OrderInitial == NULL), "TRefCDT::ReadData(), insufficient memory for OrderInitial");
    
-   int ip = 0;
+   TIndex ip = 0;
    PTPoint p = NULL;
    
    
@@ -561,8 +573,8 @@ void TRefCDT :: ReadData( const char *infname )
 
    if (nConstr>0)
    {
-     int count=0;
-     constr_array = new int[nConstr*2];
+     TIndex count=0;
+     constr_array = new TIndex[nConstr*2];
      check( (constr_array == NULL), "TBuildDelaunay::ReadData(), insufficient memory for constr_array");
 
      nConstr *= 2;
@@ -582,7 +594,24 @@ void TRefCDT :: ReadData( const char *infname )
    }
       
    inFile.close();
-   
+
+   //
+   // clean points and constraints: snapped points are deleted and
+   // points are added at crossings, so nPts may change
+   //
+
+   if ( CleanTol >= 0.0 && nConstr > 0 )
+   {
+      TSegCleanStats St;
+
+      nConstr = SegClean::Clean( Points, nPts, constr_array, nConstr, CleanTol, St );
+      check( (nPts < 3), "input with less than 3 points" );
+      St.Print( cerr );
+      cerr << "clean input: " << nPts << " points, " << nConstr << " constraints" << endl;
+   }
+
+   OrderInitial = new TIndex[nPts];
+   check( (OrderInitial == NULL), "TRefCDT::ReadData(), insufficient memory for OrderInitial");
 }
 
 
@@ -590,6 +619,7 @@ void TRefCDT :: ReadData( const char *infname )
 void TRefCDT :: BuildTriangulation( const char *infname, const char *outfname )
 {
    ReadData( infname );
+   StartBudgets();
 
 #ifdef OUTPUT
    long starttime = time(NULL);
@@ -636,19 +666,38 @@ void TRefCDT :: BuildTriangulation( const char *infname, const char *outfname )
 void TRefCDT :: PrepareToEnd()
 {
    //
-   // update constraints to be inserted with the new order of points
+   // update constraints to be inserted with the new order of points,
+   // discarding the degenerate ones and those with non-existing
+   // vertices
    //
 
-   int num_pairs = 2*nConstr;
-   int * aux_array = (int *) malloc (num_pairs*sizeof(int));
-   int i;
+   TIndex i, n;
+
+   n = 0;
+   for (i=0; i<nConstr; i++)
+   {
+      if (constr_array[2*i] == constr_array[2*i+1])
+      {
+         cerr << "Warning: constraint C" << i << "( " << constr_array[2*i] << ", "<< constr_array[2*i+1] 
+              << " ) is degenerate: not inserted\n";
+         continue;
+      }
+
+      if ( constr_array[2*i] < 0   || constr_array[2*i] >= nPts   ||
+           constr_array[2*i+1] < 0 || constr_array[2*i+1] >= nPts    )
+      {
+         cerr << "Warning: constraint C" << i << "( " << constr_array[2*i] << ", "<< constr_array[2*i+1] 
+              << " ) has non-existing vertices " << "( nPts = " << nPts << " ) : not inserted\n";
+         continue;
+      }
 
-   for (i=0; i<num_pairs; i++)
-      aux_array[i] = OrderInitial[constr_array[i]];
-   for (i=0; i<num_pairs; i++)
-      constr_array[i] = aux_array[i];
-   delete(aux_array);
-   delete(OrderInitial);
+      constr_array[2*n]   = OrderInitial[constr_array[2*i]];
+      constr_array[2*n+1] = OrderInitial[constr_array[2*i+1]];
+      n++;
+   }
+   nConstr = n;
+   delete[] OrderInitial;
+   OrderInitial = NULL;
 
    //
    // insert constraints
@@ -663,8 +712,8 @@ void TRefCDT::WriteData( const char *outfname )
    TDecCDT::WriteData(outfname);
 }
 
-void TRefCDT ::ConvertData(int *vNum, int *tNum, int *eNum,
-                           float **vData, int **tData, int **eData)
+void TRefCDT ::ConvertData(TIndex *vNum, TIndex *tNum, TIndex *eNum,
+                           float **vData, TIndex **tData, TIndex **eData)
 {
    TDecCDT::ConvertData(vNum,tNum,eNum,vData,tData,eData);
 }
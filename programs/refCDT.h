@@ -31,6 +31,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "utils.h"
 #include "refdel.h"
 #include "decCDT.h"
+#include "segclean.h"
 
 
 class TRefCDT;
@@ -45,10 +46,15 @@ class TRefCDT : public TRefineDelaunay, public TDecCDT
       // Array of input constraints
       // Used for CDT refinement. It contains pairs of point indices
       // in array Points.
-      int *constr_array;
+      TIndex *constr_array;
 
       // Number of input constraints
-      int nConstr;
+      TIndex nConstr;
+
+      // Snapping tolerance of the cleaning of the input (class
+      // SegClean), -1 if the input is not cleaned. Clean constraints
+      // are inserted without checking if they are admissible.
+      double CleanTol;
 
 /**********************                   *********************************/
 
@@ -67,12 +73,14 @@ class TRefCDT : public TRefineDelaunay, public TDecCDT
       // Redefine ttriangulation::WriteData to write constraints
       virtual void WriteData( const char * outfname );
       // Redefine ttriangulation::ConvertData to convert constraints
-      virtual void ConvertData(int *vNum, int *tNum, int *eNum,
-                               float **vData, int **tData, int **eData);
+      virtual void ConvertData(TIndex *vNum, TIndex *tNum, TIndex *eNum,
+                               float **vData, TIndex **tData, TIndex **eData);
                     
       // Redefined to remove ambiguity
       // (functions inherited from both parent classes)
       virtual boolean NoMoreUpdates() { return TRefineDelaunay::NoMoreUpdates(); }
+      virtual int NextLevel() { return TRefineDelaunay::NextLevel(); }
+      virtual void StartBudgets() { TRefineDelaunay::StartBudgets(); }
       virtual void UpdateStep() { TRefineDelaunay::UpdateStep(); }
       virtual void AddTriangle( PTTriangle T ) { TRefineDelaunay::AddTriangle( T ); }
       virtual void DetachEdge( PTEdge E ) { TRefineDelaunay::DetachEdge( E ); }
@@ -82,6 +90,13 @@ class TRefCDT : public TRefineDelaunay, public TDecCDT
       virtual void MT_AddComponent() { TRefineDelaunay::MT_AddComponent(); }
       virtual void MT_Initial() { TRefineDelaunay::MT_Initial(); }
 
+      // BuildTriangulation() is redefined without checkpoints, which
+      // would need the state of both parent classes
+      virtual void SaveState( RTCheckpoint )
+        { error( "TRefCDT::SaveState(), checkpoints not supported" ); }
+      virtual void LoadState( RTCheckpoint )
+        { error( "TRefCDT::LoadState(), checkpoints not supported" ); }
+
 
 
 
@@ -91,6 +106,10 @@ class TRefCDT : public TRefineDelaunay, public TDecCDT
       
       virtual void PrepareToEnd();
 
+      // First part of InitialTriangulation: triangulation of the
+      // convex hull, without calling MT_Initial().
+      void TriangulateHull();
+
    public:
   
        TRefCDT( PMTTracer iMT ) : TRefineDelaunay( iMT ), TDelaunayBase(),
@@ -101,7 +120,12 @@ class TRefCDT : public TRefineDelaunay, public TDecCDT
   	    #endif
 	    constr_array = NULL;
             nConstr = 0;
+            CleanTol = -1.0;
        };
+
+       // Clean points and constraints after reading them, with
+       // snapping tolerance Tol (0 = only coincident points).
+       void SetCleanInput( double Tol ) { CleanTol = Tol; };
 };
 
 #endif // _REFCDT_H
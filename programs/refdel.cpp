@@ -95,7 +95,7 @@ TRefineDelaunay::TRefineDelaunay( PMTTracer iMT ) : TBuildDelaunay(), DetachedPo
 void TRefineDelaunay::InitialTriangulation()
 {
 
-    int i;
+    TIndex i;
 
     #ifdef DEBUG
       DEBUG << "TRefineDelaunay::InitialTriangulation()" << endl;
@@ -171,217 +171,205 @@ void TRefineDelaunay::InitialTriangulation()
 }
 
 
+// -------------------------------------------------------------------------
+//
+//   void TRefineDelaunay::SaveState( RTCheckpoint C )
+//   void TRefineDelaunay::LoadState( RTCheckpoint C )
+//
+//   A checkpoint is taken after the initial triangulation, which is not
+//   built again when resuming: the candidates for the convex hull are
+//   discarded as at the end of InitialTriangulation().
+//
+
+void TRefineDelaunay::SaveState( RTCheckpoint C )
+{
+    TTriangulation::SaveState( C );
+    C.PutIndex( nChPts );
+    MT->SaveState( C );
+}
+
+
+void TRefineDelaunay::LoadState( RTCheckpoint C )
+{
+    TTriangulation::LoadState( C );
+    nChPts = C.GetIndex();
+    MT->LoadState( C );
+    InitialPhase = FALSE;
+
+    if ( HullCand != NULL )
+    {
+       delete[] HullCand;
+       HullCand = NULL;
+    }
+}
+
+
+
+// -------------------------------------------------------------------------
+//
+//   static int HullCompare( const void *, const void * )
+//
+//   Comparison function for qsort: lexicographic order on (x,y) of
+//   two pointers to points.
+//
+
+static int HullCompare( const void *a, const void *b )
+{
+   PTPoint p = *(PTPoint *)a;
+   PTPoint q = *(PTPoint *)b;
+
+   if ( p->x < q->x ) return( -1 );
+   if ( p->x > q->x ) return( 1 );
+   if ( p->y < q->y ) return( -1 );
+   if ( p->y > q->y ) return( 1 );
+   return( 0 );
+}
+
 
 // -------------------------------------------------------------------------
 //
 //   void TRefineDelaunay::CalcConvexHull()
 //
-//   Compute convex hull of input points by using Graham's algorithm.
+//   Compute convex hull of input points. First discard the points
+//   strictly inside the polygon of the extreme points in eight
+//   directions (Akl-Toussaint heuristic), then apply Andrew's monotone
+//   chain algorithm to the remaining candidates, sorted by x and y.
+//   Only the candidates are sorted, and they are usually very few.
 //
 //   INPUT: array Points
 //
 //   OUTPUT: array Points is re-ordered in such a way that, if there are
 //   nChPts = N points on the convex hull, then the first N positions
-//   contain such points, while the other positions contain the remaining
-//   points.
+//   contain such points, in counterclockwise order starting from the
+//   point of max x (if not unique, of max y among them), while the other
+//   positions contain the remaining points. Points lying on an edge of
+//   the hull are not considered as hull points.
 //
 
 void TRefineDelaunay::CalcConvexHull()
 {
     
-    int i;
+    TIndex i;
+    int k;
 
     #ifdef DEBUG
       DEBUG << "TRefineDelaunay::CalcConvexHull()" << endl;
     #endif
 
     //
-    // sort points in Points in counterclockwise order w.r.t. a point
-    // internal to the set (the baricenter of the first three
-    // non-aligned points).
+    // compute the extreme points, unless this has been done while
+    // reading the input
     //
-    
-    GrahamSortPoints();
+
+    if ( HullCand == NULL )
+    {
+       for ( k=0; k<8; k++ ) ExtPts[k] = Points[0];
+       for ( i=1; i<nPts; i++ ) UpdateExtremes( Points[i] );
+    }
 
     //
-    // search the point with maximum x coordinate (if not unique, 
-    // the point of maximum y coordinate among them), that will be
-    // the starting point for Graham's scan.
+    // move the candidates, i.e., the points not strictly inside the 
+    // polygon of the extreme points, to the first nCand positions
+    // of Points
     //
 
-    // index of point of max x
-    int iMaxX = 0;
-
-    // to compare x values
-    double xi, yi, maxxi, maxyi;
+    TIndex nCand = 0;
+    PTPoint pTmp;
 
     for( i=0; i<nPts; i++ )
     {
+       if ( ( HullCand == NULL || HullCand[ Points[i]->PID ] ) &&
+            !InsideExtremes( Points[i] ) )
+       {
+          pTmp = Points[nCand];
+          Points[nCand++] = Points[i];
+          Points[i] = pTmp;
+       }
+    }
 
-        xi = Points[i]->x;
-        yi = Points[i]->y;
-
-        maxxi = Points[iMaxX]->x;
-        maxyi = Points[iMaxX]->y;
-
+    if ( HullCand != NULL )
+    {
+       delete[] HullCand;
+       HullCand = NULL;
+    }
 
-        //
-        // index of point of max x (if not unique, of max y)
-        //
+    #ifdef DEBUG
+       DEBUG << nCand << " candidate points for the convex hull" << endl;
+    #endif
 
-        if ( (xi > maxxi) || ( (xi == maxxi) && (yi > maxyi) ) )
-           iMaxX = i;
+    //
+    // sort the candidates by x (by y if x is equal)
+    //
 
-    }
+    qsort( Points, nCand, sizeof(PTPoint), HullCompare );
 
     //
-    // Use two temporary arrays, ChNext and ChPrev, to maintain the links
-    // to a circular double list of points on the current hull.
-    // The initial hull contains all points in the counterclockwise
-    // order computed at the beginning.
+    // Andrew's monotone chain: Hull[] contains the indices in Points of
+    // the lower hull, from Points[0] to Points[nCand-1], followed by the
+    // upper hull, back to Points[0]. A point is popped as soon as it does
+    // not form a left turn with the previous one and the new one, thus
+    // aligned points are discarded.
     //
 
-    int *ChNext = new int[nPts],
-        *ChPrev = new int[nPts];
-	
-    check( (ChNext == NULL || ChPrev == NULL),
+    TIndex *Hull = new TIndex[2*nCand+1];
+    check( (Hull == NULL),
     	   "TRefineDelaunay::CalcConvexHull(), insufficient memory");	   
 
+    TIndex nh = 0, nLower;
 
-    for ( i=0; i<nPts; i++ )
+    for ( i=0; i<nCand; i++ )
     {
-       ChPrev[i] = i-1;
-       ChNext[i] = i+1;
+       while ( nh >= 2 &&
+               Geom::Turnxy( Points[Hull[nh-2]], Points[Hull[nh-1]], Points[i] ) != TURN_LEFT )
+          nh--;
+       Hull[nh++] = i;
     }
 
-    // close circle
+    // Points[Hull[nLower-1]] = Points[nCand-1] is the point of max x 
+    // (of max y among them)
+    nLower = nh;
 
-    ChPrev[ 0 ] = nPts-1;
-    ChNext[ nPts-1 ] = 0;
-
-
-    nChPts = nPts;
-    // number of points on the hull
-
-
-    //
-    // Main loop of Graham's scan
-    //
-
-    int ic = iMaxX, icNext, icNext2;
-
-    boolean complete = FALSE;
-         
-    do
+    for ( i=nCand-2; i>=0; i-- )
     {
+       while ( nh > nLower &&
+               Geom::Turnxy( Points[Hull[nh-2]], Points[Hull[nh-1]], Points[i] ) != TURN_LEFT )
+          nh--;
+       Hull[nh++] = i;
+    }
 
+    // the last index is again 0, the first point
+    nChPts = nh-1;
 
-       icNext  = ChNext[ic];
-       icNext2 = ChNext[icNext];
-
-       //
-       // the following test rejects vertices that are on the hull but 
-       // are endpoints of two aligned edges
-       //
-        
-       if ( Geom::Turnxy( Points[ic], Points[icNext], Points[icNext2] ) != TURN_LEFT )
-       {
-    
-          //
-          // Points[icNext] does not belong to the hull, remove it from
-          // circular list ChPoints
-          //
-
-          ChNext[ic] = icNext2;
-          ChPrev[icNext2] = ic;
-
-          ChPrev[icNext] = ChNext[icNext] = -1;
-	  // -1 means that the point is no longer on the hull
-
-	  nChPts--;
-          // one less point on the hull
-
-          //
-          // resume scan from point preceding ic. If ic = iMaxX
-	  // since we know that Points[iMaxX] is certainly on the hull,
-	  // it is not needed to step backward
-          //
-
-          if (ic != iMaxX) ic = ChPrev[ic];
-
-       }
-
-       else // ok, go to next step
-       {
-          ic = ChNext[ic];
-	  if ( ic == iMaxX ) complete = TRUE;
-       }
-
-
-    } while( !complete );
-
+    check( (nChPts < 3), "TRefineDelaunay::CalcConvexHull(), all points are aligned");
 
     //
-    // Now the points of the convex hull are all in the circular list
-    // represented by the links in ChNext[], starting from index iMaxX. 
-    // The remaining points are those with ChNext[i] = -1. 
-    // Now we sort Points, in such a way that, if the points on the 
-    // convex hull are N, then the pointers to them are in the first
-    // N positions of Points, and the pointers to the remaining points are
-    // in the following positions. We do all this in O( nPts ) time.
-    // We use a new auxiliary array, PointsAux, that will replace Points.
+    // Now rearrange the first nCand positions of Points: the hull points,
+    // in counterclockwise order starting from Points[Hull[nLower-1]],
+    // followed by the other candidates. The points that were not
+    // candidates are already in the remaining positions.
     //
 
-    delete( ChPrev ); ChPrev = NULL; // no longer needed
-
-
-#ifndef PAOLO
-
-    register PTPoint PointsAux;
-    int iCh = 0;    // positions for the hull 0...nChPts-1
-    int iNoCh = 0;  // for the other points nChPts...nPts-1
-
-    for(;;iNoCh++)
-    {
-      for( ; ChNext[iNoCh]!=-1; iNoCh++ );  // find 1st point not on CH
-      if ( iNoCh >= nChPts )  break;        // all points ok, exit loop
-      for( iCh = iNoCh+1; ChNext[iCh]==-1 && iCh<nPts; iCh++ ); 
-                                            // find first point on CH
-      if ( iCh >= nPts )  break;            // no more points, exit loop
-      PointsAux     = Points[iCh];
-      Points[iCh]   = Points[iNoCh];
-      Points[iNoCh] = PointsAux;
-      ChNext[iCh]   = -1;
-    }
-#else
-    PTPoint *PointsAux = new PTPoint[nPts];
-
-    check( (PointsAux == NULL),
-	"TRefineDelaunay::CalcConvexHull(), insufficient memory" );
-
+    PTPoint *PointsAux = new PTPoint[nCand];
+    char *OnHull = new char[nCand];
+    check( (PointsAux == NULL || OnHull == NULL),
+    	   "TRefineDelaunay::CalcConvexHull(), insufficient memory");	   
 
-    int iCh    = 0;     // posizions for convex hull 0...nChPts-1
-    int iNoCh = nChPts; // for other points nChPts...nPts-1
+    for ( i=0; i<nCand; i++ ) OnHull[i] = 0;
 
-    for( i=0; i<nPts; i++ )
+    for ( k=0; k<nChPts; k++ )
     {
-      if ( ChNext[i] != -1 ) // if point is on convex hull
-	 PointsAux[iCh++] = Points[i];
-      else
-	 PointsAux[iNoCh++] = Points[i];
+       i = Hull[ (nLower-1+k) % nChPts ];
+       PointsAux[k] = Points[i];
+       OnHull[i] = 1;
     }
+    for ( i=0; i<nCand; i++ )
+       if ( !OnHull[i] ) PointsAux[k++] = Points[i];
 
-    //
-    // now replace Points with PointsAux
-    //
-
-    delete( Points );
+    for ( i=0; i<nCand; i++ ) Points[i] = PointsAux[i];
 
-    Points = PointsAux;
-    PointsAux = NULL;
-#endif
-
-    delete( ChNext );
+    delete[] PointsAux;
+    delete[] OnHull;
+    delete[] Hull;
 
     #ifdef DEBUG
       DEBUG << "Points( end of CalcConvexHull ): " << endl;
@@ -395,246 +383,9 @@ void TRefineDelaunay::CalcConvexHull()
       DEBUG << endl;
     #endif // DEBUG
 
-
-}
-
-
-// ---------------------------------------------------------------------------------
-//
-//   void TRefineDelaunay::GrahamSortPoints()
-//
-//   Sort array Points counterclockwise w.r.t. a point internal to the set.
-//   Use heapsort, with an optimal computational cost of 
-//   O( n log n ) and no need for auxiliary structures.
-//
-//   INPUT: array Points, containing the input points sorted in the order in
-//   which they have been read.
-//
-//   OUTPUT: array Points sorted counterclockwise w.r.t. a point internal
-//   to the convex hull (the baricenter of the first three non-aligned
-//   points).
-//
-
-void TRefineDelaunay::GrahamSortPoints()
-{
-    
-    int i, insI;
-
-    #ifdef DEBUG
-      DEBUG << "TRefineDelaunay::GrahamSortPoints()" << endl;
-    #endif
-
-    //
-    // find baricenter of three non-aligned points in array Points
-    //
-
-    PTPoint CenterPoint = NULL;
-
-    for( i=2; i<nPts && CenterPoint==NULL; i++ )
-    {
-
-       if ( ! Geom::Alignedxy( Points[0], Points[1], Points[i] ) )
-       {
-
-          //
-          // found three non-aligned points, compute baricenter
-          //
-
-          CenterPoint = new TPoint(
-                         ( Points[0]->x + Points[1]->x + Points[i]->x ) / 3.0,
-                         ( Points[0]->y + Points[1]->y + Points[i]->y ) / 3.0,
-                         0.0
-                      );
-
-          check( (CenterPoint == NULL),
-             "TRefineDelaunay::CalcConvexHull(), insufficient memory" );
-
-          //
-          // since now CenterPoint != NULL, the loop ends
-          //
-
-       }
-
-    } // end ...for
-
-   
-    //
-    // if now CenterPoint is still NULL, then three non-aligned points
-    // do not exist in the input set
-    //
-
-    check ( (CenterPoint == NULL),
-            "TRefineDelaunay::CalcConvexHull(), all points are aligned");     
-    
-    //
-    // start of real sorting algorithm
-    //
-        
-    //
-    // Elements in positions from [nPts/2] to [nPts-1] alread form a heap.
-    // Insert in such heap the elements of previous positions.
-    //
-
-    for( insI=((int)nPts/2)-1; insI>=0; insI-- )
-         HeapSortSift( insI, nPts-1, CenterPoint );
-
-    //
-    // now transform heap into sorted array
-    //
-
-    PTPoint pTmp;
-    
-    for( insI=nPts-1; insI>=1; insI-- )
-    {
-         // ...swap Points[0] and Points[insI]
-	 pTmp = Points[0];
-	 Points[0] = Points[insI];
-	 Points[insI] = pTmp;
-	 
-	 HeapSortSift( 0, insI-1, CenterPoint );
-    }
-    
-    // 
-    // array has been sorted
-    //
-        
-    delete( CenterPoint );
-    CenterPoint = NULL;
-
- }
-
-
-// -----------------------------------------------------------------------------------------
-//
-//  int  TRefineDelaunay::HeapSortSift( int first, int last, PTPoint CenterPoint )
-//
-//  Auxiliary function for heapsort. Merge the element of positipon
-//  first into the heap.
-//
-
-void TRefineDelaunay::HeapSortSift( int first, int last, PTPoint CenterPoint )
-{
-
-   int i = first;
-   int j = (2 * i) + 1; // left son of i
-   
-   PTPoint pTmp = NULL;
-   
-   while( j <= last )
-   {   
-   
-      // find the larger of the two children of Points[i], and
-      // go on into that branch
-      if ( j+1 <= last ) 
-         if ( GrahamSortFunc( Points[j], Points[j+1], CenterPoint ) < 0 )
-	    j = j+1;
-      
-      if ( GrahamSortFunc( Points[i], Points[j], CenterPoint ) < 0 )
-      {
-          // ...swap Points[i] and Points[j]
-	  pTmp = Points[i];
-	  Points[i] = Points[j];
-	  Points[j] = pTmp;	  
-
-          i = j;
-          j = (2 * i) + 1;	  
-      }
-      else break; 
-   
-   } // end ...while( j < nPts )
-
 }
 
 
-// -----------------------------------------------------------------------------------------
-//
-//  int  TRefineDelaunay::GrahamSortFunc( PTPoint, PTPoint, PTPoint )
-//
-//  Set the ordering of the points based on the angle formed by the segment
-//  joining each point to CenterPoint (a point inside the convex hull).
-//  Two points are compared in the following way:
-//
-//   a) a point of coordinates equal to CenterPoint is minimum 
-//
-//   b) if the quadrants of the two points are different, then the
-//      points are in the same relation as their quadrants:
-//
-//         I quadrant < II quadrant < III quadrant < IV quadrant
-//
-//   c) if the quadrants of the two points are equal, then
-//      P1 is less than P2 iff (CenterPoint, P1, P2) form a right turn.
-//
-
-int TRefineDelaunay::GrahamSortFunc( PTPoint P1, PTPoint P2, PTPoint CenterPoint )
-{
-     
-    //
-    // test if one point is the same as CenterPoint
-    //
-    
-    boolean C1 = P1->Equalsxy( CenterPoint );
-    boolean C2 = P2->Equalsxy( CenterPoint );
-
-    if ( C1 && C2 )
-       return 0;              // P1 = P2
-    else if ( C1 && ! C2 )
-       return -1;              // P1 < P2
-    else if ( !C1 && C2 )
-       return 1;             // P1 > P2
-
-    //
-    // find the quadrants of the two points (by convention, the positive 
-    // x axis belongs to the I quadrant, the positive y axis belongs to 
-    // the II quadrant, the negative x axis belongs to the III quadrant,
-    // and the negative y axis belongs to the IV quadrant)
-    //
-
-    int QP1, QP2;
-    
-    // first P1
-    if ( P1->x > CenterPoint->x && P1->y >= CenterPoint->y )
-       QP1 = 1;
-    else if ( P1->x <= CenterPoint->x && P1->y > CenterPoint->y )
-       QP1 = 2;
-    else if ( P1->x < CenterPoint->x && P1->y <= CenterPoint->y )
-       QP1 = 3;
-    else
-       QP1 = 4;
-
-    // then P2
-    if ( P2->x >  CenterPoint->x && P2->y >= CenterPoint->y )
-       QP2 = 1;
-    else if ( P2->x <= CenterPoint->x && P2->y > CenterPoint->y )
-       QP2 = 2;
-    else if ( P2->x < CenterPoint->x && P2->y <= CenterPoint->y )
-       QP2 = 3;
-    else
-       QP2 = 4;
-
-    // compare the two quadrants
-
-    if ( QP1 < QP2 )
-       return -1;
-    else if ( QP1 > QP2 )
-       return 1;
-    else // QP1 == QP2
-    {
-       switch( Geom::Turnxy( CenterPoint, P1, P2 ) )
-       {
-          case TURN_LEFT: return -1; 
-          case TURN_RIGHT: return 1;
-          case ALIGNED: return 0; 
-       }
-    }
-
-    // the following code is not reached, but needed in order to
-    // avoid warning from the compiler
-
-    error( "TRefineDelaunay::GrahamSort(), this should not happen" );
-    return(0);
-
-}
-
 
 // ---------------------------------------------------------------------------------
 //
@@ -751,6 +502,7 @@ void TRefineDelaunay::AddTriangle( PTTriangle T )
 {
     TBuildDelaunay::AddTriangle(T);
     T->Mark( NEW_TRIANGLE );
+    if ( ! InitialPhase ) NewTrgs.Add( T );
 }
 
 
@@ -758,6 +510,13 @@ void TRefineDelaunay::DetachTriangle( PTTriangle T )
 {
     PTPoint P = NULL;
     
+    //
+    // a triangle created and deleted within the same update step
+    // never reaches the MT
+    //
+
+    if ( ! InitialPhase && T->Marked( NEW_TRIANGLE ) ) NewTrgs.RemoveObject( T );
+
     TBuildDelaunay::DetachTriangle(T);
     
     //
@@ -866,7 +625,8 @@ void TRefineDelaunay::EndTriangulation()
     //
     
     PTTriangle *TrgArray;
-    int it, i;
+    TIndex it;
+    int i;
 
     TrgArray = new PTTriangle[ nTrg ];
         
@@ -955,103 +715,61 @@ void TRefineDelaunay::MT_Initial()
     //
     // Triangles created during construction of the initial triangulation
     // are still marked as NEW_TRIANGLE (DeleteInfluenceRegion does not
-    // unmark them). We can call MT_AddComponent().
+    // unmark them), but have not been recorded in NewTrgs. Collect them,
+    // then we can call MT_AddComponent().
     //
     
+    CollectNewTriangles();
     MT_AddComponent();
     
 }
 
 
+//
+// Collect the old triangles of the region of influence into OldTrgs,
+// and call MT->KillTriangle(T) for each of them. They are deleted later,
+// from the same buffer, by TDelaunayBase::DeleteInfluenceRegion().
+//
+
 void TRefineDelaunay::MT_KillInterference()
 {
 
+   TIndex i;
+
    #ifdef MT_DEBUG
      MT_DEBUG << endl << "MT: insert V" << VertexToIns->VID 
           << ": " << VertexToIns->x << ", " << VertexToIns->y 
           << " => ERR : " << VertexToIns->Error << endl;
    #endif
 
-   if ( FirstTrgToDel != NULL )
-   {
-   
-      #ifdef ROBUST
-         check( (! FirstTrgToDel->Marked( TO_DELETE ) ),
-            "TRefineDelaunay::MT_KillInterference(), inconsistency detected" );
-      #endif
-
-      TDoubleList<PTTriangle> Triangles;
-      
-      FirstTrgToDel->Mark( MT_DELETED );
-      Triangles.AddHead( FirstTrgToDel );
-      
-      while( !Triangles.IsEmpty() )
-      {
-          int t;
-
-          PTTriangle T = Triangles.RemoveHead();
-          PTTriangle TT[3];
-      
-          // do not remove mark TO_DELETE, it is needed in
-          //    TBuildDelaunay::DeleteInfluenceRegion()
-      
-          T->GetTT( TT[0], TT[1], TT[2] );
-      
-          MT->KillTriangle( T );
-      
-          for( t=0; t<3; t++ )
-             if ( TT[t] != NULL && TT[t]->Marked( TO_DELETE ) 
-                  && ! TT[t]->Marked( MT_DELETED ) )
-                  {  
-                     TT[t]->Mark( MT_DELETED );
-	             Triangles.AddTail( TT[t] );
-                  }
-		     
-      }
-      
-   }
+   CollectInfluenceRegion();
+
+   for( i=0; i<OldTrgs.Count(); i++ )
+      MT->KillTriangle( OldTrgs[i] );
    
 }
 
 
+//
+// Call MT->MakeTriangle(T) for each new triangle recorded in NewTrgs
+// and unmark it, then empty NewTrgs and call MT->MeshOk().
+//
+
 void TRefineDelaunay::MT_AddComponent()
 {
 
-   int t;
+   TIndex i;
 
    #ifdef ROBUST
-      check( (FirstTriangle == NULL || !FirstTriangle->Marked( NEW_TRIANGLE )),
-             "TRefineDelaunay::MT_AddComponent(), inconsistency detected" );
+      check( NewTrgs.IsEmpty(), "TRefineDelaunay::MT_AddComponent(), inconsistency detected" );
    #endif
      
-   TDoubleList<PTTriangle> Triangles;
-     
-   FirstTriangle->UnMark( NEW_TRIANGLE );
-   Triangles.AddHead( FirstTriangle );
-   
-   while ( ! Triangles.IsEmpty() )
+   for( i=0; i<NewTrgs.Count(); i++ )
    {
-      PTTriangle T = Triangles.RemoveHead();
-      PTTriangle TT[3];
- /*     PTVertex   TV[3];
-      
-      T->GetTV( TV[0], TV[1], TV[2] );
- */  
-      T->GetTT( TT[0], TT[1], TT[2] );
-
- /*     double Error = 0.0;
-      if ( ! T->PointList.IsEmpty() ) Error = T->PointList.GetHead()->Error;
- */
-      MT->MakeTriangle( T );
-      
-      for( t=0; t<3; t++ )
-         if ( TT[t] != NULL && TT[t]->Marked( NEW_TRIANGLE ) )
-         {
-            TT[t]->UnMark( NEW_TRIANGLE );
-	    Triangles.AddTail( TT[t] );
-         }
-      
+      NewTrgs[i]->UnMark( NEW_TRIANGLE );
+      MT->MakeTriangle( NewTrgs[i] );
    }
+   NewTrgs.Clear();
 
    MT->MeshOk();
   
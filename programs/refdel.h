@@ -60,11 +60,7 @@ class TRefineDelaunay : public TBuildDelaunay
       //
       
       // Number of points on the convex hull.
-      int nChPts; 
-
-      // Static variable used for sorting the points in CalcConvexHull().
-      // WHY STATIC?
-      static PTPoint CenterPoint;
+      TIndex nChPts; 
 
       // Points that belonged to the PointLists of triangles/edges
       // of the part of triangulation that has been modified.
@@ -101,13 +97,17 @@ class TRefineDelaunay : public TBuildDelaunay
       virtual boolean NoMoreUpdates()
         { return( iNextPoint >= nPts || MT->TerminateCondition() ); };
 
+      virtual int NextLevel() { return( MT->LodReached() ); };
+
+      virtual void StartBudgets() { MT->StartClock(); };
+
+      // Checkpoints: the history is added to the state.
+      virtual void SaveState( RTCheckpoint );
+      virtual void LoadState( RTCheckpoint );
+
            
       void CalcConvexHull();
 
-      void GrahamSortPoints();
-         void HeapSortSift( int, int, PTPoint );
-         int GrahamSortFunc( PTPoint, PTPoint, PTPoint );
-
       virtual void NextPoint();
 
       virtual void DeleteInfluenceRegion();
@@ -0,0 +1,269 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// -------------------------------------------------------------------------
+//
+//   file   : referrCDT.cpp
+//
+//   Implementation of class TRefErrCDT (see referrCDT.h).
+//
+
+
+#include <iostream>
+
+#include "defs.h"
+#include "error.h"
+#include "geom.h"
+
+#include "tbtree.h"
+
+#include "refCDT.h"
+#include "referrCDT.h"
+
+#include "mttracer.h"
+
+
+// -------------------------------------------------------------------------
+//
+//  void TRefErrCDT::InitialTriangulation()
+//
+//  Triangulate the convex hull, insert the endpoints of the constraints
+//  and then the constraints, all in the initial phase (i.e., as a single
+//  component of the MT). The remaining points are then placed in the
+//  PointLists of the edges/triangles in which they fall, and in
+//  PtsErrTree.
+//
+
+void TRefErrCDT::InitialTriangulation()
+{
+    TIndex i, nEnd;
+
+    #ifdef DEBUG
+      DEBUG << "TRefErrCDT::InitialTriangulation()" << endl;
+    #endif
+
+    TRefineDelaunay::InitialPhase = TRUE;
+
+    TriangulateHull();
+
+    //
+    // insert the endpoints of the constraints, in the same way as
+    // TRefCDT inserts all points (PointLists are still empty)
+    //
+
+    nEnd = GatherEndpoints();
+    for( i=0; i<nEnd; i++ )
+    {
+       TRefCDT::NextPoint();
+       TRefineDelaunay::InsertVertex();
+    }
+
+    #ifdef OUTPUT
+      cerr << "inserted " << nEnd << " endpoints of constraints" << endl;
+    #endif
+
+    //
+    // map the constraints to vertices and insert them
+    //
+
+    TRefCDT::PrepareToEnd();
+
+    //
+    // the other points, Points[iNextPoint]...Points[nPts-1], wait in
+    // the PointLists and in PtsErrTree
+    //
+
+    for( i=iNextPoint; i<nPts; i++ )
+       RepositionPoint( Points[i] );
+
+    MT_Initial();
+
+    TRefineDelaunay::InitialPhase = FALSE;
+}
+
+
+// -------------------------------------------------------------------------
+//
+//  TIndex TRefErrCDT::GatherEndpoints()
+//
+//  Called after TriangulateHull(), when constr_array still contains
+//  indices of input points (i.e., PIDs). Invalid constraints are
+//  skipped here, and discarded later by PrepareToEnd().
+//
+
+TIndex TRefErrCDT::GatherEndpoints()
+{
+    TIndex i, k, pid;
+    PTPoint P;
+
+    boolean *IsEnd = new boolean[nPts];
+    check( (IsEnd == NULL), "TRefErrCDT::GatherEndpoints(), insufficient memory" );
+
+    for( i=0; i<nPts; i++ ) IsEnd[i] = FALSE;
+    for( i=0; i<2*nConstr; i++ )
+    {
+       pid = constr_array[i];
+       if ( pid >= 0 && pid < nPts ) IsEnd[pid] = TRUE;
+    }
+
+    k = nChPts;
+    for( i=nChPts; i<nPts; i++ )
+       if ( IsEnd[Points[i]->PID] )
+       {
+          P = Points[i];  Points[i] = Points[k];  Points[k] = P;
+          k++;
+       }
+
+    delete[] IsEnd;
+    return( k - nChPts );
+}
+
+
+// -------------------------------------------------------------------------
+//
+//  void TRefErrCDT::NextPoint()
+//
+//  As TRefErrDelaunay::NextPoint(): the next vertex is the point of
+//  maximum error. Array OrderInitial is not needed any more, since
+//  the constraints have already been inserted.
+//
+
+void TRefErrCDT::NextPoint()
+{
+   #ifdef ROBUST
+       check( (PtsErrTree.IsEmpty()),
+            "TRefErrCDT::NextPoint(), point tree empty" );
+   #endif
+
+   PTPoint PointToIns = PtsErrTree.RemoveMax();
+
+   Points[ iNextPoint ] = VertexToIns = new TVertex( PointToIns );
+   check( (VertexToIns == NULL), "TRefErrCDT::NextPoint(), insufficient memory");
+
+   iNextPoint++;
+}
+
+
+// -------------------------------------------------------------------------
+//
+//  void TRefErrCDT::InsertVertex()
+//
+//  As TBuildDelaunay::InsertVertex(), but if VertexToIns lies on a
+//  constraint, the constraint becomes an ordinary edge (to be deleted
+//  with the influence region), and its two halves are made constraints
+//  by DeleteInfluenceRegion().
+//
+
+void TRefErrCDT::InsertVertex()
+{
+   PointLocation( VertexToIns );
+
+   if ( PLLocation == PL_VERTEX )
+   {
+      cerr << "\n Duplicated point : " << *VertexToIns;
+      cerr << "\n It is the same as : " << *PLVertex;
+      cerr << "\n Not inserted." << endl;
+      return;
+   }
+
+   if ( PLLocation == PL_EDGE && PLEdge->Marked( CONSTRAINED ) )
+   {
+      SplitV[0] = PLEdge->EV[0];
+      SplitV[1] = PLEdge->EV[1];
+      Constraint2Edge( PLEdge );
+   }
+
+   TRefineDelaunay::CalcInfluenceRegion();
+   TRefineDelaunay::RetriangulateInfluenceRegion();
+}
+
+
+// -------------------------------------------------------------------------
+//
+//  void TRefErrCDT::DeleteInfluenceRegion()
+//
+//  Called by RetriangulateInfluenceRegion() when the new edges incident
+//  in VertexToIns exist already.
+//
+
+void TRefErrCDT::DeleteInfluenceRegion()
+{
+   int i;
+   PTEdge E;
+
+   if ( SplitV[0] != NULL )
+   {
+      for( i=0; i<2; i++ )
+      {
+         E = FindEdgeInVE( VertexToIns, SplitV[i] );
+         check( (E == NULL), "TRefErrCDT::DeleteInfluenceRegion(), half of split constraint not found" );
+         Edge2Constraint( E );
+      }
+      SplitV[0] = SplitV[1] = NULL;
+   }
+
+   TRefCDT::DeleteInfluenceRegion();
+}
+
+
+// -----------------------------------------------------------------------------
+//
+//  void TRefErrCDT::RepositionPoint( PTPoint )
+//  void TRefErrCDT::DetachTriangle( PTTriangle )
+//  void TRefErrCDT::DetachEdge( PTEdge )
+//
+//  As in TRefErrDelaunay, points are kept in PtsErrTree while they are
+//  in a PointList. Duplicates of vertices are in no PointList, and they
+//  are not inserted.
+//
+
+void TRefErrCDT::RepositionPoint( PTPoint P )
+{
+   TRefineDelaunay::RepositionPoint( P );
+   if ( PLLocation != PL_VERTEX ) PtsErrTree.Insert( P );
+}
+
+
+void TRefErrCDT::DetachTriangle( PTTriangle T )
+{
+    TListIterator<PTPoint> PLIter( &T->PointList );
+    while( !PLIter.EndOfList() )
+    {
+       PtsErrTree.Remove( PLIter.Current()->object );
+       PLIter.GoNext();
+    }
+
+    TRefCDT::DetachTriangle( T );
+}
+
+
+void TRefErrCDT::DetachEdge( PTEdge E )
+{
+    TListIterator<PTPoint> PLIter( &E->PointList );
+    while( !PLIter.EndOfList() )
+    {
+       PtsErrTree.Remove( PLIter.Current()->object );
+       PLIter.GoNext();
+    }
+
+    TRefCDT::DetachEdge( E );
+}
@@ -0,0 +1,97 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// -------------------------------------------------------------------------
+//
+//   file   : referrCDT.h
+//
+//   Definition of class TRefErrCDT, sub-class of TRefCDT, for building
+//   a constrained Delaunay triangulation through refinement, with an
+//   error-based choice of the point to be inserted.
+//   Unlike TRefCDT, which inserts all points and then all constraints,
+//   the initial triangulation is the CDT of the convex hull, of the
+//   endpoints of the constraints and of the constraints themselves.
+//   The other points are then inserted in order of error (as in
+//   TRefErrDelaunay), while respecting the constraints: the region of
+//   influence of a point does not cross constraints, and a point lying
+//   on a constraint splits it in two. In this way the MT and the
+//   termination conditions see the constrained triangulation, and the
+//   triangulation is constrained also if the refinement stops early.
+//
+
+#ifndef _REFERRCDT_H
+#define _REFERRCDT_H
+
+#include "tbtree.h"
+#include "refCDT.h"
+
+
+class TRefErrCDT;
+
+typedef class TRefErrCDT *PTRefErrCDT;
+typedef class TRefErrCDT &RTRefErrCDT;
+
+class TRefErrCDT : public TRefCDT
+{
+   protected:
+
+      // Set of points not yet inserted in the triangulation, sorted
+      // based on their Error field (see TRefErrDelaunay).
+      TBTree<PTPoint> PtsErrTree;
+
+      // Endpoints of the constraint split by VertexToIns in the current
+      // update step (NULL if VertexToIns does not lie on a constraint).
+      PTVertex SplitV[2];
+
+      virtual void InitialTriangulation();
+
+      virtual boolean NoMoreUpdates()
+        { return( PtsErrTree.IsEmpty() || TRefineDelaunay::MT->TerminateCondition() ); }
+
+      virtual void NextPoint();
+      virtual void InsertVertex();
+
+      virtual void RepositionPoint( PTPoint );
+      virtual void DetachTriangle( PTTriangle );
+      virtual void DetachEdge( PTEdge );
+
+      // Restore the split constraint as two constraints incident in
+      // VertexToIns, before the update is passed to the MT.
+      virtual void DeleteInfluenceRegion();
+
+      // Constraints are inserted by InitialTriangulation.
+      virtual void PrepareToEnd() {}
+
+      // Move the endpoints of the constraints not on the convex hull to
+      // positions [nChPts...] of array Points, and return their number.
+      TIndex GatherEndpoints();
+
+   public:
+
+      TRefErrCDT( PMTTracer iMT ) : TDelaunayBase(), TDecimDelaunay( 0, iMT ),
+                                    TRefCDT( iMT ), PtsErrTree()
+      {
+         SplitV[0] = SplitV[1] = NULL;
+      };
+};
+
+#endif // _REFERRCDT_H
@@ -101,12 +101,48 @@ void TRefErrDelaunay::AddAllPointsToTree()
        DEBUG << "TRefErrDelaunay::AddAllPointsToTree()" << endl;
     #endif
     
-    for( int i=nChPts; i<nPts; i++ )
+    for( TIndex i=nChPts; i<nPts; i++ )
        PtsErrTree.Insert( Points[i] );
     
 }
 
 
+// -------------------------------------------------------------------------
+//
+//  void TRefErrDelaunay::SaveState( RTCheckpoint C )
+//  void TRefErrDelaunay::LoadState( RTCheckpoint C )
+//
+//  Add the points not yet inserted to the state. Since PtsErrTree is
+//  sorted on error and coordinates, inserting them again gives the same
+//  order of insertion.
+//
+
+void TRefErrDelaunay::SaveState( RTCheckpoint C )
+{
+    TDoubleList<PTPoint> L;
+
+    TRefineDelaunay::SaveState( C );
+
+    PtsErrTree.GetSorted( L );
+    C.PutIndex( L.Lenght() );
+    while( !L.IsEmpty() )
+       SavePoint( C, L.RemoveHead() );
+}
+
+
+void TRefErrDelaunay::LoadState( RTCheckpoint C )
+{
+    TIndex i, n;
+
+    TRefineDelaunay::LoadState( C );
+
+    PtsErrTree.ClearTree();
+    n = C.GetIndex();
+    for( i=0; i<n; i++ )
+       PtsErrTree.Insert( LoadPoint( C ) );
+}
+
+
 // -------------------------------------------------------------------------
 //
 //  void TRefErrDelaunay::NextPoint()
@@ -69,6 +69,11 @@ class TRefErrDelaunay : public TRefineDelaunay
 
        virtual void DetachTriangle( PTTriangle );
        virtual void DetachEdge( PTEdge );
+
+       // Checkpoints: PtsErrTree is added to the state.
+       virtual void SaveState( RTCheckpoint );
+       virtual void LoadState( RTCheckpoint );
+       virtual boolean PendingPointsInArray() { return( FALSE ); };
        
    public:
    
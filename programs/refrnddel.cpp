@@ -119,17 +119,17 @@ void TRefRndDelaunay::RandomSortPoints()
      DEBUG << "Chiamata TRefRndDelaunay::RandomSortPoints()" << endl;
    #endif
    
-   int n = nPts - nChPts;
-   int j;
+   TIndex n = nPts - nChPts;
+   TIndex j;
    
    PTPoint pTmp;
    
    srand48( (int)time(NULL) );
    
-   for( int i=nChPts; i<nPts; i++ )
+   for( TIndex i=nChPts; i<nPts; i++ )
    {
 
-      j = nChPts + (int)( lrand48() % (long)n );
+      j = nChPts + (TIndex)( lrand48() % (long)n );
       // j is another random number in [nChPts...nPts-1]
 
       #ifdef ROBUST  
@@ -0,0 +1,353 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+// ----------------------------------------------------------------------
+//
+//   file   : reorder.cpp
+//
+//   Implementation of class Reorder, static functions for renumbering
+//   the entities of a triangulation along a space-filling curve.
+//
+
+#include <stdlib.h>
+
+#include "defs.h"
+#include "error.h"
+#include "ttriang.h"
+#include "reorder.h"
+
+
+// Number of bits used for each coordinate of the grid.
+#define REORDER_BITS 16
+
+
+// -----------------------------------------------------------------
+//
+//  unsigned int Reorder::MortonKey( unsigned int ix, unsigned int iy )
+//
+//  Interleave the bits of ix and iy (bit of x in even position).
+//
+
+unsigned int Reorder::MortonKey( unsigned int ix, unsigned int iy )
+{
+   unsigned int key = 0;
+   int b;
+
+   for ( b=REORDER_BITS-1; b>=0; b-- )
+   {
+      key = (key << 2) | (((iy >> b) & 1) << 1) | ((ix >> b) & 1);
+   }
+   return( key );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  unsigned int Reorder::HilbertKey( unsigned int ix, unsigned int iy )
+//
+//  Distance of cell (ix,iy) along the Hilbert curve filling the grid.
+//  At each level, find the quadrant of the cell, accumulate its
+//  position along the curve, then rotate/flip the cell coordinates
+//  so that the sub-curve in that quadrant has the standard orientation.
+//
+
+unsigned int Reorder::HilbertKey( unsigned int ix, unsigned int iy )
+{
+   unsigned int side = 1u << REORDER_BITS;
+   unsigned int s, rx, ry, tmp;
+   unsigned int key = 0;
+
+   for ( s=side/2; s>0; s/=2 )
+   {
+      rx = ( (ix & s) > 0 );
+      ry = ( (iy & s) > 0 );
+      key += s * s * ( (3 * rx) ^ ry );
+
+      if ( ry == 0 )
+      {
+         if ( rx == 1 )
+         {
+            ix = side - 1 - ix;
+            iy = side - 1 - iy;
+         }
+         tmp = ix; ix = iy; iy = tmp;
+      }
+   }
+   return( key );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  void Reorder::SortPoints( PTPoint *P, TIndex n, int mode )
+//
+//  Quantize the xy coordinates of the points on the grid covering
+//  their bounding box, compute the key of each point and sort.
+//
+
+/* Auxiliary type for sorting: one point with its key and its initial
+   position (used to keep the sort stable). */
+typedef struct
+{
+  unsigned int key;
+  TIndex pos;
+  PTPoint p;
+} reorder_pt;
+
+static int cmp_reorder_pt( const void *p, const void *q )
+{
+  reorder_pt *a = (reorder_pt *) p;
+  reorder_pt *b = (reorder_pt *) q;
+  if ( a->key < b->key ) return -1;
+  if ( a->key > b->key ) return 1;
+  if ( a->pos < b->pos ) return -1;
+  if ( a->pos > b->pos ) return 1;
+  return 0;
+}
+
+void Reorder::SortPoints( PTPoint *P, TIndex n, int mode )
+{
+   TIndex i;
+   double minx, miny, maxx, maxy, sx, sy;
+   double maxcell = (double)( (1u << REORDER_BITS) - 1 );
+   unsigned int ix, iy;
+
+   if ( mode == REORDER_NONE || n < 2 ) return;
+
+   check( (mode != REORDER_MORTON && mode != REORDER_HILBERT),
+          "Reorder::SortPoints(), unknown curve" );
+
+   minx = maxx = P[0]->x;
+   miny = maxy = P[0]->y;
+   for ( i=1; i<n; i++ )
+   {
+      if ( P[i]->x < minx ) minx = P[i]->x;
+      if ( P[i]->x > maxx ) maxx = P[i]->x;
+      if ( P[i]->y < miny ) miny = P[i]->y;
+      if ( P[i]->y > maxy ) maxy = P[i]->y;
+   }
+   sx = ( maxx > minx ) ? maxcell / (maxx - minx) : 0.0;
+   sy = ( maxy > miny ) ? maxcell / (maxy - miny) : 0.0;
+
+   reorder_pt *vec = (reorder_pt *) malloc( n * sizeof(reorder_pt) );
+   check( (vec == NULL), "Reorder::SortPoints(), insufficient memory" );
+
+   for ( i=0; i<n; i++ )
+   {
+      ix = (unsigned int)( (P[i]->x - minx) * sx + 0.5 );
+      iy = (unsigned int)( (P[i]->y - miny) * sy + 0.5 );
+      if ( mode == REORDER_MORTON )
+         vec[i].key = MortonKey( ix, iy );
+      else
+         vec[i].key = HilbertKey( ix, iy );
+      vec[i].pos = i;
+      vec[i].p = P[i];
+   }
+
+   qsort( vec, n, sizeof(reorder_pt), cmp_reorder_pt );
+
+   for ( i=0; i<n; i++ ) P[i] = vec[i].p;
+
+   free( vec );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  void Reorder::SortTriangles( PTTriangle *T, TIndex n )
+//
+//  Sort triangles on the triple of VIDs of their vertices, each
+//  triple being sorted in increasing order.
+//
+
+/* Auxiliary type for sorting: one triangle with its sorted VIDs. */
+typedef struct
+{
+  TIndex vid[3];
+  PTTriangle t;
+} reorder_trg;
+
+static int cmp_reorder_trg( const void *p, const void *q )
+{
+  reorder_trg *a = (reorder_trg *) p;
+  reorder_trg *b = (reorder_trg *) q;
+  int i;
+  for ( i=0; i<3; i++ )
+  {
+     if ( a->vid[i] < b->vid[i] ) return -1;
+     if ( a->vid[i] > b->vid[i] ) return 1;
+  }
+  return 0;
+}
+
+void Reorder::SortTriangles( PTTriangle *T, TIndex n )
+{
+   TIndex i, tmp;
+   int j, k;
+   PTVertex v[3];
+
+   if ( n < 2 ) return;
+
+   reorder_trg *vec = (reorder_trg *) malloc( n * sizeof(reorder_trg) );
+   check( (vec == NULL), "Reorder::SortTriangles(), insufficient memory" );
+
+   for ( i=0; i<n; i++ )
+   {
+      T[i]->GetTV( v[0], v[1], v[2] );
+      for ( j=0; j<3; j++ ) vec[i].vid[j] = v[j]->VID;
+      for ( j=0; j<2; j++ )
+        for ( k=j+1; k<3; k++ )
+          if ( vec[i].vid[k] < vec[i].vid[j] )
+          {
+             tmp = vec[i].vid[j]; vec[i].vid[j] = vec[i].vid[k]; vec[i].vid[k] = tmp;
+          }
+      vec[i].t = T[i];
+   }
+
+   qsort( vec, n, sizeof(reorder_trg), cmp_reorder_trg );
+
+   for ( i=0; i<n; i++ ) T[i] = vec[i].t;
+
+   free( vec );
+}
+
+
+// -----------------------------------------------------------------
+//
+//  TIndex Reorder::SortSegments( TIndex *S, TIndex n, PTPoint *P, int mode )
+//
+//  Sort the segments on their endpoints (the smaller index first) to
+//  find the repeated ones, then sort the remaining ones on the key of
+//  their midpoint (or on their position, if mode is REORDER_NONE).
+//
+
+/* Auxiliary type for sorting: one segment with its endpoints, the same
+   endpoints in increasing order, its key and its initial position. */
+typedef struct
+{
+  TIndex v[2];
+  TIndex lo, hi;
+  unsigned int key;
+  TIndex pos;
+} reorder_seg;
+
+static int cmp_reorder_seg_ends( const void *p, const void *q )
+{
+  reorder_seg *a = (reorder_seg *) p;
+  reorder_seg *b = (reorder_seg *) q;
+  if ( a->lo < b->lo ) return -1;
+  if ( a->lo > b->lo ) return 1;
+  if ( a->hi < b->hi ) return -1;
+  if ( a->hi > b->hi ) return 1;
+  if ( a->pos < b->pos ) return -1;
+  if ( a->pos > b->pos ) return 1;
+  return 0;
+}
+
+static int cmp_reorder_seg_key( const void *p, const void *q )
+{
+  reorder_seg *a = (reorder_seg *) p;
+  reorder_seg *b = (reorder_seg *) q;
+  if ( a->key < b->key ) return -1;
+  if ( a->key > b->key ) return 1;
+  if ( a->pos < b->pos ) return -1;
+  if ( a->pos > b->pos ) return 1;
+  return 0;
+}
+
+TIndex Reorder::SortSegments( TIndex *S, TIndex n, PTPoint *P, int mode )
+{
+   TIndex i, m;
+   double minx, miny, maxx, maxy, sx, sy, mx, my;
+   double maxcell = (double)( (1u << REORDER_BITS) - 1 );
+   unsigned int ix, iy;
+   PTPoint p0, p1;
+
+   if ( n < 1 ) return( n );
+
+   check( (mode != REORDER_NONE && mode != REORDER_MORTON && mode != REORDER_HILBERT),
+          "Reorder::SortSegments(), unknown curve" );
+
+   reorder_seg *vec = (reorder_seg *) malloc( n * sizeof(reorder_seg) );
+   check( (vec == NULL), "Reorder::SortSegments(), insufficient memory" );
+
+   for ( i=0; i<n; i++ )
+   {
+      vec[i].v[0] = S[2*i];
+      vec[i].v[1] = S[2*i+1];
+      vec[i].lo = ( S[2*i] < S[2*i+1] ) ? S[2*i] : S[2*i+1];
+      vec[i].hi = ( S[2*i] < S[2*i+1] ) ? S[2*i+1] : S[2*i];
+      vec[i].key = 0;
+      vec[i].pos = i;
+   }
+
+   // remove repeated segments: after sorting, the copies of a segment
+   // are consecutive, the first one in input order at the beginning
+
+   qsort( vec, n, sizeof(reorder_seg), cmp_reorder_seg_ends );
+
+   m = 1;
+   for ( i=1; i<n; i++ )
+      if ( vec[i].lo != vec[m-1].lo || vec[i].hi != vec[m-1].hi )
+         vec[m++] = vec[i];
+
+   // keys of the midpoints
+
+   if ( mode != REORDER_NONE )
+   {
+      minx = maxx = 0.5 * ( P[vec[0].lo]->x + P[vec[0].hi]->x );
+      miny = maxy = 0.5 * ( P[vec[0].lo]->y + P[vec[0].hi]->y );
+      for ( i=1; i<m; i++ )
+      {
+         mx = 0.5 * ( P[vec[i].lo]->x + P[vec[i].hi]->x );
+         my = 0.5 * ( P[vec[i].lo]->y + P[vec[i].hi]->y );
+         if ( mx < minx ) minx = mx;
+         if ( mx > maxx ) maxx = mx;
+         if ( my < miny ) miny = my;
+         if ( my > maxy ) maxy = my;
+      }
+      sx = ( maxx > minx ) ? maxcell / (maxx - minx) : 0.0;
+      sy = ( maxy > miny ) ? maxcell / (maxy - miny) : 0.0;
+
+      for ( i=0; i<m; i++ )
+      {
+         p0 = P[vec[i].lo];
+         p1 = P[vec[i].hi];
+         ix = (unsigned int)( ( 0.5 * (p0->x + p1->x) - minx ) * sx + 0.5 );
+         iy = (unsigned int)( ( 0.5 * (p0->y + p1->y) - miny ) * sy + 0.5 );
+         if ( mode == REORDER_MORTON )
+            vec[i].key = MortonKey( ix, iy );
+         else
+            vec[i].key = HilbertKey( ix, iy );
+      }
+   }
+
+   qsort( vec, m, sizeof(reorder_seg), cmp_reorder_seg_key );
+
+   for ( i=0; i<m; i++ )
+   {
+      S[2*i]   = vec[i].v[0];
+      S[2*i+1] = vec[i].v[1];
+   }
+
+   free( vec );
+   return( m );
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+// ----------------------------------------------------------------------
+//
+//   file   : reorder.h
+//
+//   Definition of a class collecting static functions for renumbering
+//   the entities of a triangulation along a space-filling curve
+//   (Morton or Hilbert order), in order to improve memory locality.
+//
+//   Points are sorted on the key of the cell of a 2^16 x 2^16 grid,
+//   covering their bounding box, in which they fall.
+//   Triangles are sorted on the smallest VID among their vertices, so
+//   that, once vertices have been renumbered along the curve, triangles
+//   follow the same order.
+//   Segments (e.g., the constraints of a CDT) are sorted on the cell in
+//   which their midpoint falls, so that consecutive segments are close.
+//
+
+
+#ifndef _REORDER_H
+#define _REORDER_H
+
+#include "defs.h"
+#include "ttriang.h"
+
+
+// ----------------------------------------------------------------------
+//
+//  class Reorder
+//
+
+
+class Reorder
+{
+   private:
+
+      // The default constructor is private. This makes it impossible
+      // to create instances of this class.
+      Reorder() { error("private constructor Reorder::Reorder() called" ); };
+
+   public:
+
+      // Key of cell (ix,iy) of the grid along the Morton (Z-order) curve
+      // and along the Hilbert curve.
+      static unsigned int MortonKey( unsigned int ix, unsigned int iy );
+      static unsigned int HilbertKey( unsigned int ix, unsigned int iy );
+
+      // Sort the n points of array P along the curve given by mode
+      // (REORDER_MORTON or REORDER_HILBERT). Points with the same key
+      // keep their relative order. Nothing is done if mode is
+      // REORDER_NONE.
+      static void SortPoints( PTPoint *P, TIndex n, int mode );
+
+      // Sort the n triangles of array T on the smallest VID of their
+      // vertices (then on the second smallest, then on the largest).
+      static void SortTriangles( PTTriangle *T, TIndex n );
+
+      // The n segments of array S are pairs of indices in array P
+      // (S[2i], S[2i+1]). Remove repeated segments (in either
+      // orientation), keeping the first occurrence, and sort the others
+      // along the curve given by mode, on their midpoints. If mode is
+      // REORDER_NONE, the segments keep their order. Return the number
+      // of segments left in S.
+      static TIndex SortSegments( TIndex *S, TIndex n, PTPoint *P, int mode );
+};
+
+#endif // _REORDER_H
@@ -0,0 +1,797 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : segclean.cpp
+//
+//   Implementation of class SegClean, static functions for cleaning
+//   the constraint segments of a CDT before it is built.
+//
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+#include "error.h"
+#include "geom.h"
+#include "ttriang.h"
+#include "reorder.h"
+#include "segclean.h"
+
+#ifdef PARALLEL_CLEAN
+#include <pthread.h>
+#endif
+
+
+// Below this number of items, a sweep is not worth the threads.
+#define CLEAN_MIN_PARALLEL  4096
+
+// Items (points or segments) taken at a time by each thread.
+#define CLEAN_BLOCK  256
+
+
+// ----------------------------------------------------------------------
+//
+//  void TSegCleanStats::Print( ostream &os )
+//
+
+void TSegCleanStats::Print( ostream &os )
+{
+   os << nInvalid    << " segments with non-existing points removed" << endl
+      << nSnapped    << " points snapped" << endl
+      << nDegenerate << " degenerate segments removed" << endl
+      << nRepeated   << " repeated segments removed" << endl
+      << nOnSegment  << " splits at points inside a segment" << endl
+      << nCrossings  << " crossings split" << endl
+      << nDropped    << " segments still crossing removed" << endl
+      << "(" << nPasses << " passes)" << endl;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Auxiliary types for sorting: a point with its coordinates (and the
+//  key of its column of width Tol), a segment with its bounding box, a
+//  split point with its position along the segment.
+//
+
+typedef struct
+{
+  double key, x, y;
+  TIndex i;
+} clean_pt;
+
+typedef struct
+{
+  double x0, x1, y0, y1;
+  TIndex s;
+} clean_seg;
+
+typedef struct
+{
+  TIndex s, p;
+  double t;
+} clean_hit;
+
+static int cmp_clean_pt( const void *p, const void *q )
+{
+  clean_pt *a = (clean_pt *) p;
+  clean_pt *b = (clean_pt *) q;
+  if ( a->key < b->key ) return -1;
+  if ( a->key > b->key ) return 1;
+  if ( a->y < b->y ) return -1;
+  if ( a->y > b->y ) return 1;
+  if ( a->i < b->i ) return -1;
+  if ( a->i > b->i ) return 1;
+  return 0;
+}
+
+static int cmp_clean_seg( const void *p, const void *q )
+{
+  clean_seg *a = (clean_seg *) p;
+  clean_seg *b = (clean_seg *) q;
+  if ( a->x0 < b->x0 ) return -1;
+  if ( a->x0 > b->x0 ) return 1;
+  if ( a->s < b->s ) return -1;
+  if ( a->s > b->s ) return 1;
+  return 0;
+}
+
+static int cmp_clean_hit( const void *p, const void *q )
+{
+  clean_hit *a = (clean_hit *) p;
+  clean_hit *b = (clean_hit *) q;
+  if ( a->s < b->s ) return -1;
+  if ( a->s > b->s ) return 1;
+  if ( a->t < b->t ) return -1;
+  if ( a->t > b->t ) return 1;
+  if ( a->p < b->p ) return -1;
+  if ( a->p > b->p ) return 1;
+  return 0;
+}
+
+static int cmp_clean_pair( const void *p, const void *q )
+{
+  TIndex *a = (TIndex *) p;
+  TIndex *b = (TIndex *) q;
+  if ( a[0] < b[0] ) return -1;
+  if ( a[0] > b[0] ) return 1;
+  if ( a[1] < b[1] ) return -1;
+  if ( a[1] > b[1] ) return 1;
+  return 0;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  Sweeps
+//
+//  A sweep scans items 0..n-1 (points sorted on x, or segments sorted
+//  on their left end), calling Scan on each one, which appends its
+//  results to Out. With PARALLEL_CLEAN, the items are taken in blocks
+//  of CLEAN_BLOCK by CLEAN_THREADS threads in turn, each with its own
+//  output, and the outputs are appended in the order of the threads;
+//  callers sort the results, so that they do not depend on the threads.
+//
+
+typedef struct clean_sweep
+{
+  PTPoint *P;
+  TIndex *S;
+  TIndex n;
+  double Tol;
+  clean_pt *Pts;          // points sorted on x (FindOnSegment)
+  TIndex nPts;
+  clean_seg *Segs;        // segments sorted on x0 (FindCrossings)
+  void (*Scan)( struct clean_sweep *, TIndex, TBuffer<TIndex> & );
+  int Thread;
+  TBuffer<TIndex> *Out;
+} clean_sweep;
+
+#ifdef PARALLEL_CLEAN
+
+static void *clean_sweep_main( void *arg )
+{
+   clean_sweep *W = (clean_sweep *) arg;
+   TIndex b, i, e;
+
+   for ( b = W->Thread * CLEAN_BLOCK; b < W->n; b += CLEAN_THREADS * CLEAN_BLOCK )
+   {
+      e = MIN( b + CLEAN_BLOCK, W->n );
+      for ( i=b; i<e; i++ ) W->Scan( W, i, *W->Out );
+   }
+   return( NULL );
+}
+
+#endif
+
+static void clean_run( clean_sweep *W, TBuffer<TIndex> &Out )
+{
+   TIndex i;
+
+#ifdef PARALLEL_CLEAN
+   if ( W->n >= CLEAN_MIN_PARALLEL )
+   {
+      clean_sweep Wt[CLEAN_THREADS];
+      TBuffer<TIndex> OutT[CLEAN_THREADS];
+      pthread_t Thread[CLEAN_THREADS];
+      int t;
+
+      for ( t=0; t<CLEAN_THREADS; t++ )
+      {
+         Wt[t] = *W;
+         Wt[t].Thread = t;
+         Wt[t].Out = &OutT[t];
+         check( (pthread_create( &Thread[t], NULL, clean_sweep_main, &Wt[t] ) != 0),
+                "SegClean, cannot create sweep thread" );
+      }
+      for ( t=0; t<CLEAN_THREADS; t++ )
+      {
+         pthread_join( Thread[t], NULL );
+         for ( i=0; i<OutT[t].Count(); i++ ) Out.Add( OutT[t][i] );
+      }
+      return;
+   }
+#endif
+
+   for ( i=0; i<W->n; i++ ) W->Scan( W, i, Out );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  TIndex SegClean::SnapPoints( PTPoint *P, TIndex &nP, TIndex *S,
+//                               TIndex n, double Tol )
+//
+//  Points are sorted on columns of width Tol, then on y; the points
+//  closer than Tol to a point are in its column or in the next one,
+//  within Tol in y. Snapped points are joined in classes (union-find),
+//  represented by their point of smallest index.
+//
+
+static TIndex clean_find( TIndex *Rep, TIndex i )
+{
+   while ( Rep[i] != i )
+   {
+      Rep[i] = Rep[Rep[i]];
+      i = Rep[i];
+   }
+   return( i );
+}
+
+static void clean_join( TIndex *Rep, TIndex i, TIndex j )
+{
+   i = clean_find( Rep, i );
+   j = clean_find( Rep, j );
+   if ( i < j ) Rep[j] = i;
+   else if ( j < i ) Rep[i] = j;
+}
+
+static boolean clean_close( PTPoint p, PTPoint q, double Tol )
+{
+   if ( Tol == 0.0 ) return( p->Equalsxy( q ) );
+   return( Geom::Distancexy( p, q ) <= Tol );
+}
+
+TIndex SegClean::SnapPoints( PTPoint *P, TIndex &nP, TIndex *S, TIndex n,
+                             double Tol )
+{
+   TIndex i, j, g, ge, ne, lo, hi, mid, m;
+
+   clean_pt *vec = (clean_pt *) malloc( nP * sizeof(clean_pt) );
+   TIndex *Rep = new TIndex[nP];
+   check( (vec == NULL || Rep == NULL), "SegClean::SnapPoints(), insufficient memory" );
+
+   for ( i=0; i<nP; i++ )
+   {
+      vec[i].x = P[i]->x;
+      vec[i].y = P[i]->y;
+      vec[i].key = ( Tol > 0.0 ) ? floor( vec[i].x / Tol ) : vec[i].x;
+      vec[i].i = i;
+      Rep[i] = i;
+   }
+   qsort( vec, nP, sizeof(clean_pt), cmp_clean_pt );
+
+   for ( g=0; g<nP; g=ge )
+   {
+      // column [g,ge), next column [ge,ne) if adjacent
+
+      for ( ge=g+1; ge<nP && vec[ge].key == vec[g].key; ge++ );
+      ne = ge;
+      if ( Tol > 0.0 && ge < nP && vec[ge].key == vec[g].key + 1.0 )
+         for ( ne=ge+1; ne<nP && vec[ne].key == vec[ge].key; ne++ );
+
+      for ( i=g; i<ge; i++ )
+      {
+         for ( j=i+1; j<ge && vec[j].y - vec[i].y <= Tol; j++ )
+            if ( clean_close( P[vec[i].i], P[vec[j].i], Tol ) )
+               clean_join( Rep, vec[i].i, vec[j].i );
+
+         // first point of the next column with y >= y_i - Tol
+
+         lo = ge; hi = ne;
+         while ( lo < hi )
+         {
+            mid = ( lo + hi ) / 2;
+            if ( vec[mid].y < vec[i].y - Tol ) lo = mid + 1;
+            else hi = mid;
+         }
+         for ( j=lo; j<ne && vec[j].y - vec[i].y <= Tol; j++ )
+            if ( clean_close( P[vec[i].i], P[vec[j].i], Tol ) )
+               clean_join( Rep, vec[i].i, vec[j].i );
+      }
+   }
+   free( vec );
+
+   // renumber the representatives and delete the other points; each
+   // representative precedes its class, so it is renumbered first
+
+   for ( i=0; i<nP; i++ ) Rep[i] = clean_find( Rep, i );
+
+   m = 0;
+   for ( i=0; i<nP; i++ )
+   {
+      if ( Rep[i] == i )
+      {
+         P[m] = P[i];
+         P[m]->PID = m;
+         Rep[i] = m++;
+      }
+      else
+      {
+         delete P[i];
+         Rep[i] = Rep[Rep[i]];
+      }
+   }
+   for ( i=0; i<2*n; i++ ) S[i] = Rep[S[i]];
+   delete[] Rep;
+
+   i = nP - m;
+   nP = m;
+   return( i );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  TIndex SegClean::RemoveDegenerate( TIndex *S, TIndex &n )
+//
+
+TIndex SegClean::RemoveDegenerate( TIndex *S, TIndex &n )
+{
+   TIndex i, m = 0;
+
+   for ( i=0; i<n; i++ )
+      if ( S[2*i] != S[2*i+1] )
+      {
+         S[2*m]   = S[2*i];
+         S[2*m+1] = S[2*i+1];
+         m++;
+      }
+   i = n - m;
+   n = m;
+   return( i );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  void SegClean::FindOnSegment( PTPoint *P, TIndex nP, TIndex *S,
+//                                TIndex n, double Tol, TBuffer<TIndex> &Hits )
+//
+//  For each segment, the points in its x-interval (enlarged by Tol)
+//  are found by binary search on the points sorted on x. With Tol = 0,
+//  a point is inside a segment if it is aligned with its ends and
+//  strictly between them along the longer extent of the segment (both
+//  tests are exact).
+//
+
+static boolean clean_inside( PTPoint a, PTPoint b, PTPoint p, double Tol )
+{
+   double ax = a->x, ay = a->y, bx = b->x, by = b->y, px = p->x, py = p->y;
+   double dx = bx - ax, dy = by - ay, t;
+
+   if ( Tol == 0.0 )
+   {
+      if ( Geom::TurnExactxy( a, b, p ) != ALIGNED ) return( FALSE );
+      if ( fabs( dx ) >= fabs( dy ) )
+         return( px > MIN( ax, bx ) && px < MAX( ax, bx ) );
+      return( py > MIN( ay, by ) && py < MAX( ay, by ) );
+   }
+
+   t = ( (px - ax) * dx + (py - ay) * dy ) / ( dx*dx + dy*dy );
+   if ( t <= 0.0 || t >= 1.0 ) return( FALSE );
+   return( Geom::SegmentDistancexy( p, a, b ) <= Tol );
+}
+
+static void clean_scan_onseg( clean_sweep *W, TIndex s, TBuffer<TIndex> &Out )
+{
+   TIndex a = W->S[2*s], b = W->S[2*s+1], lo, hi, mid, j;
+   PTPoint pa = W->P[a], pb = W->P[b], p;
+   double ax = pa->x, ay = pa->y, bx = pb->x, by = pb->y;
+   double x0 = MIN( ax, bx ) - W->Tol, x1 = MAX( ax, bx ) + W->Tol;
+   double y0 = MIN( ay, by ) - W->Tol, y1 = MAX( ay, by ) + W->Tol;
+
+   lo = 0; hi = W->nPts;
+   while ( lo < hi )
+   {
+      mid = ( lo + hi ) / 2;
+      if ( W->Pts[mid].x < x0 ) lo = mid + 1;
+      else hi = mid;
+   }
+   for ( j=lo; j<W->nPts && W->Pts[j].x <= x1; j++ )
+   {
+      if ( W->Pts[j].y < y0 || W->Pts[j].y > y1 ) continue;
+      if ( W->Pts[j].i == a || W->Pts[j].i == b ) continue;
+      p = W->P[W->Pts[j].i];
+      if ( clean_inside( pa, pb, p, W->Tol ) )
+      {
+         Out.Add( s );
+         Out.Add( W->Pts[j].i );
+      }
+   }
+}
+
+void SegClean::FindOnSegment( PTPoint *P, TIndex nP, TIndex *S, TIndex n,
+                              double Tol, TBuffer<TIndex> &Hits )
+{
+   TIndex i;
+   clean_sweep W;
+
+   if ( n < 1 ) return;
+
+   clean_pt *vec = (clean_pt *) malloc( nP * sizeof(clean_pt) );
+   check( (vec == NULL), "SegClean::FindOnSegment(), insufficient memory" );
+   for ( i=0; i<nP; i++ )
+   {
+      vec[i].key = vec[i].x = P[i]->x;
+      vec[i].y = P[i]->y;
+      vec[i].i = i;
+   }
+   qsort( vec, nP, sizeof(clean_pt), cmp_clean_pt );
+
+   W.P = P;  W.S = S;  W.n = n;  W.Tol = Tol;
+   W.Pts = vec;  W.nPts = nP;  W.Segs = NULL;
+   W.Scan = clean_scan_onseg;
+   W.Thread = 0;  W.Out = &Hits;
+   clean_run( &W, Hits );
+
+   free( vec );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  void SegClean::FindCrossings( PTPoint *P, TIndex *S, TIndex n,
+//                                TBuffer<TIndex> &Cross )
+//
+//  Segments are sorted on their left end; the segments whose x-interval
+//  overlaps the one of the i-th segment and that follow it are the ones
+//  after it, up to the first one starting to the right of its right
+//  end. Segments sharing an end cannot cross properly; touching and
+//  overlapping segments have an end inside the other one, and are
+//  found by FindOnSegment().
+//
+
+static void clean_scan_cross( clean_sweep *W, TIndex i, TBuffer<TIndex> &Out )
+{
+   clean_seg *si = &W->Segs[i], *sj;
+   TIndex a = W->S[2*si->s], b = W->S[2*si->s+1], c, d, j;
+   PTPoint pa = W->P[a], pb = W->P[b], pc, pd;
+
+   for ( j=i+1; j<W->n && W->Segs[j].x0 <= si->x1; j++ )
+   {
+      sj = &W->Segs[j];
+      if ( sj->y0 > si->y1 || sj->y1 < si->y0 ) continue;
+      c = W->S[2*sj->s];  d = W->S[2*sj->s+1];
+      if ( c == a || c == b || d == a || d == b ) continue;
+      pc = W->P[c];  pd = W->P[d];
+      if ( Geom::TurnExactxy( pa, pb, pc ) * Geom::TurnExactxy( pa, pb, pd ) < 0 &&
+           Geom::TurnExactxy( pc, pd, pa ) * Geom::TurnExactxy( pc, pd, pb ) < 0 )
+      {
+         Out.Add( MIN( si->s, sj->s ) );
+         Out.Add( MAX( si->s, sj->s ) );
+      }
+   }
+}
+
+void SegClean::FindCrossings( PTPoint *P, TIndex *S, TIndex n,
+                              TBuffer<TIndex> &Cross )
+{
+   TIndex i;
+   clean_sweep W;
+
+   if ( n < 2 ) return;
+
+   clean_seg *vec = (clean_seg *) malloc( n * sizeof(clean_seg) );
+   check( (vec == NULL), "SegClean::FindCrossings(), insufficient memory" );
+   for ( i=0; i<n; i++ )
+   {
+      double ax = P[S[2*i]]->x, ay = P[S[2*i]]->y;
+      double bx = P[S[2*i+1]]->x, by = P[S[2*i+1]]->y;
+      vec[i].x0 = MIN( ax, bx );  vec[i].x1 = MAX( ax, bx );
+      vec[i].y0 = MIN( ay, by );  vec[i].y1 = MAX( ay, by );
+      vec[i].s = i;
+   }
+   qsort( vec, n, sizeof(clean_seg), cmp_clean_seg );
+
+   W.P = P;  W.S = S;  W.n = n;  W.Tol = 0.0;
+   W.Pts = NULL;  W.nPts = 0;  W.Segs = vec;
+   W.Scan = clean_scan_cross;
+   W.Thread = 0;  W.Out = &Cross;
+   clean_run( &W, Cross );
+
+   free( vec );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  void SegClean::Split( PTPoint *P, TIndex *&S, TIndex &n,
+//                        TBuffer<TIndex> &Hits )
+//
+//  The split points of each segment are sorted along it, from its
+//  first end, and the segment is replaced by the chain through them.
+//
+
+void SegClean::Split( PTPoint *P, TIndex *&S, TIndex &n, TBuffer<TIndex> &Hits )
+{
+   TIndex i, k, h, m, prev, nh = Hits.Count() / 2;
+   PTPoint a, b, p;
+   double dx, dy;
+
+   if ( nh == 0 ) return;
+
+   clean_hit *vec = (clean_hit *) malloc( nh * sizeof(clean_hit) );
+   TIndex *NewS = new TIndex[2*(n+nh)];
+   check( (vec == NULL || NewS == NULL), "SegClean::Split(), insufficient memory" );
+
+   for ( h=0; h<nh; h++ )
+   {
+      vec[h].s = Hits[2*h];
+      vec[h].p = Hits[2*h+1];
+      a = P[S[2*vec[h].s]];  b = P[S[2*vec[h].s+1]];  p = P[vec[h].p];
+      dx = b->x - a->x;  dy = b->y - a->y;
+      vec[h].t = ( (p->x - a->x) * dx + (p->y - a->y) * dy ) / ( dx*dx + dy*dy );
+   }
+   qsort( vec, nh, sizeof(clean_hit), cmp_clean_hit );
+
+   m = 0;
+   h = 0;
+   for ( i=0; i<n; i++ )
+   {
+      prev = S[2*i];
+      for ( ; h<nh && vec[h].s == i; h++ )
+      {
+         k = vec[h].p;
+         if ( k == prev ) continue;
+         NewS[2*m] = prev;  NewS[2*m+1] = k;  m++;
+         prev = k;
+      }
+      NewS[2*m] = prev;  NewS[2*m+1] = S[2*i+1];  m++;
+   }
+   free( vec );
+
+   delete[] S;
+   S = NewS;
+   n = m;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  TIndex SegClean::Clean( PTPoint *&P, TIndex &nP, TIndex *&S, TIndex n,
+//                          double Tol, RTSegCleanStats St )
+//
+//  Each pass snaps the points, removes degenerate and repeated segments,
+//  then splits the segments both at the points found inside them and at
+//  new points at their crossings (a crossing through a point inside both
+//  segments is split at that point). Splitting may create new
+//  near-coincident points and new crossings (the crossing points are
+//  rounded), so the passes go on until nothing is found; only at the
+//  last pass, the segments still with a point inside or a crossing are
+//  removed instead.
+//
+
+static boolean clean_share_hit( TBuffer<TIndex> &Hits, TIndex nh, TIndex s1, TIndex s2 )
+{
+   TIndex lo = 0, hi = nh, mid, e[2];
+
+   // Hits is sorted: first hit of s1, then the points of s1 searched
+   // among the hits of s2
+
+   while ( lo < hi )
+   {
+      mid = ( lo + hi ) / 2;
+      if ( Hits[2*mid] < s1 ) lo = mid + 1;
+      else hi = mid;
+   }
+   for ( ; lo<nh && Hits[2*lo] == s1; lo++ )
+   {
+      e[0] = s2;  e[1] = Hits[2*lo+1];
+      if ( bsearch( e, &Hits[0], nh, 2*sizeof(TIndex), cmp_clean_pair ) != NULL )
+         return( TRUE );
+   }
+   return( FALSE );
+}
+
+TIndex SegClean::Clean( PTPoint *&P, TIndex &nP, TIndex *&S, TIndex n,
+                        double Tol, RTSegCleanStats St )
+{
+   TIndex i, k, m, nc, nh, s1, s2;
+   TBuffer<TIndex> Hits, Cross;
+   PTPoint *NewP;
+   double ax, ay, bx, by, cx, cy, dx, dy, den, t, x, y;
+
+   check( (Tol < 0.0), "SegClean::Clean(), negative tolerance" );
+
+   // segments with non-existing points
+
+   m = 0;
+   for ( i=0; i<n; i++ )
+      if ( S[2*i] >= 0 && S[2*i] < nP && S[2*i+1] >= 0 && S[2*i+1] < nP )
+      {
+         S[2*m]   = S[2*i];
+         S[2*m+1] = S[2*i+1];
+         m++;
+      }
+   St.nInvalid += n - m;
+   n = m;
+
+   for ( St.nPasses=1; ; St.nPasses++ )
+   {
+      St.nSnapped += SnapPoints( P, nP, S, n, Tol );
+      St.nDegenerate += RemoveDegenerate( S, n );
+      m = Reorder::SortSegments( S, n, P, REORDER_NONE );
+      St.nRepeated += n - m;
+      n = m;
+
+      Hits.Clear();
+      Cross.Clear();
+      FindOnSegment( P, nP, S, n, Tol, Hits );
+      FindCrossings( P, S, n, Cross );
+      if ( Hits.IsEmpty() && Cross.IsEmpty() ) break;
+
+      if ( St.nPasses == CLEAN_PASSES )
+      {
+         // remove the segments with a point inside, and the second
+         // segment of each crossing pair
+
+         char *Drop = new char[n];
+         check( (Drop == NULL), "SegClean::Clean(), insufficient memory" );
+         for ( i=0; i<n; i++ ) Drop[i] = 0;
+         for ( i=0; i<Hits.Count(); i+=2 ) Drop[Hits[i]] = 1;
+         for ( i=1; i<Cross.Count(); i+=2 ) Drop[Cross[i]] = 1;
+         m = 0;
+         for ( i=0; i<n; i++ )
+            if ( !Drop[i] )
+            {
+               S[2*m]   = S[2*i];
+               S[2*m+1] = S[2*i+1];
+               m++;
+            }
+         delete[] Drop;
+         St.nDropped += n - m;
+         n = m;
+         break;
+      }
+
+      nh = Hits.Count() / 2;
+      St.nOnSegment += nh;
+      if ( nh > 0 ) qsort( &Hits[0], nh, 2*sizeof(TIndex), cmp_clean_pair );
+
+      // a new point at each crossing, numbered in the order of the
+      // pairs of segments, unless both segments are split at a point
+      // inside them, which is then their crossing
+
+      nc = 0;
+      for ( k=0; k<Cross.Count()/2; k++ )
+         if ( !clean_share_hit( Hits, nh, Cross[2*k], Cross[2*k+1] ) )
+         {
+            Cross[2*nc]   = Cross[2*k];
+            Cross[2*nc+1] = Cross[2*k+1];
+            nc++;
+         }
+      if ( nc > 0 )
+      {
+         qsort( &Cross[0], nc, 2*sizeof(TIndex), cmp_clean_pair );
+
+         NewP = new PTPoint[nP + nc];
+         check( (NewP == NULL), "SegClean::Clean(), insufficient memory" );
+         for ( i=0; i<nP; i++ ) NewP[i] = P[i];
+         delete[] P;
+         P = NewP;
+
+         for ( k=0; k<nc; k++ )
+         {
+            s1 = Cross[2*k];  s2 = Cross[2*k+1];
+            ax = P[S[2*s1]]->x;  ay = P[S[2*s1]]->y;
+            bx = P[S[2*s1+1]]->x;  by = P[S[2*s1+1]]->y;
+            cx = P[S[2*s2]]->x;  cy = P[S[2*s2]]->y;
+            dx = P[S[2*s2+1]]->x;  dy = P[S[2*s2+1]]->y;
+            den = ( bx - ax ) * ( dy - cy ) - ( by - ay ) * ( dx - cx );
+            t = ( ( cx - ax ) * ( dy - cy ) - ( cy - ay ) * ( dx - cx ) ) / den;
+
+            // With Tol > 0, the point is rounded on the grid of step Tol
+            // (snap rounding): the split segments bend by about Tol,
+            // instead of leaving a point almost on the line of two
+            // others, which the triangulator cannot resolve. Otherwise,
+            // the point is just kept in the bounding boxes of both
+            // segments.
+
+            x = ax + t * ( bx - ax );
+            y = ay + t * ( by - ay );
+            if ( Tol > 0.0 )
+            {
+               x = Tol * floor( x / Tol + 0.5 );
+               y = Tol * floor( y / Tol + 0.5 );
+            }
+            else
+            {
+               x = MAX( x, MAX( MIN( ax, bx ), MIN( cx, dx ) ) );
+               x = MIN( x, MIN( MAX( ax, bx ), MAX( cx, dx ) ) );
+               y = MAX( y, MAX( MIN( ay, by ), MIN( cy, dy ) ) );
+               y = MIN( y, MIN( MAX( ay, by ), MAX( cy, dy ) ) );
+            }
+
+            P[nP] = new TPoint( x, y, P[S[2*s1]]->z + t * ( P[S[2*s1+1]]->z - P[S[2*s1]]->z ) );
+            check( (P[nP] == NULL), "SegClean::Clean(), insufficient memory" );
+            P[nP]->PID = nP;
+            Hits.Add( s1 );  Hits.Add( nP );
+            Hits.Add( s2 );  Hits.Add( nP );
+            nP++;
+         }
+         St.nCrossings += nc;
+      }
+
+      Split( P, S, n, Hits );
+   }
+
+   return( n );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//  TIndex SegClean::CheckConstraints( TIndex nP, TIndex *T, TIndex nT,
+//                                     TIndex *S, TIndex n, RTSegCleanStats St )
+//
+//  The edges of the triangles are sorted (as pairs of indices, the
+//  smaller first) and each constraint is searched among them.
+//
+
+TIndex SegClean::CheckConstraints( TIndex nP, TIndex *T, TIndex nT,
+                                   TIndex *S, TIndex n, RTSegCleanStats St )
+{
+   TIndex i, j, m, e[2];
+
+   for ( i=0; i<3*nT; i++ )
+      check( (T[i] < 0 || T[i] >= nP), "SegClean::CheckConstraints(), triangle with non-existing vertices" );
+
+   TIndex *E = new TIndex[6*nT];
+   check( (E == NULL), "SegClean::CheckConstraints(), insufficient memory" );
+   for ( i=0; i<nT; i++ )
+      for ( j=0; j<3; j++ )
+      {
+         E[6*i+2*j]   = MIN( T[3*i+j], T[3*i+(j+1)%3] );
+         E[6*i+2*j+1] = MAX( T[3*i+j], T[3*i+(j+1)%3] );
+      }
+   qsort( E, 3*nT, 2*sizeof(TIndex), cmp_clean_pair );
+
+   m = 0;
+   for ( i=0; i<n; i++ )
+   {
+      if ( S[2*i] < 0 || S[2*i] >= nP || S[2*i+1] < 0 || S[2*i+1] >= nP )
+      {
+         cerr << "constraint C" << i << " ( " << S[2*i] << ", " << S[2*i+1]
+              << " ) has non-existing vertices: removed" << endl;
+         St.nInvalid++;
+         continue;
+      }
+      if ( S[2*i] == S[2*i+1] )
+      {
+         cerr << "constraint C" << i << " ( " << S[2*i] << ", " << S[2*i+1]
+              << " ) is degenerate: removed" << endl;
+         St.nDegenerate++;
+         continue;
+      }
+      e[0] = MIN( S[2*i], S[2*i+1] );
+      e[1] = MAX( S[2*i], S[2*i+1] );
+      if ( bsearch( e, E, 3*nT, 2*sizeof(TIndex), cmp_clean_pair ) == NULL )
+      {
+         cerr << "constraint C" << i << " ( " << S[2*i] << ", " << S[2*i+1]
+              << " ) is not an edge of the triangulation: removed" << endl;
+         St.nDropped++;
+         continue;
+      }
+      S[2*m]   = S[2*i];
+      S[2*m+1] = S[2*i+1];
+      m++;
+   }
+   delete[] E;
+
+   n = Reorder::SortSegments( S, m, NULL, REORDER_NONE );
+   St.nRepeated += m - n;
+   St.nPasses = 1;
+   return( n );
+}
@@ -0,0 +1,148 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : segclean.h
+//
+//   Definition of a class collecting static functions for cleaning a
+//   set of segments (e.g., the constraints read from a .seg file)
+//   before a CDT is built on them, so that every segment left is
+//   admissible: no point lies inside a segment and no two segments
+//   cross.
+//   Points closer than a tolerance are snapped together, degenerate
+//   and repeated segments are removed, segments are split at the points
+//   lying on them and at their proper crossings. Candidate pairs are
+//   found by a sweep along x (sort on the left end, scan the active
+//   x-interval), and are classified exactly with Geom::TurnExactxy().
+//   If macro PARALLEL_CLEAN is defined in defs.h, the sweeps are shared
+//   among CLEAN_THREADS threads.
+//
+
+
+#ifndef _SEGCLEAN_H
+#define _SEGCLEAN_H
+
+#include <iostream>
+
+#include "defs.h"
+#include "ttriang.h"
+#include "tbuffer.h"
+
+
+// Max number of passes (snap, split) before the segments still
+// crossing are dropped.
+#define CLEAN_PASSES  8
+
+
+// ----------------------------------------------------------------------
+//
+//  class TSegCleanStats
+//
+//  What was done by SegClean::Clean().
+//
+
+class TSegCleanStats
+{
+   public:
+
+      TIndex nInvalid;     // segments with non-existing points, removed
+      TIndex nSnapped;     // points snapped on another one
+      TIndex nDegenerate;  // segments with coincident ends, removed
+      TIndex nRepeated;    // repeated segments, removed
+      TIndex nOnSegment;   // splits at points lying inside a segment
+      TIndex nCrossings;   // proper crossings, split at a new point
+      TIndex nDropped;     // segments still crossing after CLEAN_PASSES
+      int nPasses;
+
+      TSegCleanStats() : nInvalid(0), nSnapped(0), nDegenerate(0),
+                         nRepeated(0), nOnSegment(0), nCrossings(0),
+                         nDropped(0), nPasses(0) {};
+
+      void Print( ostream & );
+};
+
+typedef class TSegCleanStats &RTSegCleanStats;
+
+
+// ----------------------------------------------------------------------
+//
+//  class SegClean
+//
+
+
+class SegClean
+{
+   private:
+
+      // The default constructor is private. This makes it impossible
+      // to create instances of this class.
+      SegClean() { error("private constructor SegClean::SegClean() called" ); };
+
+      // Snap the nP points of P closer than Tol (exactly coincident in
+      // x and y, if Tol is 0) on the one of smallest index, delete the
+      // others and renumber P and the n segments of S. Return the
+      // number of points deleted.
+      static TIndex SnapPoints( PTPoint *P, TIndex &nP, TIndex *S, TIndex n,
+                                double Tol );
+
+      // Remove the segments of S with coincident ends; return their
+      // number.
+      static TIndex RemoveDegenerate( TIndex *S, TIndex &n );
+
+      // Find the points of P lying inside a segment of S (within Tol)
+      // and the proper crossings of two segments of S. Each one is added
+      // to Hits (pairs: segment, point) or to Cross (pairs of segments,
+      // the smaller index first).
+      static void FindOnSegment( PTPoint *P, TIndex nP, TIndex *S, TIndex n,
+                                 double Tol, TBuffer<TIndex> &Hits );
+      static void FindCrossings( PTPoint *P, TIndex *S, TIndex n,
+                                 TBuffer<TIndex> &Cross );
+
+      // Split the segments of S at the points of Hits; S is replaced
+      // by a new array. Hits is sorted.
+      static void Split( PTPoint *P, TIndex *&S, TIndex &n,
+                         TBuffer<TIndex> &Hits );
+
+   public:
+
+      // The n segments of array S are pairs of indices in array P, of
+      // nP points. Clean them as described above, with snapping
+      // tolerance Tol (0 = only coincident points). Points may be
+      // deleted (the snapped ones) and added (at the crossings, rounded
+      // on the grid of step Tol if Tol > 0, with z interpolated on the
+      // first segment): P and S are replaced by new arrays, nP is
+      // updated, and the PID of each point is set to its index. Return
+      // the number of segments in S.
+      static TIndex Clean( PTPoint *&P, TIndex &nP, TIndex *&S, TIndex n,
+                           double Tol, RTSegCleanStats St );
+
+      // Check the n constraints in array S, pairs of indices in the
+      // triangles of array T (nT triples of indices of nP points): keep
+      // only those with existing, distinct ends, not repeated, which
+      // are edges of a triangle. Each constraint removed is reported
+      // on cerr. Return the number of constraints left in S.
+      static TIndex CheckConstraints( TIndex nP, TIndex *T, TIndex nT,
+                                      TIndex *S, TIndex n, RTSegCleanStats St );
+};
+
+#endif // _SEGCLEAN_H
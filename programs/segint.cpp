@@ -0,0 +1,158 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+// ----------------------------------------------------------------------
+//
+//   file   : segint.cpp
+//
+//   Implementation of class SegInt, static functions for classifying
+//   the intersection of two edges.
+//
+
+#include "defs.h"
+#include "error.h"
+#include "geom.h"
+#include "ttriang.h"
+#include "segint.h"
+
+
+// ----------------------------------------------------------------------
+//
+//  int SegInt::Classify( PTSegment s1, PTEdge e2 )
+//
+//  Return values: see #define's in segint.h
+//
+
+int SegInt::Classify( PTSegment s1, PTEdge e2 )
+{
+   double ax = s1->EV[0]->x, bx = s1->EV[1]->x;
+   double ay = s1->EV[0]->y, by = s1->EV[1]->y;
+
+   return( Classify( s1, MIN( ax, bx ), MAX( ax, bx ),
+                         MIN( ay, by ), MAX( ay, by ), e2 ) );
+}
+
+
+int SegInt::Classify( PTEdge e1, PTEdge e2 )
+{
+   TSegment S( e1 );
+
+   return( Classify( &S, e2 ) );
+}
+
+
+int SegInt::Classify( PTSegment S, PTEdge *E, int n, int *Res )
+{
+   double ax = S->EV[0]->x, bx = S->EV[1]->x;
+   double ay = S->EV[0]->y, by = S->EV[1]->y;
+   double x0 = MIN( ax, bx ), x1 = MAX( ax, bx );
+   double y0 = MIN( ay, by ), y1 = MAX( ay, by );
+   int i, k = 0;
+
+   for( i=0; i<n; i++ )
+   {
+      Res[i] = Classify( S, x0, x1, y0, y1, E[i] );
+      if ( Res[i] != NO_INTER ) k++;
+   }
+   return( k );
+}
+
+
+int SegInt::Classify( PTEdge S, PTEdge *E, int n, int *Res )
+{
+   TSegment S1( S );
+
+   return( Classify( &S1, E, n, Res ) );
+}
+
+
+int SegInt::Classify( PTSegment s1, double x0, double x1,
+                      double y0, double y1, PTEdge e2 )
+{
+   PTVertex a = s1->EV[0], b = s1->EV[1];
+   PTVertex c = e2->EV[0], d = e2->EV[1];
+
+   // coincident edges (both vertices in common)
+   if ( ( a == c && b == d ) || ( a == d && b == c ) )
+      return UPON_AND_2CV;
+
+   //
+   // early reject: disjoint bounding boxes (this also covers collinear
+   // edges which do not overlap)
+   //
+
+   double cx = c->x, dx = d->x;
+   double cy = c->y, dy = d->y;
+
+   if ( MAX( cx, dx ) < x0 || MIN( cx, dx ) > x1 ||
+        MAX( cy, dy ) < y0 || MIN( cy, dy ) > y1 )
+      return NO_INTER;
+
+   int turn_e1_c = Geom::TurnExactxy( a, b, c );  // turn from e1 to c
+   int turn_e1_d = Geom::TurnExactxy( a, b, d );  // turn from e1 to d
+
+   //
+   // e1 and e2 are collinear, and their bounding boxes overlap:
+   // compare them on the y axis if e1 is vertical, on the x axis
+   // otherwise
+   //
+
+   if ( turn_e1_c == ALIGNED && turn_e1_d == ALIGNED )
+   {
+      double min1, max1, min2, max2;
+
+      if ( x0 == x1 )
+      {
+         min1 = y0;  max1 = y1;
+         min2 = MIN( cy, dy );  max2 = MAX( cy, dy );
+      }
+      else
+      {
+         min1 = x0;  max1 = x1;
+         min2 = MIN( cx, dx );  max2 = MAX( cx, dx );
+      }
+
+      if ( max1 == min2 || max2 == min1 )  return ONLY_1CV;
+      if ( min1 == min2 || max1 == max2 )  return UPON_AND_1CV;
+      return UPON_NO_CV;
+   }
+
+   //
+   // e1 and e2 are NOT collinear
+   //
+
+   // just one common vertex
+   if ( a == c || b == d || a == d || b == c )  return ONLY_1CV;
+
+   int turn_e2_a = Geom::TurnExactxy( c, d, a );  // turn from e2 to a
+   int turn_e2_b = Geom::TurnExactxy( c, d, b );  // turn from e2 to b
+
+   // a vertex of one edge is inside the other edge
+   if ( ( turn_e1_c == ALIGNED || turn_e1_d == ALIGNED ) && turn_e2_a != turn_e2_b )
+      return NOT_PROPER;
+   if ( ( turn_e2_a == ALIGNED || turn_e2_b == ALIGNED ) && turn_e1_c != turn_e1_d )
+      return NOT_PROPER;
+
+   // either the interiors of e1 and e2 intersect, or nothing does
+   if ( turn_e1_c != turn_e1_d && turn_e2_a != turn_e2_b )
+      return PROPER_INTER;
+   return NO_INTER;
+}
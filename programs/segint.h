@@ -0,0 +1,89 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+// ----------------------------------------------------------------------
+//
+//   file   : segint.h
+//
+//   Definition of a class collecting static functions for classifying
+//   the intersection of two edges (segments) in the plane, used by the
+//   insertion and the check of constraints in a CDT.
+//   The classification rests on Geom::TurnExactxy() and is therefore
+//   exact; edges whose bounding boxes are disjoint are rejected before
+//   computing any orientation. A batched version classifies one edge
+//   against an array of edges (e.g., the three edges of a triangle).
+//   The first edge may also be a TSegment, so that the probes of the
+//   queries need not be edges of the triangulation.
+//
+
+
+#ifndef _SEGINT_H
+#define _SEGINT_H
+
+#include "defs.h"
+#include "ttriang.h"
+
+
+// Result of the classification of two edges
+
+#define NO_INTER      0   /* no intersection */
+#define ONLY_1CV      1   /* intersection just in a vertex */
+#define NOT_PROPER    2   /* a vertex of one falls inside the other one */
+#define PROPER_INTER  3   /* proper intersection */
+#define UPON_NO_CV    4   /* partially coincident without common vertices */
+#define UPON_AND_1CV  5   /* partially coincident with one common vertex */
+#define UPON_AND_2CV  6   /* coincident edges */
+
+
+// ----------------------------------------------------------------------
+//
+//  class SegInt
+//
+
+
+class SegInt
+{
+   private:
+
+      // The default constructor is private. This makes it impossible
+      // to create instances of this class.
+      SegInt() { error("private constructor SegInt::SegInt() called" ); };
+
+      // Classify edge e2 against segment s1, of bounding box
+      // [x0,x1] x [y0,y1].
+      static int Classify( PTSegment s1, double x0, double x1,
+                           double y0, double y1, PTEdge e2 );
+
+   public:
+
+      // Classify the intersection of two non-degenerate edges (one
+      // of the values above).
+      static int Classify( PTSegment s1, PTEdge e2 );
+      static int Classify( PTEdge e1, PTEdge e2 );
+
+      // Classify each of the n edges of array E against edge S, and
+      // put the results in array Res. Return the number of edges of E
+      // which intersect S (i.e., whose result is not NO_INTER).
+      static int Classify( PTSegment S, PTEdge *E, int n, int *Res );
+      static int Classify( PTEdge S, PTEdge *E, int n, int *Res );
+};
+
+#endif // _SEGINT_H
@@ -1,16 +1,28 @@
 
+#include <stdlib.h>
+#include <limits.h>
+
+#include "error.h"
 #include "stepbystep.h"
 #include "ttriangulation.h"
 
-StepByStep::StepByStep(TTriangulation* triangulation)
+StepByStep::StepByStep(TTriangulation* triangulation, PMTTracer mt)
 {
    this->triangulation = triangulation;
+   log = NULL;
+   if (mt)
+   {
+      log = new TUpdateLog();
+      check( (log == NULL), "StepByStep::StepByStep(), insufficient memory" );
+      mt->SetUpdateLog(log);
+   }
 }
 
 
 StepByStep::~StepByStep()
 {
    //triangulation = 0;
+   if (log) delete log;
 }
 
 
@@ -25,35 +37,77 @@ void StepByStep::WriteData( const char *ch )
     triangulation->WriteData(ch);
 }
 
+#ifdef LARGE_INDEX
+
+// Replace the int array of the viewer with the n indices in Idx,
+// which is freed.
+static void NarrowIndices( TIndex *Idx, TIndex n, int **Data )
+{
+    if (*Data) free(*Data);
+    *Data = NULL;
+    if (Idx == NULL) return;
+    *Data = (int *) malloc( n * sizeof(int) );
+    check( (*Data == NULL), "StepByStep::ConvertData(), insufficient memory" );
+    for (TIndex i=0; i<n; i++) (*Data)[i] = (int)Idx[i];
+    free(Idx);
+}
+
+#endif // LARGE_INDEX
+
+// With LARGE_INDEX, the indices are converted in arrays of type TIndex
+// and narrowed to the int arrays of the viewer.
 void StepByStep::ConvertData(unsigned int *vNum, unsigned int *tNum,
                              unsigned int *eNum,
                              float **vData, int **tData, int **eData)
 {
-    int vv, tt, ee;
-    triangulation->ConvertData(&vv,&tt,&ee,vData,tData,eData);
-    *vNum = vv; *tNum = tt; *eNum = ee;
+    TIndex vv, tt, ee;
+#ifdef LARGE_INDEX
+    TIndex *tIdx = NULL, *eIdx = NULL;
+#else
+    TIndex *&tIdx = *tData, *&eIdx = *eData;
+#endif
+    if (log && !log->AtHead())
+       log->ConvertData(&vv,&tt,&ee,vData,&tIdx,&eIdx);
+    else
+       triangulation->ConvertData(&vv,&tt,&ee,vData,&tIdx,&eIdx);
+#ifdef LARGE_INDEX
+    check( (vv > INT_MAX), "StepByStep::ConvertData(), too many vertices for the viewer" );
+    NarrowIndices( tIdx, 3 * tt, tData );
+    NarrowIndices( eIdx, 2 * ee, eData );
+#endif
+    *vNum = (unsigned int)vv; *tNum = (unsigned int)tt; *eNum = (unsigned int)ee;
 }
 
 void StepByStep::InitialTriangulation()
 {
     triangulation->InitialTriangulation();
+    if (log) log->EndUpdate();
 }
 
 
 boolean StepByStep::NoMoreUpdates()
 {
+   if (log && !log->AtHead()) return FALSE;
    return  triangulation->NoMoreUpdates();
 }
 
 
 void StepByStep::UpdateStep()
 {
+    if (log && log->StepForward()) return;
     triangulation->UpdateStep();
     if (triangulation->NoMoreUpdates()) triangulation->PrepareToEnd();
+    if (log) log->EndUpdate();
 }
 
 
 
+boolean StepByStep::StepBack()
+{
+    return( log != NULL && log->StepBack() );
+}
+
+
 void StepByStep::EndTriangulation()
 {
     triangulation->EndTriangulation();
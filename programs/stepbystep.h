@@ -5,6 +5,8 @@
 
 #include "defs.h" // necessary for type 'boolean'
 #include "ttriangulation.h"
+#include "mttracer.h"
+#include "updlog.h"
 
 class TTriangulation;
 
@@ -15,16 +17,23 @@ class TTriangulation;
 // These are the methods which allow a step by step execution from
 // an application outside this library.
 //
+// If the MTTracer of the triangulation is given, the updates are also
+// recorded (see class TUpdateLog), and it is possible to step back
+// and forward again; going forward beyond the last update executed
+// so far performs a new update.
+//
 
 
 class StepByStep
 {
    public:
 
-      StepByStep(TTriangulation* triangulation);
+      StepByStep(TTriangulation* triangulation, PMTTracer mt = NULL);
       ~StepByStep();
 
       void ReadData( const char * );
+      // It writes the triangulation after the last update executed,
+      // even after stepping back.
       void WriteData( const char * );
       void ConvertData(unsigned int *vNum, unsigned int *tNum, unsigned int *eNum,
                        float **vData, int **tData, int **eData);
@@ -54,6 +63,14 @@ class StepByStep
       */
       void UpdateStep();
 
+      //! Undo the last update of the displayed triangulation.
+      /*! Return FALSE if the updates are not recorded, or if the
+          initial triangulation is displayed. The algorithm is not
+          affected: UpdateStep() redoes the undone updates, then
+          continues with new ones.
+      */
+      boolean StepBack();
+
       //
       // This function performs work needed after the end of the
       // construction of the triangulation. By default, nothing.
@@ -64,6 +81,8 @@ class StepByStep
     protected:
 
       TTriangulation* triangulation;
+
+      PTUpdateLog log;   // NULL if updates are not recorded
 };
 
 
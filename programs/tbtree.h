@@ -37,8 +37,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "defs.h"
 #include "error.h"
 #include "ttriang.h"
-
-int compare( double a , double b );
+#include "tdoublelist.h"
 
 template <class T> class TBTreeNode;
 template <class T> class TBTree;
@@ -127,6 +126,8 @@ template <class T> class TBTree
       
       boolean RemoveMinRec( TBTreeNode<T>* &, T & );
       boolean RemoveMaxRec( TBTreeNode<T>* &, T & );
+
+      void GetSortedRec( TBTreeNode<T> *, TDoubleList<T> & );
       
             
    public:
@@ -158,6 +159,9 @@ template <class T> class TBTree
      
       void ClearTree();
 
+      // Append all elements to list L, in increasing order.
+      void GetSorted( TDoubleList<T> &L ) { GetSortedRec( root, L ); };
+
       friend class TBTreeIterator<T>;
       
       friend int compare( T, T );
@@ -1046,6 +1050,24 @@ void TBTree<T>::ClearTree()
 }
 
 
+// ----------------------------------------------------------------------------
+//
+//  void TBTree<T>::GetSortedRec( TBTreeNode<T> *Node, TDoubleList<T> &L )
+//
+//  Append the elements of the subtree rooted at Node to list L, by an
+//  in-order visit.
+//
+
+template <class T>  inline
+void TBTree<T>::GetSortedRec( TBTreeNode<T> *Node, TDoubleList<T> &L )
+{
+   if ( Node == NULL ) return;
+   GetSortedRec( Node->left, L );
+   L.AddTail( Node->object );
+   GetSortedRec( Node->right, L );
+}
+
+
 
 // ---------------------------------------------------------------------------------
 //
@@ -0,0 +1,107 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+// ---------------------------------------------------------------------------------
+//
+//   file   : tbuffer.h
+//
+//   Implementation of a class for a growable array of elements of type
+//   T (template), meant to be emptied and filled again many times.
+//   Emptying it does not free memory, so that once the buffer has
+//   reached its working size no more allocations take place.
+//
+
+
+#ifndef _TBUFFER_H
+#define _TBUFFER_H
+
+#include "defs.h"
+#include "error.h"
+
+
+// ---------------------------------------------------------------------------------
+//
+//   class TBuffer<T>
+//
+
+
+template <class T> class TBuffer
+{
+    private:
+
+       T *Item;
+       TIndex nItem, MaxItem;
+
+       // Not copyable.
+       TBuffer( const TBuffer<T> & );
+       void operator=( const TBuffer<T> & );
+
+    public:
+
+       TBuffer() : Item(NULL), nItem(0), MaxItem(0) {};
+       ~TBuffer() { if ( Item != NULL ) delete[] Item; };
+
+       TIndex Count() { return( nItem ); };
+       boolean IsEmpty() { return( nItem == 0 ); };
+
+       T& operator[]( TIndex i ) { return( Item[i] ); };
+
+       // Append an element at the end of the buffer.
+       void Add( T object )
+       {
+          if ( nItem == MaxItem ) Grow();
+          Item[nItem++] = object;
+       };
+
+       // Remove the i-th element, by moving the last one in its place.
+       void Remove( TIndex i ) { Item[i] = Item[--nItem]; };
+
+       // Remove the last occurrence of object, if present; return TRUE
+       // if it was found. The search starts from the end, where recently
+       // added elements are.
+       boolean RemoveObject( T object )
+       {
+          TIndex i = nItem;
+          while ( i > 0 )
+             if ( Item[--i] == object ) { Remove( i ); return( TRUE ); }
+          return( FALSE );
+       };
+
+       // Empty the buffer, keeping its memory.
+       void Clear() { nItem = 0; };
+
+    private:
+
+       void Grow()
+       {
+          TIndex i;
+          TIndex NewMax = ( MaxItem == 0 ? 64 : 2*MaxItem );
+          T *NewItem = new T[ NewMax ];
+          check( (NewItem == NULL), "TBuffer<T>::Grow(), insufficient memory" );
+          for( i=0; i<nItem; i++ ) NewItem[i] = Item[i];
+          if ( Item != NULL ) delete[] Item;
+          Item = NewItem;
+          MaxItem = NewMax;
+       };
+};
+
+#endif // _TBUFFER_H
@@ -34,9 +34,115 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "geom.h"
 #include "ttriang.h"
 
-int TVertex::NextVID = 0;
-int TEdge::NextEID = 0;
-int TTriangle::NextTID = 0;
+TIndex TVertex::NextVID = 0;
+TIdPool TEdge::EIDs;
+TIdPool TTriangle::TIDs;
+
+#ifdef COMPACT_COORDS
+double TQuantFrame::Origin[3] = { 0.0, 0.0, 0.0 };
+boolean TQuantFrame::Fixed = FALSE;
+
+
+// -----------------------------------------------------------------------------
+//
+//  void TQuantFrame::Fix( double x, double y, double z )
+//
+
+void TQuantFrame::Fix( double x, double y, double z )
+{
+   if ( Fixed ) return;
+   Origin[0] = floor( x / QUANT_STEP + 0.5 ) * QUANT_STEP;
+   Origin[1] = floor( y / QUANT_STEP + 0.5 ) * QUANT_STEP;
+   Origin[2] = floor( z / QUANT_STEP + 0.5 ) * QUANT_STEP;
+   Fixed = TRUE;
+}
+#endif
+
+
+// -----------------------------------------------------------------------------
+//
+//  TIndex TIdPool::Get()
+//  void TIdPool::Release( TIndex id )
+//
+
+TIndex TIdPool::Get()
+{
+   TIndex id;
+
+   if ( Shared ) pthread_mutex_lock( &Lock );
+   id = ( nFree > 0 ? Free[--nFree] : Next++ );
+   if ( Shared ) pthread_mutex_unlock( &Lock );
+   return( id );
+}
+
+
+void TIdPool::Release( TIndex id )
+{
+   if ( Shared ) pthread_mutex_lock( &Lock );
+   Push( id );
+   if ( Shared ) pthread_mutex_unlock( &Lock );
+}
+
+
+// -----------------------------------------------------------------------------
+//
+//  void TIdPool::Push( TIndex id )
+//
+//  Push id on the stack of free identifiers, doubling its capacity
+//  if needed.
+//
+
+void TIdPool::Push( TIndex id )
+{
+   if ( nFree == MaxFree )
+   {
+      TIndex i;
+      TIndex NewMax = ( MaxFree > 0 ? 2*MaxFree : 1024 );
+      TIndex *NewFree = new TIndex[ NewMax ];
+      check( (NewFree == NULL), "TIdPool::Push(), insufficient memory" );
+
+      for ( i=0; i<nFree; i++ ) NewFree[i] = Free[i];
+      if ( Free != NULL ) delete[] Free;
+
+      Free = NewFree;
+      MaxFree = NewMax;
+   }
+   Free[nFree++] = id;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+//  void TIdPool::Save( RTCheckpoint C )
+//  void TIdPool::Load( RTCheckpoint C )
+//
+//  Write / read the pool on / from a checkpoint, so that identifiers are
+//  given in the same order after a restart.
+//
+
+void TIdPool::Save( RTCheckpoint C )
+{
+   C.PutIndex( Next );
+   C.PutIndex( nFree );
+   C.Put( Free, nFree * sizeof(TIndex) );
+}
+
+
+void TIdPool::Load( RTCheckpoint C )
+{
+   Next = C.GetIndex();
+   nFree = C.GetIndex();
+   check( (Next < 0 || nFree < 0 || nFree > Next), "TIdPool::Load(), invalid checkpoint" );
+
+   if ( nFree > MaxFree )
+   {
+      if ( Free != NULL ) delete[] Free;
+      MaxFree = nFree;
+      Free = new TIndex[ MaxFree ];
+      check( (Free == NULL), "TIdPool::Load(), insufficient memory" );
+   }
+   C.Get( Free, nFree * sizeof(TIndex) );
+}
 
 // -----------------------------------------------------------------------------
 //
@@ -85,11 +191,22 @@ ostream& operator<< ( ostream& os, RTPoint p )
 
 istream& operator>> ( istream& is, RTPoint p )
 {
+#ifdef COMPACT_COORDS
+  double xi, yi, zi = 0.0;
+  #ifdef TREDIM
+  is >> xi >> yi >> zi;
+  #else
+  is >> xi >> yi;
+  #endif
+  TQuantFrame::Fix( xi, yi, zi );
+  p.x = xi; p.y = yi; p.z = zi;
+#else
   #ifdef TREDIM
   is >> p.x >> p.y >> p.z;
   #else
   is >> p.x >> p.y; p.z=0.0;
   #endif
+#endif
   return(is);
 }
 
@@ -157,23 +274,34 @@ TVertex::TVertex( double xi=0, double yi=0, double zi=0 )
    : TPoint( xi, yi, zi ), EdgeList ()
 {
 	nIncConstr = 0;
+   IncConstr[0] = IncConstr[1] = NULL;
+   MoreConstr = NULL;
    VID = NextVID++;
    VE[0] = VE[1] = NULL;
 #ifdef MT_TRACER
    MTIdx = 0;
 #endif
+#ifdef MT_NATIVE
+   MTIdx = -1;
+#endif
 }
 
 TVertex::TVertex( PTPoint p )
    : TPoint( p->x, p->y, p->z ), EdgeList ()
 {
 	nIncConstr = 0;
+   IncConstr[0] = IncConstr[1] = NULL;
+   MoreConstr = NULL;
    VID = NextVID++;
    VE[0] = VE[1] = NULL;
 #ifdef MT_TRACER
    MTIdx = 0;
+#endif
+#ifdef MT_NATIVE
+   MTIdx = -1;
 #endif
    Error = p->Error;
+   PID = p->PID;
 
    #ifdef DEBUG
      DEBUG << "constructed TVertex( V" << VID << ": " 
@@ -187,11 +315,16 @@ TVertex::TVertex( RTPoint p )
    : TPoint( p ), EdgeList ()
 {
 	nIncConstr = 0;
+   IncConstr[0] = IncConstr[1] = NULL;
+   MoreConstr = NULL;
    VID = NextVID++;
    VE[0] = VE[1] = NULL;
 #ifdef MT_TRACER
    MTIdx = 0;
 #endif
+#ifdef MT_NATIVE
+   MTIdx = -1;
+#endif
 }
 
 
@@ -217,6 +350,58 @@ TVertex::~TVertex()
       }
    }
    EdgeList.ClearList();
+   if ( MoreConstr != NULL ) delete MoreConstr;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+//   Incident constraints of class TVertex
+//
+
+void TVertex::AddConstr( PTEdge E )
+{
+   if ( nIncConstr < 2 )
+      IncConstr[nIncConstr] = E;
+   else
+   {
+      if ( MoreConstr == NULL )
+      {
+         MoreConstr = new TBuffer<PTEdge>;
+         check( (MoreConstr == NULL), "TVertex::AddConstr(), insufficient memory" );
+      }
+      MoreConstr->Add( E );
+   }
+   nIncConstr++;
+}
+
+
+void TVertex::ClearConstr()
+{
+   nIncConstr = 0;
+   IncConstr[0] = IncConstr[1] = NULL;
+   if ( MoreConstr != NULL ) MoreConstr->Clear();
+}
+
+
+void TVertex::RemoveConstr( PTEdge E )
+{
+   int i;
+
+   for( i=0; i<nIncConstr; i++ )
+      if ( GetConstr( i ) == E ) break;
+   check( (i >= nIncConstr), "TVertex::RemoveConstr(), constraint not incident in the vertex" );
+
+   // the last constraint takes the place of E
+   nIncConstr--;
+   if ( i < 2 )
+   {
+      IncConstr[i] = GetConstr( nIncConstr );
+      if ( nIncConstr < 2 ) IncConstr[nIncConstr] = NULL;
+   }
+   else
+      (*MoreConstr)[i-2] = GetConstr( nIncConstr );
+   if ( nIncConstr >= 2 ) MoreConstr->Remove( nIncConstr-2 );
 }
  
 
@@ -247,7 +432,8 @@ ostream& operator<< ( ostream& os, RTVertex V )
 TEdge::TEdge( PTVertex v0, PTVertex v1 ) : PointList()
 {
 
-   EID = NextEID++;
+   EID = EIDs.Get();
+   OwnsEID = TRUE;
 
    EV[0] = v0;
    EV[1] = v1;
@@ -263,7 +449,8 @@ TEdge::TEdge( PTVertex v0, PTVertex v1 ) : PointList()
 TEdge::TEdge() : PointList()
 {
 
-   EID = NextEID++;
+   EID = EIDs.Get();
+   OwnsEID = TRUE;
 
    EV[0] = NULL;
    EV[1] = NULL;
@@ -281,6 +468,7 @@ TEdge::TEdge() : PointList()
 // copy constructor //
 TEdge::TEdge(TEdge &e)
 {
+   OwnsEID = FALSE;
    *this = e;
    PointList = TList<PTPoint>(); // 2DO: must be replaced with copy of the list
    // EID = e.EID;
@@ -293,6 +481,27 @@ TEdge::TEdge(TEdge &e)
    // mark = e.MarkValue();
 }
 
+// assignment: the result is a copy of e, with the same EID but not
+// owning it (the identifier owned before, if any, is given back)
+TEdge &TEdge::operator=( const TEdge &e )
+{
+   if ( this != &e )
+   {
+      if ( OwnsEID ) EIDs.Release( EID );
+      Markable::operator=( e );
+      EID = e.EID;
+      OwnsEID = FALSE;
+      EV[0] = e.EV[0];
+      EV[1] = e.EV[1];
+      ET[0] = e.ET[0];
+      ET[1] = e.ET[1];
+      Error = e.Error;
+      ToVertex = e.ToVertex;
+      PointList = e.PointList;
+   }
+   return( *this );
+}
+
 // -----------------------------------------------------------------------------
 //
 //  void TEdge::AddPoint( PTPoint )
@@ -327,6 +536,9 @@ void TEdge::AddPoint( PTPoint PointToAdd )
        PLIter.Restart();
        PointList.AddAfter( PLIter.Current(), PointToAdd );
     }
+
+    for( int t=0; t<2; t++ )
+       if ( ET[t] != NULL && PointToAdd->Error > ET[t]->Error ) ET[t]->Error = PointToAdd->Error;
 }
 
 
@@ -482,6 +694,8 @@ TEdge::~TEdge()
    }
    
    PointList.ClearList();
+
+   if ( OwnsEID ) EIDs.Release( EID );
 }
 
 
@@ -506,6 +720,22 @@ ostream& operator<< ( ostream& os, RTEdge E )
 }
 
 
+// -----------------------------------------------------------------------------
+//
+//   Methods class TSegment.
+//
+
+ostream& operator<< ( ostream& os, RTSegment S )
+{
+   os << "S[ V";
+   if( S.EV[0] != NULL ) os << S.EV[0]->VID; else os << " NULL";
+   os << ", V";
+   if( S.EV[1] != NULL ) os << S.EV[1]->VID; else os << " NULL";
+   os << " ]";
+   return( os );
+}
+
+
 
 
 // -----------------------------------------------------------------------------
@@ -523,7 +753,10 @@ ostream& operator<< ( ostream& os, RTEdge E )
 TTriangle::TTriangle( PTEdge e0, PTEdge e1, PTEdge e2 ) : PointList()
 {
 
-   TID = NextTID++;
+   TID = TIDs.Get();
+#ifdef MT_NATIVE
+   MTIdx = -1;
+#endif
 
    TE[0] = e0;
    TE[1] = e1;
@@ -532,6 +765,10 @@ TTriangle::TTriangle( PTEdge e0, PTEdge e1, PTEdge e2 ) : PointList()
    if (e0 && e1 && e2) CalcCircle();//PAOLA 22 FEB. 2001
 //PAOLA 22 FEB. 2001   CalcCircle();
 
+   // edges may already contain points (e.g., on the border of a
+   // re-triangulated region)
+   Error = CalcError();
+
 }
 
 
@@ -729,6 +966,8 @@ void TTriangle::AddPoint( PTPoint PointToAdd )
        PLIter.Restart();
        PointList.AddAfter( PLIter.Current(), PointToAdd );
     }
+
+    if ( PointToAdd->Error > Error ) Error = PointToAdd->Error;
 }
 
 
@@ -736,28 +975,32 @@ void TTriangle::AddPoint( PTPoint PointToAdd )
 // -----------------------------------------------------------------------------
 //  
 //   double TTriangle::GetError()
+//   double TTriangle::CalcError()
 //  
 //   Return the maximum error among the points in the PointList of this
-//   triangle and of the edges adjacent to it.
+//   triangle and of the edges adjacent to it. GetError() returns the
+//   value maintained in Error, CalcError() computes it from the lists.
 //
 
 double TTriangle::GetError()
 {
-   double errors[4];
-   int i; /* PAOLA */
+   #ifdef ROBUST
+      check( (Error != CalcError()), "TTriangle::GetError(), inconsistent error" );
+   #endif
 
-   for( i=0; i<3; i++ )
-     if ( TE[i]->PointList.IsEmpty() ) 
-       errors[i] = 0.0;
-     else
-       errors[i] = TE[i]->PointList.GetHead()->Error;
+   return( Error );
+}
+
+
+double TTriangle::CalcError()
+{
+   double error = ( PointList.IsEmpty() ? 0.0 : PointList.GetHead()->Error );
+   int i; /* PAOLA */
 
-   if ( PointList.IsEmpty() ) errors[3] = 0.0 ;
-    else errors[3] = PointList.GetHead()->Error;
-    
-   double error = errors[3];
    for( i=0; i<3; i++ )
-      if ( errors[i] > error ) error = errors[i];
+     if ( TE[i] != NULL && ! TE[i]->PointList.IsEmpty() 
+          && TE[i]->PointList.GetHead()->Error > error )
+       error = TE[i]->PointList.GetHead()->Error;
      
    return( error );
 
@@ -787,6 +1030,8 @@ TTriangle::~TTriangle()
    } 
    
    PointList.ClearList();
+
+   TIDs.Release( TID );
    
 }
 
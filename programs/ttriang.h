@@ -43,10 +43,16 @@ using namespace std;
 
 #include <iostream>
 #include <fstream>
+#include <pthread.h>
+#ifdef COMPACT_COORDS
+#include <math.h>
+#endif
 #include "defs.h"
 #include "error.h"
 #include "markable.h"
 #include "tlist.h"
+#include "tbuffer.h"
+#include "checkpoint.h"
 
 #ifdef MT_TRACER
 #include "fieldmt.h"
@@ -62,6 +68,7 @@ using namespace std;
 class TPoint;
 class TVertex;
 class TEdge;
+class TSegment;
 class TTriangle;
 
 
@@ -82,11 +89,130 @@ typedef class TVertex &RTVertex;
 typedef class TEdge *PTEdge;
 typedef class TEdge &RTEdge;
 
+typedef class TSegment *PTSegment;
+typedef class TSegment &RTSegment;
+
 typedef class TTriangle *PTTriangle;
 typedef class TTriangle &RTTriangle;
 
 
 
+// -----------------------------------------------------------------------------
+//
+//   class TIdPool
+//
+//   Source of identifiers for entities that are created and deleted
+//   many times during the process (edges, triangles). The identifiers of
+//   deleted entities are given again to new ones, so that identifiers
+//   stay below the maximum number of entities present at the same time.
+//   A pool shared by more threads (see SetShared) is locked by a mutex.
+//
+
+class TIdPool
+{
+   private:
+
+      // Next identifier never given so far.
+      TIndex Next;
+
+      // Stack of released identifiers, of capacity MaxFree.
+      TIndex *Free;
+      TIndex nFree, MaxFree;
+
+      // TRUE if Get and Release lock Lock.
+      boolean Shared;
+      pthread_mutex_t Lock;
+
+      void Push( TIndex id );
+
+   public:
+
+      TIdPool() : Next(0), Free(NULL), nFree(0), MaxFree(0), Shared(FALSE)
+        { pthread_mutex_init( &Lock, NULL ); };
+
+      // Return a free identifier.
+      TIndex Get();
+
+      // Give back an identifier that is no longer used.
+      void Release( TIndex id );
+
+      // Set if the pool is used by more threads at the same time.
+      void SetShared( boolean S ) { Shared = S; };
+
+      // Upper bound on the identifiers given so far.
+      TIndex Limit() { return( Next ); };
+
+      // Write / read the state of the pool on / from a checkpoint.
+      void Save( RTCheckpoint C );
+      void Load( RTCheckpoint C );
+};
+
+
+
+#ifdef COMPACT_COORDS
+
+// -----------------------------------------------------------------------------
+//
+//   class TQuantFrame
+//
+//   Origin of the quantization grid of the current tile. It is fixed
+//   by the first point read from the input file; before that the origin
+//   is at (0,0,0).
+//
+
+class TQuantFrame
+{
+   public:
+
+      static double Origin[3];
+      static boolean Fixed;
+
+      // Fix the origin at the grid point nearest to (x,y,z), unless
+      // it has already been fixed.
+      static void Fix( double x, double y, double z );
+};
+
+
+// -----------------------------------------------------------------------------
+//
+//   class TQCoord
+//
+//   One coordinate (AXIS = 0,1,2 for x,y,z) of a point in compact mode,
+//   stored as an integer number of QUANT_STEP from the tile origin.
+//   It converts to and from double, so that code reading or writing
+//   p->x works in both modes; Grid() gives the integer value for exact
+//   computations.
+//
+
+template <int AXIS> class TQCoord
+{
+   private:
+
+      int q;
+
+   public:
+
+      TQCoord() : q(0) {};
+      TQCoord( double v ) { Set( v ); };
+
+      TQCoord &operator=( double v ) { Set( v ); return( *this ); };
+      operator double() const
+        { return( TQuantFrame::Origin[AXIS] + q * QUANT_STEP ); };
+
+      int Grid() const { return( q ); };
+
+      void Set( double v )
+      {
+         double g = floor( ( v - TQuantFrame::Origin[AXIS] ) / QUANT_STEP + 0.5 );
+         check( ( g > QUANT_MAX || g < -QUANT_MAX ),
+                "TQCoord::Set(), coordinate outside the quantization tile" );
+         q = (int)g;
+      };
+};
+
+#endif
+
+
 // -----------------------------------------------------------------------------
 //
 //   class TPoint
@@ -105,10 +231,16 @@ class TPoint
   public:
    
     // Unique identifier of this point.
-    int PID;
+    TIndex PID;
 
     // Point coordinates.
+#ifdef COMPACT_COORDS
+    TQCoord<0> x;
+    TQCoord<1> y;
+    TQCoord<2> z;
+#else
     double x,y,z;
+#endif
     
     // Point error: vertical distance from the triangulation entity
     // in which it lies / it whould lie.
@@ -119,11 +251,24 @@ class TPoint
     // - real error: if the point is not a vertex of the triangulation 
     // - potential error: error that the point would have if it were
     //   inserted / removed as vertex during refinement / decimation.
+#ifdef COMPACT_COORDS
+    float Error;
+#else
     double Error;
+#endif
+
+#ifdef COMPACT_COORDS
+    // Default constructor: the point is placed at the tile origin,
+    // which may not be fixed yet.
+    TPoint() : PID(-1), Error(0.0) {};
 
+    TPoint( double xi, double yi, double zi = 0 )
+      : PID(-1), x(xi), y(yi), z(zi), Error(0.0){};
+#else
     // Default constructor.
     TPoint( double xi=0, double yi=0, double zi = 0 )
       : PID(-1), x(xi), y(yi), z(zi), Error(0.0){};
+#endif
   
 
     // Compare the coordinates of two points and check if they are equal.    
@@ -160,11 +305,27 @@ class TVertex : public TPoint, public Markable
      // Number of constraint edges incident in this vertex.
      int nIncConstr;
 
+     // Constraint edges incident in this vertex: the first two here
+     // (as for a vertex inside a chain of constraints), the others in
+     // MoreConstr, allocated only for vertices shared by more chains.
+     PTEdge IncConstr[2];
+     TBuffer<PTEdge> *MoreConstr;
+
+     // Add / remove a constraint incident in this vertex, updating
+     // nIncConstr.
+     void AddConstr( PTEdge );
+     void RemoveConstr( PTEdge );
+     void ClearConstr();
+
+     // The i-th incident constraint, 0 <= i < nIncConstr.
+     PTEdge GetConstr( int i )
+       { return( i < 2 ? IncConstr[i] : (*MoreConstr)[i-2] ); };
+
      // Next free identifier (static variable).
-     static int NextVID;
+     static TIndex NextVID;
    
      // Unique vertex identifier.
-     int VID;
+     TIndex VID;
    
      // Partial Vertex-Edge relation.
      // For internal vertices, VE[0] and VE[1] are two arbitrary edges 
@@ -183,6 +344,9 @@ class TVertex : public TPoint, public Markable
 #ifdef MT_TRACER
       MT_INDEX MTIdx;
 #endif
+#ifdef MT_NATIVE
+      TIndex MTIdx;    // index in the MT under construction, -1 if none
+#endif
      
      //
      // Constructors
@@ -219,11 +383,14 @@ class TEdge : public Markable
 {
     public:
    
-      // Next free vertex identifier (static variable).      
-      static int NextEID;
+      // Identifiers of edges (static variable).
+      static TIdPool EIDs;
        
-      // Unique identifier of this edge.
-      int EID;
+      // Unique identifier of this edge. A copy of an edge has the
+      // same EID, but does not own it (it does not give it back to
+      // EIDs when destroyed).
+      TIndex EID;
+      boolean OwnsEID;
    
       // Edge-Vertex relation.
       PTVertex EV[2];
@@ -247,6 +414,8 @@ class TEdge : public Markable
 
       TEdge();
 
+      TEdge &operator=( const TEdge & );
+
       // Is this edge on the convex hull?
       boolean OnConvexHull()
       {
@@ -272,7 +441,8 @@ class TEdge : public Markable
       TList<PTPoint> PointList;
 
       
-      // Insert the given point into the PointList of this edge.
+      // Insert the given point into the PointList of this edge, and
+      // update the Error of the triangles adjacent to this edge.
       void AddPoint( PTPoint );
       
 
@@ -288,6 +458,33 @@ class TEdge : public Markable
 
 
 
+// -----------------------------------------------------------------------------
+//
+//   class TSegment
+//
+//   A segment between two vertices, used as a probe by the geometric
+//   queries on edges (e.g., the intersection tests of a CDT). Unlike a
+//   TEdge, it takes no identifier and is not part of the triangulation,
+//   thus it can be freely created on the stack.
+//
+
+class TSegment
+{
+    public:
+
+      // Endpoints, as in TEdge.
+      PTVertex EV[2];
+
+      TSegment( PTVertex v0, PTVertex v1 ) { EV[0] = v0; EV[1] = v1; };
+
+      // Segment with the same endpoints as edge E.
+      TSegment( PTEdge E ) { EV[0] = E->EV[0]; EV[1] = E->EV[1]; };
+
+      friend ostream& operator<< ( ostream&, RTSegment );
+};
+
+
+
 // -----------------------------------------------------------------------------
 //
 //   class TTriangle
@@ -301,11 +498,11 @@ class TTriangle : public Markable
 
    public:
    
-      // Next free identifier (static variable).
-      static int NextTID;
+      // Identifiers of triangles (static variable).
+      static TIdPool TIDs;
 
       // Unique identifier of this triangle.      
-      int TID;
+      TIndex TID;
 
       // Coordinates x, y and radius of the circum-circle of this triangle.
       double InCircleX, InCircleY, InCircleRad;
@@ -320,6 +517,9 @@ class TTriangle : public Markable
 #ifdef MT_TRACER
       MT_INDEX MTIdx;
 #endif
+#ifdef MT_NATIVE
+      TIndex MTIdx;    // index of the live tile in the MT, -1 if none
+#endif
 
       //
       // ConstruCtor
@@ -358,9 +558,23 @@ class TTriangle : public Markable
       // The head of this list contains the point with maximum error.
       TList<PTPoint> PointList;
       
+      // Insert the given point into the PointList of this triangle,
+      // and update Error.
       void AddPoint( PTPoint );
 
+      // Error of this triangle: the maximum error among the points in
+      // the PointList of this triangle and of its three edges.
+      // It is computed when the triangle is created, and kept up to date
+      // by TTriangle::AddPoint() and TEdge::AddPoint(); points only leave
+      // such lists when the triangle is deleted.
+      double Error;
+
+      // Return Error.
       double GetError();
+
+      // Compute the error of this triangle by scanning the heads of
+      // the point lists.
+      double CalcError();
       
       //
       // Destructor
@@ -89,11 +89,11 @@ PTTriangle GC::NewTriangle( PTEdge E0, PTEdge E1, PTEdge E2 )
        NewTriangle->TE[1] = E1;
        NewTriangle->TE[2] = E2;
          
-       NewTriangle->TID = TTriangle::NextTID++;
+       // the recycled triangle keeps its TID
     
        NewTriangle->CalcCircle();
    
-       NewTriangle->Error = 0.0;
+       NewTriangle->Error = NewTriangle->CalcError();
        
        NewTriangle->MarkReset();
        
@@ -160,7 +160,7 @@ PTEdge GC::NewEdge( PTVertex V0, PTVertex V1 )
 	  
        EdgArray[ NextFreeEdg ] = NULL;
 
-       NewEdge->EID = TEdge::NextEID++;
+       // the recycled edge keeps its EID
 
        NewEdge->EV[0] = V0;
        NewEdge->EV[1] = V1;
@@ -32,13 +32,25 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <fstream>
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
 
 #include "defs.h"
+
+#ifdef CHECKPOINT
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#endif
+
 #include "geom.h"
 #include "utils.h" // PAOLA for CheckIsolatedPoint
 #include "tdoublelist.h"
+#include "tbuffer.h"
 #include "ttriang.h"
 #include "ttriangulation.h"
+#include "reorder.h"
 
 
 #define OUTTIME( tm ) ((tm)/60) << " min. / " << ((tm)%60) << " sec. "
@@ -65,6 +77,15 @@ TTriangulation::TTriangulation()
     
     FirstTriangle = NULL;
     nTrg = 0;
+
+    ReorderMode = REORDER_NONE;
+
+    LodWriter = NULL;
+
+    CkpSignature = NULL;
+    CkpTime = 0;
+    CkpChild = 0;
+    PointByPID = NULL;
     
     PLLocation = PL_UNDEFINED;
     PLTriangle = NULL;
@@ -84,14 +105,20 @@ TTriangulation::TTriangulation()
 void TTriangulation::BuildTriangulation( const char *infname, const char *outfname )
 {
    ReadData( infname );
+   StartBudgets();
 
    long starttime = time(NULL);
    long prevtime  = starttime;
    long currtime  = starttime;
 
-   InitialTriangulation();
+   if ( !ResumeCheckpoint( outfname ) )
+   {
+      InitialTriangulation();
+
+      WriteLevels( outfname );
+   }
    
-   int np = iNextPoint;
+   TIndex np = iNextPoint;
    
    cerr << endl;
 
@@ -106,6 +133,11 @@ void TTriangulation::BuildTriangulation( const char *infname, const char *outfna
 	 }
 	 
          UpdateStep();
+
+         WriteLevels( outfname );
+
+         if ( CkpSignature != NULL && currtime - CkpTime >= CHECKPOINT_SECONDS )
+            SaveCheckpoint( outfname );
 	 
 	 np++;
    }
@@ -119,7 +151,16 @@ void TTriangulation::BuildTriangulation( const char *infname, const char *outfna
 
    WriteData( outfname );
 
+   // ...wait for the levels of detail still being written
+   if ( LodWriter != NULL )
+   {
+      delete LodWriter;
+      LodWriter = NULL;
+   }
+
    EndTriangulation();
+
+   EndCheckpoint( outfname );
   
 }
 
@@ -391,7 +432,7 @@ void TTriangulation::DetachTriangle( PTTriangle T )
 void TTriangulation::WriteData( const char *outfname )
 {
 
-    int iv, it, i;
+    TIndex iv, it, i;
 
      #ifdef DEBUG
       DEBUG << "\nTTriangulation::WriteData(" << outfname << ")" << endl;
@@ -402,7 +443,7 @@ void TTriangulation::WriteData( const char *outfname )
     //
     
     // PAOLA: number of really existing vertices
-    int nVrt = 0;
+    TIndex nVrt = 0;
 
     PTVertex *VtxArray;   
     PTTriangle *TrgArray;
@@ -501,7 +542,7 @@ void TTriangulation::WriteData( const char *outfname )
     // The number of non-NULL vertices must be equal to iv.
     // 
     nVrt = iv;
-    {  int new_vid = 0;
+    {  TIndex new_vid = 0;
        for ( iv=0; iv<nPts; iv++ )
        {
          if (VtxArray[iv]) VtxArray[iv]->VID = new_vid++;
@@ -510,6 +551,8 @@ void TTriangulation::WriteData( const char *outfname )
               "TTriangulation::WriteData(), error in vertex number");
     }
 
+    ReorderOutput( VtxArray, nVrt, TrgArray, nTrg );
+
     // PAOLA: now we can simply print the non-NULL vertices.
     // Renumbering of VIDs guarantees that, when we print triangles,
     // vertex indices (which are VIDs) refer existing vertices.
@@ -552,14 +595,16 @@ void TTriangulation::WriteData( const char *outfname )
     cerr << "output " << nTrg << " triangles" << endl;
     
     outFile.close();
+
+    WritePermutation( outfname, VtxArray, nVrt );
     
 }
 
 
 // --------------------------------------------------------------------------------
 //  
-//  void TTriangulation::ConvertData(int *vNum, int *tNum, int *eNum,
-//                                   float **vData, int **tData, int **eData)
+//  void TTriangulation::ConvertData(TIndex *vNum, TIndex *tNum, TIndex *eNum,
+//                                   float **vData, TIndex **tData, TIndex **eData)
 //
 //  Return vertices, triangles, and constraint edges (if present)
 //  in indexed format. Put them in three arrays: vData (vertices),
@@ -569,10 +614,10 @@ void TTriangulation::WriteData( const char *outfname )
 //  If a number is zero, the corresponding array can be null.
 //  Arrays are freed (if not null) and re-allocated inside this function.
 
-void TTriangulation::ConvertData(int *vNum, int *tNum, int *eNum,
-                                 float **vData, int **tData, int **eData)
+void TTriangulation::ConvertData(TIndex *vNum, TIndex *tNum, TIndex *eNum,
+                                 float **vData, TIndex **tData, TIndex **eData)
 {
-    int iv, it, i;
+    TIndex iv, it, i;
 
      #ifdef DEBUG
       DEBUG << "\nTTriangulation::ConvertData(" << outfname << ")" << endl;
@@ -583,7 +628,7 @@ void TTriangulation::ConvertData(int *vNum, int *tNum, int *eNum,
     //
     
     // PAOLA: number or really existing vertices
-    int nVrt = 0;
+    TIndex nVrt = 0;
 
     PTVertex *VtxArray;   
     PTTriangle *TrgArray;
@@ -677,7 +722,7 @@ void TTriangulation::ConvertData(int *vNum, int *tNum, int *eNum,
     // The number of non-NULL vertices must be equal to iv.
     // 
     nVrt = iv;
-    {  int new_vid = 0;
+    {  TIndex new_vid = 0;
        for ( iv=0; iv<nPts; iv++ )
        {
          if (VtxArray[iv]) VtxArray[iv]->VID = new_vid++;
@@ -685,6 +730,8 @@ void TTriangulation::ConvertData(int *vNum, int *tNum, int *eNum,
        check( (new_vid!=nVrt),
               "TTriangulation::WriteData(), error in vertex number");
     }
+
+    ReorderOutput( VtxArray, nVrt, TrgArray, nTrg );
     
     //
     // output data ...first of all allocate memory
@@ -694,7 +741,7 @@ void TTriangulation::ConvertData(int *vNum, int *tNum, int *eNum,
     *tNum = nTrg;
     *eNum = 0;
     *vData = (float*)malloc(3*nVrt*sizeof(float));
-    *tData = (int*)malloc(3*nTrg*sizeof(int));
+    *tData = (TIndex*)malloc(3*nTrg*sizeof(TIndex));
 
     //
     // ...first vertices...
@@ -740,3 +787,851 @@ void TTriangulation::ConvertData(int *vNum, int *tNum, int *eNum,
     }
 
 }
+
+
+// --------------------------------------------------------------------------------
+//  
+//  void TTriangulation::WriteLevels( const char * )
+//
+//  Called after the initial triangulation and after each update step.
+//
+
+void TTriangulation::WriteLevels( const char *outfname )
+{
+    int iLev;
+
+    while ( ( iLev = NextLevel() ) >= 0 )
+       WriteLevel( outfname, iLev );
+}
+
+
+// --------------------------------------------------------------------------------
+//  
+//  void TTriangulation::WriteLevel( const char *, int )
+//
+//  Collect vertices, triangles and constraint edges as WriteData() and
+//  TDecCDT::WriteData() do, so that the level of detail is the same file
+//  that a run terminated at that level would write. The VIDs are made
+//  consecutive and sorted as in the output, copied into the mesh, and
+//  then restored, since the updates still need them.
+//
+
+void TTriangulation::WriteLevel( const char *outfname, int iLev )
+{
+    TIndex iv, it, ie, i;
+
+    TIndex nVrt = 0;
+
+    PTVertex *VtxArray, *OrigVtx;
+    PTTriangle *TrgArray;
+    TBuffer<PTEdge> EdgArray;
+
+    VtxArray = new PTVertex[ nPts ];
+    OrigVtx = new PTVertex[ nPts ];
+    TrgArray = new PTTriangle[ nTrg ];
+
+    check( ( VtxArray == NULL || OrigVtx == NULL || TrgArray == NULL ),
+           "TTriangulation::WriteLevel(), insufficient memory" );
+
+    for( iv=0; iv<nPts; iv++ ) VtxArray[iv] = NULL;
+    for( it=0; it<nTrg; it++ ) TrgArray[it] = NULL;
+
+    TDoubleList<PTTriangle> Triangles;
+
+    check( (FirstTriangle==NULL), "TTriangulation::WriteLevel(), No triangles?");
+
+    Triangles.AddHead( FirstTriangle );
+    FirstTriangle->Mark( VISITED );
+
+    PTVertex v[3];
+
+    PTTriangle NextTrg[3];
+    PTTriangle CurTrg;
+
+    it = 0;
+    iv = 0;
+
+    while( !Triangles.IsEmpty() )
+    {
+       CurTrg = Triangles.RemoveHead();
+
+       TrgArray[it++] = CurTrg;
+
+       CurTrg->GetTV( v[0], v[1], v[2] );
+       CurTrg->GetTT( NextTrg[0], NextTrg[1], NextTrg[2] );
+
+       // ...constraint edges, each one taken once
+       if ( HasConstraints() )
+          for( i=0; i<3; i++ )
+             if ( !CurTrg->TE[i]->Marked( VISITED ) && CurTrg->TE[i]->Marked( CONSTRAINED ) )
+             {
+                EdgArray.Add( CurTrg->TE[i] );
+                CurTrg->TE[i]->Mark( VISITED );
+             }
+
+       for( i=0; i<3; i++ )
+       {
+         if ( VtxArray[v[i]->VID] == NULL )
+         {
+              iv++;
+              VtxArray[v[i]->VID] = v[i];
+         }
+
+         if ( NextTrg[i] != NULL )
+            if (!( NextTrg[i]->Marked( VISITED ) ))
+            {
+                 Triangles.AddTail( NextTrg[i] );
+                 NextTrg[i]->Mark(VISITED);
+            }
+       }
+    }
+
+    check( (it != nTrg), "TTriangulation::WriteLevel(), inconsistency detected");
+
+    //
+    // renumber vertices as WriteData() does, after saving the VIDs
+    //
+
+    for( iv=0; iv<nPts; iv++ ) OrigVtx[iv] = VtxArray[iv];
+
+    nVrt = 0;
+    for( iv=0; iv<nPts; iv++ )
+       if ( VtxArray[iv] ) VtxArray[iv]->VID = nVrt++;
+
+    ReorderOutput( VtxArray, nVrt, TrgArray, nTrg );
+
+    //
+    // copy the mesh
+    //
+
+    char *lodfname = new char[ strlen(outfname) + 16 ];
+    check( (lodfname == NULL), "TTriangulation::WriteLevel(), insufficient memory" );
+    sprintf( lodfname, "%s.lod%d", outfname, iLev );
+
+    PTLodMesh M = new TLodMesh( lodfname, nVrt, nTrg,
+                                HasConstraints() ? EdgArray.Count() : -1,
+                                ReorderMode != REORDER_NONE );
+    check( (M == NULL), "TTriangulation::WriteLevel(), insufficient memory" );
+
+    i = 0;
+    for( iv=0; iv<nPts; iv++ )
+    {
+       PTVertex CV = VtxArray[iv];
+       if ( CV != NULL )
+       {
+          M->Vtx[3*i]   = CV->x;
+          M->Vtx[3*i+1] = CV->y;
+          M->Vtx[3*i+2] = CV->z;
+          if ( M->Prm ) M->Prm[i] = CV->PID;
+          i++;
+       }
+    }
+
+    for( it=0; it<nTrg; it++ )
+    {
+       TrgArray[it]->GetTV( v[0], v[1], v[2] );
+       M->Trg[3*it]   = v[0]->VID;
+       M->Trg[3*it+1] = v[1]->VID;
+       M->Trg[3*it+2] = v[2]->VID;
+       TrgArray[it]->UnMark( VISITED );
+    }
+
+    for( ie=0; ie<EdgArray.Count(); ie++ )
+    {
+       M->Con[2*ie]   = EdgArray[ie]->EV[0]->VID;
+       M->Con[2*ie+1] = EdgArray[ie]->EV[1]->VID;
+       EdgArray[ie]->UnMark( VISITED );
+    }
+
+    //
+    // restore the VIDs
+    //
+
+    for( iv=0; iv<nPts; iv++ )
+       if ( OrigVtx[iv] ) OrigVtx[iv]->VID = iv;
+
+    cerr << "level of detail " << iLev << ": " << nVrt << " vertices, "
+         << nTrg << " triangles on " << lodfname << endl;
+
+    if ( LodWriter == NULL )
+    {
+       LodWriter = new TLodWriter();
+       check( (LodWriter == NULL), "TTriangulation::WriteLevel(), insufficient memory" );
+    }
+    LodWriter->Write( M );
+
+    delete[] lodfname;
+    delete[] VtxArray;
+    delete[] OrigVtx;
+    delete[] TrgArray;
+}
+
+
+// --------------------------------------------------------------------------------
+//  
+//  void TTriangulation::ReorderInput()
+//
+//  Sort array Points along the curve given by ReorderMode, in such a way
+//  that the loops scanning the input points visit them in spatial order.
+//  Readers allocate the point/vertex objects in the same order, so that
+//  the objects themselves are laid out along the curve in memory.
+//
+
+void TTriangulation::ReorderInput()
+{
+    Reorder::SortPoints( Points, nPts, ReorderMode );
+}
+
+
+// --------------------------------------------------------------------------------
+//  
+//  void TTriangulation::ReorderOutput( PTVertex *, TIndex, PTTriangle *, TIndex )
+//
+//  Renumber output vertices along the curve given by ReorderMode and
+//  sort output triangles accordingly. See ttriangulation.h.
+//
+
+void TTriangulation::ReorderOutput( PTVertex *VtxArray, TIndex nVrt,
+                                    PTTriangle *TrgArray, TIndex nTrgs )
+{
+    TIndex iv, jv;
+
+    if ( ReorderMode == REORDER_NONE ) return;
+
+    PTPoint *Aux = new PTPoint[ nVrt ];
+    check( (Aux == NULL), "TTriangulation::ReorderOutput(), insufficient memory" );
+
+    // remove holes from VtxArray
+    jv = 0;
+    for ( iv=0; iv<nPts; iv++ )
+       if ( VtxArray[iv] != NULL ) Aux[jv++] = VtxArray[iv];
+    check( (jv != nVrt), "TTriangulation::ReorderOutput(), error in vertex number" );
+
+    Reorder::SortPoints( Aux, nVrt, ReorderMode );
+
+    for ( iv=0; iv<nPts; iv++ )
+       VtxArray[iv] = ( iv < nVrt ) ? (PTVertex)(Aux[iv]) : NULL;
+    for ( iv=0; iv<nVrt; iv++ )
+       VtxArray[iv]->VID = iv;
+
+    delete[] Aux;
+
+    Reorder::SortTriangles( TrgArray, nTrgs );
+}
+
+
+// --------------------------------------------------------------------------------
+//  
+//  void TTriangulation::WritePermutation( const char *, PTVertex *, TIndex )
+//
+//  Write file "outfname.prm": number of vertices, followed by the index
+//  in the input file (PID) of each output vertex, in output order.
+//  Nothing is written if ReorderMode is REORDER_NONE.
+//
+
+void TTriangulation::WritePermutation( const char *outfname, PTVertex *VtxArray,
+                                       TIndex nVrt )
+{
+    TIndex iv;
+
+    if ( ReorderMode == REORDER_NONE ) return;
+
+    char *prmfname = new char[ strlen(outfname) + 5 ];
+    check( (prmfname == NULL), "TTriangulation::WritePermutation(), insufficient memory" );
+    strcpy( prmfname, outfname );
+    strcat( prmfname, ".prm" );
+
+    ofstream prmFile;
+    prmFile.open( prmfname );
+    check( !prmFile, "TTriangulation::WritePermutation(), cannot open output file" );
+
+    prmFile << nVrt << endl;
+    for ( iv=0; iv<nVrt; iv++ )
+       prmFile << VtxArray[iv]->PID << endl;
+
+    prmFile.close();
+
+    cerr << "output permutation of " << nVrt << " vertices on " << prmfname << endl;
+    delete[] prmfname;
+}
+
+
+// --------------------------------------------------------------------------------
+//
+//  Checkpoints.
+//
+//  A checkpoint is taken between two updates. The process forks, and the
+//  child writes the state on "outfname.ckp" while the parent goes on
+//  with the updates; if fork() fails, the state is written directly.
+//  To resume, the input is read again as usual, and the mesh built by
+//  ReadData() is replaced by the one in the checkpoint. Points are
+//  identified by PID, edges by EID and triangles by TID, so that the
+//  adjacencies, the order of the point lists and the identifiers given
+//  to new entities are the same as in the interrupted run.
+//
+
+static char *CheckpointName( const char *outfname )
+{
+    char *ckpfname = new char[ strlen(outfname) + 5 ];
+    check( (ckpfname == NULL), "CheckpointName(), insufficient memory" );
+    strcpy( ckpfname, outfname );
+    strcat( ckpfname, ".ckp" );
+    return( ckpfname );
+}
+
+
+//
+// Entity of identifier id in Table (of size Size), NULL if id = -1.
+//
+
+template <class T> static T Lookup( T *Table, TIndex Size, TIndex id )
+{
+    if ( id == -1 ) return( NULL );
+    check( (id < 0 || id >= Size || Table[id] == NULL),
+           "TTriangulation::LoadState(), invalid checkpoint file" );
+    return( Table[id] );
+}
+
+
+void TTriangulation::SetCheckpoint( int argc, char **argv )
+{
+#if defined(CHECKPOINT) && !defined(MT_TRACER)
+    // (the state of the external MT library cannot be saved)
+    int i;
+    size_t len = 64;
+    struct stat st;
+
+    // ...a checkpoint of a previous version of the input is not resumed
+    check( (argc < 2 || stat( argv[1], &st ) != 0),
+           "TTriangulation::SetCheckpoint(), cannot access the input file" );
+
+    for( i=0; i<argc; i++ ) len += strlen( argv[i] ) + 1;
+    CkpSignature = new char[ len ];
+    check( (CkpSignature == NULL), "TTriangulation::SetCheckpoint(), insufficient memory" );
+
+    CkpSignature[0] = '\0';
+    for( i=0; i<argc; i++ )
+    {
+       if ( i > 0 ) strcat( CkpSignature, " " );
+       strcat( CkpSignature, argv[i] );
+    }
+    sprintf( CkpSignature + strlen( CkpSignature ), " [%ld bytes, %ld]",
+             (long)st.st_size, (long)st.st_mtime );
+    CkpTime = time( NULL );
+#else
+    (void)argc; (void)argv;
+#endif
+}
+
+
+boolean TTriangulation::ResumeCheckpoint( const char *outfname )
+{
+    if ( CkpSignature == NULL ) return( FALSE );
+
+    char *ckpfname = CheckpointName( outfname );
+    TCheckpoint C;
+    boolean Ok = C.OpenRead( ckpfname );
+
+    // ...temporary files of a previous run that has been killed
+    TCheckpoint::DiscardAll( ckpfname );
+
+    if ( Ok && !( C.MatchString( CHECKPOINT_MAGIC ) && C.GetInt() == sizeof(TIndex) &&
+                  C.MatchString( CkpSignature ) ) )
+    {
+       cerr << "checkpoint " << ckpfname << " written by another command, ignored" << endl;
+       Ok = FALSE;
+    }
+
+    if ( Ok )
+    {
+       cerr << "resuming from checkpoint " << ckpfname << endl;
+
+       ClearMesh();
+       LoadState( C );
+       check( (!C.MatchString( CHECKPOINT_END )),
+              "TTriangulation::ResumeCheckpoint(), invalid checkpoint file" );
+
+       delete[] PointByPID;
+       PointByPID = NULL;
+    }
+
+    C.Close();
+    delete[] ckpfname;
+    return( Ok );
+}
+
+
+void TTriangulation::SaveCheckpoint( const char *outfname )
+{
+#ifdef CHECKPOINT
+    CkpTime = time( NULL );
+
+    if ( !CheckpointDone( outfname, FALSE ) ) return;
+
+    // ...the levels of detail reached so far must be on disk, since the
+    // checkpoint records them as written
+    if ( LodWriter != NULL )
+    {
+       delete LodWriter;
+       LodWriter = NULL;
+    }
+
+    pid_t pid = fork();
+
+    if ( pid > 0 )
+    {
+       CkpChild = pid;
+       return;
+    }
+
+    char *ckpfname = CheckpointName( outfname );
+    TCheckpoint C;
+    boolean Ok = C.OpenWrite( ckpfname );
+
+    if ( Ok )
+    {
+       C.PutString( CHECKPOINT_MAGIC );
+       C.PutInt( sizeof(TIndex) );
+       C.PutString( CkpSignature );
+       SaveState( C );
+       C.PutString( CHECKPOINT_END );
+       Ok = C.Commit();
+    }
+
+    // ...the child leaves without flushing the buffers of the parent
+    if ( pid == 0 ) _exit( Ok ? 0 : 1 );
+
+    if ( !Ok ) cerr << "warning: cannot write checkpoint " << ckpfname << endl;
+    delete[] ckpfname;
+#else
+    (void)outfname;
+#endif
+}
+
+
+boolean TTriangulation::CheckpointDone( const char *outfname, boolean Wait )
+{
+#ifdef CHECKPOINT
+    int status;
+    pid_t pid;
+
+    if ( CkpChild == 0 ) return( TRUE );
+
+    pid = waitpid( (pid_t)CkpChild, &status, Wait ? 0 : WNOHANG );
+    if ( pid == 0 ) return( FALSE );
+
+    if ( pid < 0 || !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 )
+    {
+       cerr << "warning: a checkpoint could not be written" << endl;
+
+       // ...a writer killed by a signal leaves its temporary file
+       char *ckpfname = CheckpointName( outfname );
+       TCheckpoint::Discard( ckpfname, CkpChild );
+       delete[] ckpfname;
+    }
+    CkpChild = 0;
+#else
+    (void)outfname; (void)Wait;
+#endif
+    return( TRUE );
+}
+
+
+void TTriangulation::EndCheckpoint( const char *outfname )
+{
+    if ( CkpSignature == NULL ) return;
+
+    CheckpointDone( outfname, TRUE );
+
+    char *ckpfname = CheckpointName( outfname );
+    remove( ckpfname );
+    TCheckpoint::DiscardAll( ckpfname );
+    delete[] ckpfname;
+}
+
+
+// --------------------------------------------------------------------------------
+//
+//  void TTriangulation::CollectMesh( TBuffer<PTTriangle> &, TBuffer<PTEdge> & )
+//  void TTriangulation::ClearMesh()
+//
+//  Visit the triangulation from FirstTriangle, as WriteData() does.
+//
+
+void TTriangulation::CollectMesh( TBuffer<PTTriangle> &Trgs, TBuffer<PTEdge> &Edgs )
+{
+    TIndex i;
+    int k;
+
+    TDoubleList<PTTriangle> Triangles;
+    PTTriangle CurTrg, NextTrg;
+    PTEdge E;
+
+    if ( FirstTriangle == NULL ) return;
+
+    Triangles.AddHead( FirstTriangle );
+    FirstTriangle->Mark( VISITED );
+
+    while( !Triangles.IsEmpty() )
+    {
+       CurTrg = Triangles.RemoveHead();
+       Trgs.Add( CurTrg );
+
+       for( k=0; k<3; k++ )
+       {
+          E = CurTrg->TE[k];
+          if ( !E->Marked( VISITED ) )
+          {
+             Edgs.Add( E );
+             E->Mark( VISITED );
+          }
+
+          NextTrg = ( E->ET[0] == CurTrg ? E->ET[1] : E->ET[0] );
+          if ( NextTrg != NULL && !NextTrg->Marked( VISITED ) )
+          {
+             Triangles.AddTail( NextTrg );
+             NextTrg->Mark( VISITED );
+          }
+       }
+    }
+
+    for( i=0; i<Trgs.Count(); i++ ) Trgs[i]->UnMark( VISITED );
+    for( i=0; i<Edgs.Count(); i++ ) Edgs[i]->UnMark( VISITED );
+}
+
+
+void TTriangulation::ClearMesh()
+{
+    TIndex i;
+    TBuffer<PTTriangle> Trgs;
+    TBuffer<PTEdge> Edgs;
+
+    CollectMesh( Trgs, Edgs );
+
+    // ...triangles first, their destructor refers to the edges
+    for( i=0; i<Trgs.Count(); i++ ) delete Trgs[i];
+    for( i=0; i<Edgs.Count(); i++ ) delete Edgs[i];
+
+    FirstTriangle = NULL;
+    nTrg = 0;
+}
+
+
+// --------------------------------------------------------------------------------
+//
+//  Points and point lists on a checkpoint.
+//
+
+PTPoint TTriangulation::LoadPoint( RTCheckpoint C )
+{
+    return( Lookup( PointByPID, nPts, C.GetIndex() ) );
+}
+
+
+void TTriangulation::SavePointList( RTCheckpoint C, TList<PTPoint> &L )
+{
+    TListNode<PTPoint> *N;
+    TIndex n = 0;
+
+    for( N = L.GetFirst(); N != NULL; N = N->Succ() ) n++;
+    C.PutIndex( n );
+
+    // the error of points not in array Points (see
+    // TRefErrDelaunay::NextPoint()) is only found here
+    for( N = L.GetFirst(); N != NULL; N = N->Succ() )
+    {
+       SavePoint( C, N->object );
+       C.PutDouble( N->object->Error );
+    }
+}
+
+
+void TTriangulation::LoadPointList( RTCheckpoint C, TList<PTPoint> &L )
+{
+    TIndex i, n = C.GetIndex();
+    PTPoint P;
+
+    for( i=0; i<n; i++ )
+    {
+       P = LoadPoint( C );
+       check( (P == NULL), "TTriangulation::LoadPointList(), invalid checkpoint file" );
+       P->Error = C.GetDouble();
+       L.AddTail( P );
+    }
+}
+
+
+// --------------------------------------------------------------------------------
+//
+//  void TTriangulation::SaveState( RTCheckpoint C )
+//
+//  Write counters and identifier pools, then the points (with the
+//  topology of those that are vertices), the edges and the triangles.
+//
+
+void TTriangulation::SaveState( RTCheckpoint C )
+{
+    TIndex i;
+    int k;
+    boolean Vertices = AllPointsAreVertices();
+    boolean Pending = PendingPointsInArray();
+
+    TBuffer<PTTriangle> Trgs;
+    TBuffer<PTEdge> Edgs;
+
+    CollectMesh( Trgs, Edgs );
+    check( (Trgs.Count() != nTrg), "TTriangulation::SaveState(), inconsistency detected" );
+
+    C.PutIndex( nPts );
+    C.PutIndex( iNextPoint );
+    C.PutIndex( nTrg );
+    C.PutIndex( Edgs.Count() );
+    C.PutIndex( TVertex::NextVID );
+    C.PutIndex( TEdge::EIDs.Limit() );
+    C.PutIndex( TTriangle::TIDs.Limit() );
+
+    for( i=0; i<nPts; i++ )
+    {
+       if ( !Vertices && i >= iNextPoint && !Pending )
+       {
+          // ...the entry may refer to a point already deleted
+          SavePoint( C, NULL );
+          continue;
+       }
+
+       SavePoint( C, Points[i] );
+       C.PutDouble( Points[i]->Error );
+
+       if ( Vertices || i < iNextPoint )
+       {
+          PTVertex V = (PTVertex)Points[i];
+          C.PutIndex( V->VID );
+          C.PutInt( V->MarkValue() );
+          C.PutInt( V->nIncConstr );
+          for( k=0; k<V->nIncConstr; k++ )
+             C.PutIndex( V->GetConstr( k )->EID );
+          for( k=0; k<2; k++ )
+             C.PutIndex( V->VE[k] ? V->VE[k]->EID : -1 );
+#ifdef MT_NATIVE
+          C.PutIndex( V->MTIdx );
+#endif
+       }
+    }
+
+    for( i=0; i<Edgs.Count(); i++ )
+    {
+       PTEdge E = Edgs[i];
+       C.PutIndex( E->EID );
+       for( k=0; k<2; k++ ) SavePoint( C, E->EV[k] );
+       for( k=0; k<2; k++ ) C.PutIndex( E->ET[k] ? E->ET[k]->TID : -1 );
+       C.PutInt( E->MarkValue() );
+       C.PutDouble( E->Error );
+       SavePoint( C, E->ToVertex );
+       SavePointList( C, E->PointList );
+    }
+
+    for( i=0; i<nTrg; i++ )
+    {
+       PTTriangle T = Trgs[i];
+       C.PutIndex( T->TID );
+       for( k=0; k<3; k++ ) C.PutIndex( T->TE[k]->EID );
+       C.PutInt( T->MarkValue() );
+#ifdef MT_NATIVE
+       C.PutIndex( T->MTIdx );
+#endif
+       SavePointList( C, T->PointList );
+       C.PutDouble( T->Error );
+    }
+
+    C.PutIndex( FirstTriangle ? FirstTriangle->TID : -1 );
+
+    TEdge::EIDs.Save( C );
+    TTriangle::TIDs.Save( C );
+}
+
+
+// --------------------------------------------------------------------------------
+//
+//  void TTriangulation::LoadState( RTCheckpoint C )
+//
+//  Called after ReadData() and ClearMesh(): array Points contains the
+//  input points (all of them as vertices in decimation). In refinement,
+//  the points that were vertices are turned into vertices again.
+//  Array PointByPID is left to the derived classes.
+//
+
+void TTriangulation::LoadState( RTCheckpoint C )
+{
+    TIndex i, j, pid, nEdg, NextVID, EidLimit, TidLimit;
+    int k;
+    boolean Vertices = AllPointsAreVertices();
+
+    check( (C.GetIndex() != nPts), "TTriangulation::LoadState(), checkpoint of other data" );
+    iNextPoint = C.GetIndex();
+    nTrg = C.GetIndex();
+    nEdg = C.GetIndex();
+    NextVID = C.GetIndex();
+    EidLimit = C.GetIndex();
+    TidLimit = C.GetIndex();
+    check( (iNextPoint < 0 || iNextPoint > nPts || nTrg < 0 || nEdg < 0 ||
+            EidLimit < nEdg || TidLimit < nTrg),
+           "TTriangulation::LoadState(), invalid checkpoint file" );
+
+    PTPoint *Input = new PTPoint[ nPts ];
+    PointByPID = new PTPoint[ nPts ];
+    TIndex *VE = new TIndex[ 2*nPts ];
+    TBuffer<TIndex> ConstrEID;   // number and EIDs of incident constraints
+    PTEdge *EdgeByEID = new PTEdge[ EidLimit ];
+    PTEdge *Edg = new PTEdge[ nEdg ];
+    TIndex *ET = new TIndex[ 2*nEdg ];
+    PTTriangle *TrgByTID = new PTTriangle[ TidLimit ];
+
+    check( (Input == NULL || PointByPID == NULL || VE == NULL || EdgeByEID == NULL ||
+            Edg == NULL || ET == NULL || TrgByTID == NULL),
+           "TTriangulation::LoadState(), insufficient memory" );
+
+    //
+    // points, in the order of the checkpoint
+    //
+
+    for( i=0; i<nPts; i++ ) Input[i] = NULL;
+    for( i=0; i<nPts; i++ )
+    {
+       pid = Points[i]->PID;
+       check( (pid < 0 || pid >= nPts || Input[pid] != NULL),
+              "TTriangulation::LoadState(), invalid point identifiers" );
+       Input[pid] = PointByPID[pid] = Points[i];
+    }
+
+    for( i=0; i<nPts; i++ )
+    {
+       pid = C.GetIndex();
+       if ( pid == -1 && !Vertices && i >= iNextPoint )
+       {
+          Points[i] = NULL;
+          continue;
+       }
+       check( (pid < 0 || pid >= nPts), "TTriangulation::LoadState(), invalid checkpoint file" );
+
+       if ( Vertices || i < iNextPoint )
+       {
+          PTVertex V = ( Vertices ? (PTVertex)Input[pid] : new TVertex( Input[pid] ) );
+          check( (V == NULL), "TTriangulation::LoadState(), insufficient memory" );
+
+          V->Error = C.GetDouble();
+          V->VID = C.GetIndex();
+          V->MarkReset();
+          V->Mark( C.GetInt() );
+          // incident constraints, in the same order, once edges are read
+          V->ClearConstr();
+          ConstrEID.Add( C.GetInt() );
+          for( k=ConstrEID[ConstrEID.Count()-1]; k>0; k-- )
+             ConstrEID.Add( C.GetIndex() );
+          for( k=0; k<2; k++ ) VE[2*i+k] = C.GetIndex();
+#ifdef MT_NATIVE
+          V->MTIdx = C.GetIndex();
+#endif
+          Points[i] = PointByPID[pid] = V;
+       }
+       else
+       {
+          Points[i] = Input[pid];
+          Points[i]->Error = C.GetDouble();
+       }
+    }
+
+    // the input points that have become vertices are deleted, as in
+    // TBuildDelaunay::NextPoint()
+    if ( !Vertices )
+       for( pid=0; pid<nPts; pid++ )
+          if ( Input[pid] != PointByPID[pid] ) delete Input[pid];
+
+    //
+    // edges and triangles
+    //
+
+    for( i=0; i<EidLimit; i++ ) EdgeByEID[i] = NULL;
+    for( i=0; i<nEdg; i++ )
+    {
+       TIndex eid = C.GetIndex();
+       check( (eid < 0 || eid >= EidLimit || EdgeByEID[eid] != NULL),
+              "TTriangulation::LoadState(), invalid checkpoint file" );
+
+       PTVertex V0 = (PTVertex)LoadPoint( C );
+       PTVertex V1 = (PTVertex)LoadPoint( C );
+       PTEdge E = new TEdge( V0, V1 );
+       check( (E == NULL), "TTriangulation::LoadState(), insufficient memory" );
+
+       E->EID = eid;
+       for( k=0; k<2; k++ ) ET[2*i+k] = C.GetIndex();
+       E->MarkReset();
+       E->Mark( C.GetInt() );
+       E->Error = C.GetDouble();
+       E->ToVertex = (PTVertex)LoadPoint( C );
+       LoadPointList( C, E->PointList );
+
+       EdgeByEID[eid] = Edg[i] = E;
+    }
+
+    for( i=0; i<TidLimit; i++ ) TrgByTID[i] = NULL;
+    for( i=0; i<nTrg; i++ )
+    {
+       TIndex tid = C.GetIndex();
+       check( (tid < 0 || tid >= TidLimit || TrgByTID[tid] != NULL),
+              "TTriangulation::LoadState(), invalid checkpoint file" );
+
+       PTEdge E[3];
+       for( k=0; k<3; k++ ) E[k] = Lookup( EdgeByEID, EidLimit, C.GetIndex() );
+       check( (E[0] == NULL || E[1] == NULL || E[2] == NULL),
+              "TTriangulation::LoadState(), invalid checkpoint file" );
+
+       PTTriangle T = new TTriangle( E[0], E[1], E[2] );
+       check( (T == NULL), "TTriangulation::LoadState(), insufficient memory" );
+
+       T->TID = tid;
+       T->MarkReset();
+       T->Mark( C.GetInt() );
+#ifdef MT_NATIVE
+       T->MTIdx = C.GetIndex();
+#endif
+       LoadPointList( C, T->PointList );
+       T->Error = C.GetDouble();
+
+       TrgByTID[tid] = T;
+    }
+
+    //
+    // relations to entities read later
+    //
+
+    for( i=0; i<nEdg; i++ )
+       for( k=0; k<2; k++ )
+          Edg[i]->ET[k] = Lookup( TrgByTID, TidLimit, ET[2*i+k] );
+
+    for( i=0, j=0; i<nPts; i++ )
+       if ( Vertices || i < iNextPoint )
+       {
+          PTVertex V = (PTVertex)Points[i];
+          for( k=0; k<2; k++ )
+             V->VE[k] = Lookup( EdgeByEID, EidLimit, VE[2*i+k] );
+          for( k=ConstrEID[j++]; k>0; k-- )
+          {
+             PTEdge E = Lookup( EdgeByEID, EidLimit, ConstrEID[j++] );
+             check( (E == NULL), "TTriangulation::LoadState(), invalid checkpoint file" );
+             V->AddConstr( E );
+          }
+       }
+
+    FirstTriangle = Lookup( TrgByTID, TidLimit, C.GetIndex() );
+
+    TVertex::NextVID = NextVID;
+    TEdge::EIDs.Load( C );
+    TTriangle::TIDs.Load( C );
+
+    delete[] Input;
+    delete[] VE;
+    delete[] EdgeByEID;
+    delete[] Edg;
+    delete[] ET;
+    delete[] TrgByTID;
+}
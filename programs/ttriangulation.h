@@ -36,6 +36,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "defs.h"
 #include "ttriang.h"
 #include "stepbystep.h"
+#include "lodwriter.h"
+#include "checkpoint.h"
+#include "tbuffer.h"
 
 // -----------------------------------------------------------------------------
 //
@@ -69,6 +72,18 @@ class TTriangulation
 
      // Main procedure, it performs the loop of uodates to the triangulation.
      virtual void BuildTriangulation( const char *, const char * );
+
+     // Set the space-filling curve (REORDER_NONE, REORDER_MORTON or
+     // REORDER_HILBERT) along which the input points are sorted after
+     // reading, and the output vertices and triangles before writing.
+     void SetReorderMode( int mode ) { ReorderMode = mode; };
+
+     // Write a checkpoint of the updates every CHECKPOINT_SECONDS on
+     // file "outfname.ckp", and resume from such file if it exists and
+     // has been written by the same command line (argc, argv), with an
+     // input file argv[1] of the same size and modification time.
+     // It does nothing unless CHECKPOINT is defined in defs.h.
+     void SetCheckpoint( int argc, char **argv );
      
 
    protected:
@@ -80,7 +95,7 @@ class TTriangulation
      // Array containing the initial indices of the points in array Points.
      // Used during refinement, it stores the correspondence to the
      // initial position of the points in array Points.
-     int *OrderInitial;
+     TIndex *OrderInitial;
       
      // Array of pointers to the input points in the order in which they
      // have been read.
@@ -101,7 +116,7 @@ class TTriangulation
      // Number of input points, and size of array Points.
      // It is not the number of vertices currently present in the
      // triangulation.
-     int nPts;
+     TIndex nPts;
 
 
      // Point to be inserted in the triangulation as a new vertex.
@@ -133,7 +148,7 @@ class TTriangulation
      // In generic and random refinement,  points are inserted in the same
      // order in which they are sorted in array Points; thus, it also
      // denotes the next point to be inserted in the triangulation.
-     int iNextPoint;
+     TIndex iNextPoint;
 
 
      // Entry point to the set of triangles of the triangulation.
@@ -143,7 +158,15 @@ class TTriangulation
      PTTriangle FirstTriangle;
 
      // Number of triangles present in the current triangulation.
-     int nTrg;
+     TIndex nTrg;
+
+     // Curve used for renumbering input and output entities
+     // (see SetReorderMode). By default, REORDER_NONE.
+     int ReorderMode;
+
+     // Writer of the levels of detail, created when the first one
+     // is reached.
+     PTLodWriter LodWriter;
 
      //
      // Functions and variables used in the point location process.
@@ -175,8 +198,109 @@ class TTriangulation
      // It also returns the number of vertices, triangles and constraint edges.
      // Arrays are de-allocated (if not null) and re-allocated inside
      // the function.
-     virtual void ConvertData(int *vNum, int *tNum, int *eNum,
-                              float **vData, int **tData, int **eData);
+     virtual void ConvertData(TIndex *vNum, TIndex *tNum, TIndex *eNum,
+                              float **vData, TIndex **tData, TIndex **eData);
+
+     // Sort array Points along the curve given by ReorderMode.
+     // Called at the end of ReadData().
+     void ReorderInput();
+
+     // Called by WriteData() and ConvertData() after the VIDs of the
+     // nVrt output vertices have been made consecutive. If ReorderMode
+     // is not REORDER_NONE, compact VtxArray (of size nPts) in its
+     // first nVrt positions sorted along the curve, re-assign VIDs in
+     // such order, and sort TrgArray on the VIDs of the triangle vertices.
+     void ReorderOutput( PTVertex *VtxArray, TIndex nVrt,
+                         PTTriangle *TrgArray, TIndex nTrgs );
+
+     // If ReorderMode is not REORDER_NONE, write file "outfname.prm"
+     // containing, for each output vertex, its index in the input file,
+     // so that per-vertex attributes can follow the renumbering.
+     void WritePermutation( const char *outfname, PTVertex *VtxArray, TIndex nVrt );
+
+     //
+     // Levels of detail: intermediate triangulations, written on
+     // files "outfname.lod<i>" in the same format as WriteData().
+     //
+
+     // Return the index of a level of detail reached by the current
+     // triangulation and not returned before, -1 if none.
+     // By default, there are no levels of detail.
+     virtual int NextLevel() { return( -1 ); };
+
+     // Start the clock of the time budget, once the input is read.
+     // By default, there are no budgets.
+     virtual void StartBudgets() {};
+
+     // Return TRUE if the output files contain constraint edges.
+     virtual boolean HasConstraints() { return( FALSE ); };
+
+     // Write all levels of detail reached by the current triangulation.
+     void WriteLevels( const char *outfname );
+
+     // Convert the current triangulation into the iLev-th level of
+     // detail and hand it over to LodWriter. Unlike WriteData(), it
+     // leaves the VIDs of the vertices unchanged.
+     void WriteLevel( const char *outfname, int iLev );
+
+     //
+     // Checkpoints: the state of the triangulation between two updates,
+     // written by a child process so that the updates go on meanwhile.
+     //
+
+     // Command line of the run, followed by the size and modification
+     // time of the input file; NULL if checkpoints are disabled.
+     char *CkpSignature;
+
+     // Time of the last checkpoint, and process writing it (0 if none).
+     long CkpTime;
+     long CkpChild;
+
+     // While LoadState() runs, the points and vertices by PID.
+     PTPoint *PointByPID;
+
+     // If file "outfname.ckp" belongs to this run, load it in place of
+     // InitialTriangulation() and return TRUE.
+     boolean ResumeCheckpoint( const char *outfname );
+
+     // Start writing a checkpoint, unless the previous one is still
+     // being written.
+     void SaveCheckpoint( const char *outfname );
+
+     // Wait for the checkpoint being written, if any; TRUE if there is
+     // none left (with Wait = FALSE, it does not block). If the writer
+     // has failed or has been killed, its temporary file is removed.
+     boolean CheckpointDone( const char *outfname, boolean Wait );
+
+     // Remove the checkpoint at the end of a successful run.
+     void EndCheckpoint( const char *outfname );
+
+     // Write / read the state on / from a checkpoint. Derived classes
+     // add their own status variables after those of the base class.
+     virtual void SaveState( RTCheckpoint C );
+     virtual void LoadState( RTCheckpoint C );
+
+     // Return TRUE if all input points are vertices (decimation), FALSE
+     // if only Points[0..iNextPoint-1] are (refinement).
+     virtual boolean AllPointsAreVertices() { return( FALSE ); };
+
+     // In refinement, return TRUE if Points[iNextPoint..nPts-1] are the
+     // points still to be inserted, FALSE if such entries are not kept
+     // up to date (the pending points are then only in the PointLists).
+     virtual boolean PendingPointsInArray() { return( TRUE ); };
+
+     // Points are referred to by PID, -1 for NULL.
+     void SavePoint( RTCheckpoint C, PTPoint P ) { C.PutIndex( P ? P->PID : -1 ); };
+     PTPoint LoadPoint( RTCheckpoint C );
+     void SavePointList( RTCheckpoint C, TList<PTPoint> &L );
+     void LoadPointList( RTCheckpoint C, TList<PTPoint> &L );
+
+     // Put into Trgs and Edgs all triangles and edges of the triangulation.
+     void CollectMesh( TBuffer<PTTriangle> &Trgs, TBuffer<PTEdge> &Edgs );
+
+     // Delete all triangles and edges (those built by ReadData() before
+     // a checkpoint is loaded).
+     void ClearMesh();
      
      // Preliminary work before starting the updates on the initial
      // triangulation.
@@ -0,0 +1,287 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : updlog.cpp
+//
+//   Implementation of class TUpdateLog (see updlog.h).
+//
+
+#include <stdlib.h>
+
+#include "defs.h"
+#include "error.h"
+#include "updlog.h"
+
+
+TUpdateLog::TUpdateLog()
+{
+   Head = Cur = 0;
+   TileEvOf.Add( 0 );
+   SegEvOf.Add( 0 );
+}
+
+
+void TUpdateLog::SetAt( TBuffer<TIndex> &Buf, TIndex i, TIndex Val )
+{
+   while ( Buf.Count() <= i ) Buf.Add( -1 );
+   Buf[i] = Val;
+}
+
+
+void TUpdateLog::UseVertex( PTVertex V )
+{
+   TIndex pid = V->PID;
+
+   check( (pid < 0), "TUpdateLog::UseVertex(), vertex without PID" );
+   while ( HasCoord.Count() <= pid )
+   {
+      HasCoord.Add( FALSE );
+      Coord.Add( 0.0 );  Coord.Add( 0.0 );  Coord.Add( 0.0 );
+   }
+   if ( HasCoord[pid] ) return;
+   Coord[3*pid]   = V->x;
+   Coord[3*pid+1] = V->y;
+   Coord[3*pid+2] = V->z;
+   HasCoord[pid] = TRUE;
+}
+
+
+void TUpdateLog::AddAlive( TBuffer<TIndex> &Alive, TBuffer<TIndex> &Pos, TIndex k )
+{
+   SetAt( Pos, k, Alive.Count() );
+   Alive.Add( k );
+}
+
+
+void TUpdateLog::RemoveAlive( TBuffer<TIndex> &Alive, TBuffer<TIndex> &Pos, TIndex k )
+{
+   TIndex p = Pos[k];
+
+   // the last alive element takes the place of k
+   Alive.Remove( p );
+   if ( p < Alive.Count() ) Pos[ Alive[p] ] = p;
+   Pos[k] = -1;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//   Recording (only at the last update).
+//
+
+void TUpdateLog::MakeTriangle( PTTriangle T )
+{
+   PTVertex V[3];
+   TIndex k = TileV.Count() / 3;
+   int i;
+
+   check( (Cur != Head), "TUpdateLog::MakeTriangle(), not at the last update" );
+   T->GetTV( V[0], V[1], V[2] );
+   for( i=0; i<3; i++ )
+   {
+      UseVertex( V[i] );
+      TileV.Add( V[i]->PID );
+   }
+   SetAt( TileOfTID, T->TID, k );
+   TileEv.Add( 2*k );
+   AddAlive( AliveTile, TilePos, k );
+}
+
+
+void TUpdateLog::KillTriangle( PTTriangle T )
+{
+   TIndex k;
+
+   check( (Cur != Head), "TUpdateLog::KillTriangle(), not at the last update" );
+   check( (T->TID >= TileOfTID.Count() || TileOfTID[T->TID] < 0),
+          "TUpdateLog::KillTriangle(), triangle not recorded" );
+   k = TileOfTID[T->TID];
+   TileOfTID[T->TID] = -1;
+   TileEv.Add( 2*k+1 );
+   RemoveAlive( AliveTile, TilePos, k );
+}
+
+
+//
+// Temporary copies of an edge share its EID: a constraint is recorded
+// once, and an EID with no recorded constraint is ignored.
+//
+
+void TUpdateLog::MakeConstraint( PTEdge E )
+{
+   TIndex k = SegV.Count() / 2;
+   int i;
+
+   check( (Cur != Head), "TUpdateLog::MakeConstraint(), not at the last update" );
+   if ( E->EID < SegOfEID.Count() && SegOfEID[E->EID] >= 0 ) return;
+   for( i=0; i<2; i++ )
+   {
+      UseVertex( E->EV[i] );
+      SegV.Add( E->EV[i]->PID );
+   }
+   SetAt( SegOfEID, E->EID, k );
+   SegEv.Add( 2*k );
+   AddAlive( AliveSeg, SegPos, k );
+}
+
+
+void TUpdateLog::KillConstraint( PTEdge E )
+{
+   TIndex k;
+
+   check( (Cur != Head), "TUpdateLog::KillConstraint(), not at the last update" );
+   if ( E->EID >= SegOfEID.Count() || SegOfEID[E->EID] < 0 ) return;
+   k = SegOfEID[E->EID];
+   SegOfEID[E->EID] = -1;
+   SegEv.Add( 2*k+1 );
+   RemoveAlive( AliveSeg, SegPos, k );
+}
+
+
+void TUpdateLog::EndUpdate()
+{
+   check( (Cur != Head), "TUpdateLog::EndUpdate(), not at the last update" );
+   TileEvOf.Add( TileEv.Count() );
+   SegEvOf.Add( SegEv.Count() );
+   Head++;
+   Cur++;
+}
+
+
+// ----------------------------------------------------------------------
+//
+//   Navigation. Events of an update are undone in reverse order, since
+//   a tile may be created and killed by the same update.
+//
+
+void TUpdateLog::Redo( TIndex u )
+{
+   TIndex i, e;
+
+   for( i=TileEvOf[u]; i<TileEvOf[u+1]; i++ )
+   {
+      e = TileEv[i];
+      if ( e % 2 ) RemoveAlive( AliveTile, TilePos, e/2 );
+      else AddAlive( AliveTile, TilePos, e/2 );
+   }
+   for( i=SegEvOf[u]; i<SegEvOf[u+1]; i++ )
+   {
+      e = SegEv[i];
+      if ( e % 2 ) RemoveAlive( AliveSeg, SegPos, e/2 );
+      else AddAlive( AliveSeg, SegPos, e/2 );
+   }
+}
+
+
+void TUpdateLog::Undo( TIndex u )
+{
+   TIndex i, e;
+
+   for( i=SegEvOf[u+1]-1; i>=SegEvOf[u]; i-- )
+   {
+      e = SegEv[i];
+      if ( e % 2 ) AddAlive( AliveSeg, SegPos, e/2 );
+      else RemoveAlive( AliveSeg, SegPos, e/2 );
+   }
+   for( i=TileEvOf[u+1]-1; i>=TileEvOf[u]; i-- )
+   {
+      e = TileEv[i];
+      if ( e % 2 ) AddAlive( AliveTile, TilePos, e/2 );
+      else RemoveAlive( AliveTile, TilePos, e/2 );
+   }
+}
+
+
+boolean TUpdateLog::StepBack()
+{
+   if ( Cur <= 1 ) return( FALSE );
+   check( (Cur == Head && TileEv.Count() != TileEvOf[Head]),
+          "TUpdateLog::StepBack(), called within an update" );
+   Cur--;
+   Undo( Cur );
+   return( TRUE );
+}
+
+
+boolean TUpdateLog::StepForward()
+{
+   if ( Cur >= Head ) return( FALSE );
+   Redo( Cur );
+   Cur++;
+   return( TRUE );
+}
+
+
+// ----------------------------------------------------------------------
+//
+//   Conversion of the view into arrays. Vertices are numbered in order
+//   of first appearance in the alive tiles; arrays are allocated with
+//   malloc(), as in TTriangulation::ConvertData().
+//
+
+void TUpdateLog::ConvertData( TIndex *vNum, TIndex *tNum, TIndex *eNum,
+                              float **vData, TIndex **tData, TIndex **eData )
+{
+   TBuffer<TIndex> VtxIdx;    // output index of each PID (-1 if unused)
+   TIndex nv, i, k;
+   int j;
+
+   if (*vData) free(*vData);
+   if (*tData) free(*tData);
+   if (*eData) free(*eData);
+
+   *tNum = AliveTile.Count();
+   *eNum = AliveSeg.Count();
+   *tData = (TIndex*)malloc( (3*(*tNum)+1) * sizeof(TIndex) );
+   *eData = (TIndex*)malloc( (2*(*eNum)+1) * sizeof(TIndex) );
+   check( (*tData == NULL || *eData == NULL), "TUpdateLog::ConvertData(), insufficient memory" );
+
+   while ( VtxIdx.Count() < HasCoord.Count() ) VtxIdx.Add( -1 );
+   nv = 0;
+   for( i=0; i<*tNum; i++ )
+   {
+      k = AliveTile[i];
+      for( j=0; j<3; j++ )
+      {
+         if ( VtxIdx[ TileV[3*k+j] ] < 0 ) VtxIdx[ TileV[3*k+j] ] = nv++;
+         (*tData)[3*i+j] = VtxIdx[ TileV[3*k+j] ];
+      }
+   }
+   for( i=0; i<*eNum; i++ )
+   {
+      k = AliveSeg[i];
+      for( j=0; j<2; j++ )
+         (*eData)[2*i+j] = VtxIdx[ SegV[2*k+j] ];
+   }
+
+   *vNum = nv;
+   *vData = (float*)malloc( (3*nv+1) * sizeof(float) );
+   check( (*vData == NULL), "TUpdateLog::ConvertData(), insufficient memory" );
+   for( i=0; i<VtxIdx.Count(); i++ )
+      if ( VtxIdx[i] >= 0 )
+         for( j=0; j<3; j++ )
+            (*vData)[ 3*VtxIdx[i]+j ] = Coord[3*i+j];
+}
@@ -0,0 +1,150 @@
+/*****************************************************************************
+Delaunay Triangulator and MT constructor, version 1.0, 1999.
+Copyright (C) 1999 DISI - University of Genova, Italy.
+Group of Geometric Modeling and Computer Graphics DISI.
+DISI - University of Genova, Via Dodecaneso 35, 16146 Genova - ITALY.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*****************************************************************************/
+
+
+
+
+// ----------------------------------------------------------------------
+//
+//   file   : updlog.h
+//
+//   Definition of class TUpdateLog, which records the sequence of
+//   updates of a triangulation as compact deltas, so that the
+//   triangulation obtained after any update can be restored by undoing
+//   or redoing single updates (e.g., to move back and forth through
+//   the levels of detail in the step-by-step interface).
+//
+//   The log is fed by class MTTracer, with the same calls that build
+//   the MT: each triangle created or killed, and each constraint created
+//   or killed (CDT only). The end of each update is given by the caller
+//   (class StepByStep), since the removal of a vertex with constraints
+//   in TDecCDT, or the final insertion of constraints in TRefCDT, are
+//   made of several updates of the MT. Triangles and
+//   constraints get a sequential number (tile, segment) when created;
+//   an update is the list of tiles and segments it creates and kills.
+//   Vertices are identified by their PID, which does not change during
+//   the run, and their coordinates are stored once.
+//
+//   The log keeps a view of the triangulation after update Cur (the
+//   tiles and segments that are alive at that point): undoing update
+//   Cur or redoing update Cur+1 costs as much as the update itself.
+//   New updates can only be recorded when the view is at the last
+//   one (Cur = Head), i.e., when it coincides with the triangulation.
+//   The state of the algorithm (point lists, priority queues) is not
+//   in the log, and it is not reverted.
+//
+
+
+#ifndef _UPDLOG_H
+#define _UPDLOG_H
+
+#include "defs.h"
+#include "ttriang.h"
+#include "tbuffer.h"
+
+
+class TUpdateLog;
+
+typedef TUpdateLog *PTUpdateLog;
+
+
+class TUpdateLog
+{
+   private:
+
+      // Coordinates of the vertices (3 per PID), and which of them
+      // have been stored.
+      TBuffer<float> Coord;
+      TBuffer<boolean> HasCoord;
+
+      // Vertices (PIDs) of the tiles and segments.
+      TBuffer<TIndex> TileV;
+      TBuffer<TIndex> SegV;
+
+      // Tile of each alive triangle, by TID, and segment of each alive
+      // constraint, by EID (-1 if none).
+      TBuffer<TIndex> TileOfTID;
+      TBuffer<TIndex> SegOfEID;
+
+      // Events of all updates: 2*tile (2*segment) for a creation,
+      // 2*tile+1 (2*segment+1) for a deletion. The events of update u
+      // are TileEv[ TileEvOf[u] ... TileEvOf[u+1]-1 ], and the same
+      // for segments.
+      TBuffer<TIndex> TileEv;
+      TBuffer<TIndex> SegEv;
+      TBuffer<TIndex> TileEvOf;
+      TBuffer<TIndex> SegEvOf;
+
+      // Alive tiles / segments of the view, and position of each of
+      // them in AliveTile / AliveSeg (-1 if not alive).
+      TBuffer<TIndex> AliveTile;
+      TBuffer<TIndex> AliveSeg;
+      TBuffer<TIndex> TilePos;
+      TBuffer<TIndex> SegPos;
+
+      // Number of recorded updates, and updates applied to the view.
+      TIndex Head, Cur;
+
+      void UseVertex( PTVertex );
+
+      // Create / kill a tile or segment in the view.
+      void AddAlive( TBuffer<TIndex> &, TBuffer<TIndex> &, TIndex );
+      void RemoveAlive( TBuffer<TIndex> &, TBuffer<TIndex> &, TIndex );
+
+      // Apply the events of update u to the view, forwards or backwards.
+      void Redo( TIndex u );
+      void Undo( TIndex u );
+
+      // Set Buf[i] = Val, growing Buf with -1 as necessary.
+      static void SetAt( TBuffer<TIndex> &Buf, TIndex i, TIndex Val );
+
+   public:
+
+      TUpdateLog();
+
+      // Record the creation / deletion of a triangle or constraint,
+      // and the end of an update (the first update is the building of
+      // the initial triangulation).
+      void MakeTriangle( PTTriangle );
+      void KillTriangle( PTTriangle );
+      void MakeConstraint( PTEdge );
+      void KillConstraint( PTEdge );
+      void EndUpdate();
+
+      TIndex Updates() { return( Head ); };
+      TIndex Current() { return( Cur ); };
+
+      // TRUE if the view is at the last recorded update.
+      boolean AtHead() { return( Cur == Head ); };
+
+      // Move the view back / forward by one update; the initial
+      // triangulation cannot be undone. Return FALSE if not possible.
+      boolean StepBack();
+      boolean StepForward();
+
+      // Convert the view into arrays, like TTriangulation::ConvertData():
+      // coordinates of the vertices, triples of vertices of the
+      // triangles, and pairs of vertices of the constraints.
+      void ConvertData( TIndex *vNum, TIndex *tNum, TIndex *eNum,
+                        float **vData, TIndex **tData, TIndex **eData );
+};
+
+#endif // _UPDLOG_H
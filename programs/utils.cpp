@@ -312,6 +312,15 @@ char ParseLetter(int argc, char ** argv, int i, char * allowedletters)
   return c;
 }
 
+// Check if the i-th argument string is one of the allowedletters,
+// without complaining if it is not
+//
+boolean IsLetterArg(int argc, char ** argv, int i, char * allowedletters)
+{
+  return ( i<argc && argv[i][0]!='\0' && argv[i][1]=='\0' &&
+           IsInString(argv[i][0],allowedletters) );
+}
+
 // Show the prompt and ask the user for an integer which must be
 // at least as large as lowerbound
 //
@@ -382,3 +391,34 @@ float ParsePositiveFloat(int argc, char ** argv, int i)
   }
   return v;
 }
+
+// Search the i-th argument string, if present, for the curve used to
+// renumber input and output vertices and triangles
+//
+int ParseReorder(int argc, char ** argv, int i)
+{
+  if (i>=argc) return REORDER_NONE;
+  switch ( ParseLetter(argc, argv, i, "nNmMhH") )
+  {
+     case 'M': case 'm': return REORDER_MORTON;
+     case 'H': case 'h': return REORDER_HILBERT;
+  }
+  return REORDER_NONE;
+}
+
+// Search the argument strings from the i-th one to the last one for
+// the levels of detail
+//
+int ParseLevels(int argc, char ** argv, int i, double * lev, int maxlev)
+{
+  int n = 0;
+  for ( ; i<argc; i++)
+  {
+     if (n>=maxlev)
+     {  cerr << "Bad format string: more than " << maxlev << " levels" << endl;
+        exit(-2);
+     }
+     lev[n++] = ParsePositiveFloat(argc, argv, i);
+  }
+  return n;
+}
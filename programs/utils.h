@@ -96,6 +96,10 @@ extern char AskLetter(char * prompt, char * allowedletters);
 // to the given string of allowedletters
 extern char ParseLetter(int argc, char ** argv, int i, char * allowedletters);
 
+// Return TRUE if the i-th argument string is present and is one of the
+// given allowedletters (for optional arguments)
+extern boolean IsLetterArg(int argc, char ** argv, int i, char * allowedletters);
+
 // Show the prompt and ask the user for an integer which must be
 // at least as large as lowerbound
 extern int AskIntegerAtLeast(char * prompt, int lowerbound);
@@ -110,4 +114,14 @@ extern float AskPositiveFloat(char * prompt);
 // Search the i-th argument string for a positive float
 extern float ParsePositiveFloat(int argc, char ** argv, int i);
 
+// Search the i-th argument string, if present, for the curve used to
+// renumber input and output: n (none), m (Morton), h (Hilbert).
+// Return REORDER_NONE if the argument is missing.
+extern int ParseReorder(int argc, char ** argv, int i);
+
+// Search the argument strings from the i-th one to the last one for
+// at most maxlev positive floats, put them in lev and return their
+// number (0 if there are no such arguments).
+extern int ParseLevels(int argc, char ** argv, int i, double * lev, int maxlev);
+
 #endif // _UTILS_H